@@ -0,0 +1,443 @@
+#include <tspp/bind.h>
+#include <tspp/tspp.h>
+#include <tspp/utils/Docs.h>
+#include <utils/Array.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+using namespace utils;
+using namespace tspp;
+
+/*
+ * Microbenchmarks for the binding layer. Each benchmark is a JavaScript function that performs
+ * some operation n times, n is doubled until a run takes at least MinSampleDurationNs and then
+ * several samples are taken at that count.
+ *
+ * Usage: tspp_bench [--filter <substring>] [--out <file>] [--baseline <file>] [--threshold <percent>]
+ *
+ * Results are written as JSON to stdout or the --out file. When a baseline (the output of a
+ * previous run) is given each result is compared against it, and the exit code is 1 if any
+ * benchmark is slower than the baseline by more than the threshold (10% by default).
+ */
+
+static constexpr u32 SampleCount         = 5;
+static constexpr u64 MinSampleDurationNs = 50 * 1000 * 1000;
+
+struct Vec3 {
+    public:
+        f32 x;
+        f32 y;
+        f32 z;
+};
+
+class Counter {
+    public:
+        Counter() : m_value(0) {}
+        ~Counter() {}
+
+        void noop() {}
+
+        i32 add2(i32 a, i32 b) {
+            m_value += a;
+            return a + b;
+        }
+
+        f64 add8(f64 a, f64 b, f64 c, f64 d, f64 e, f64 f, f64 g, f64 h) {
+            return a + b + c + d + e + f + g + h;
+        }
+
+    private:
+        i64 m_value;
+};
+
+void noop() {}
+
+i32 add2(i32 a, i32 b) {
+    return a + b;
+}
+
+f64 add8(f64 a, f64 b, f64 c, f64 d, f64 e, f64 f, f64 g, f64 h) {
+    return a + b + c + d + e + f + g + h;
+}
+
+Vec3 makeVec3(f32 v) {
+    return {v, v + 1.0f, v + 2.0f};
+}
+
+Array<f32> echoArray(const Array<f32>& values) {
+    return values;
+}
+
+String echoString(const String& value) {
+    return value;
+}
+
+i32 invokeCallback(i32 (*callback)(i32), i32 count) {
+    i32 result = 0;
+    for (i32 i = 0; i < count; i++) {
+        result = callback(result);
+    }
+
+    return result;
+}
+
+void asyncNoop() {}
+
+void bindBenchmarks() {
+    bind::Namespace* ns = new bind::Namespace("bench");
+    bind::Registry::Add(ns);
+
+    bind::ObjectTypeBuilder<Vec3> vec3 = ns->type<Vec3>("Vec3");
+    vec3.prop("x", &Vec3::x);
+    vec3.prop("y", &Vec3::y);
+    vec3.prop("z", &Vec3::z);
+
+    bind::ObjectTypeBuilder<Counter> counter = ns->type<Counter>("Counter");
+    counter.ctor();
+    counter.dtor();
+    counter.method("noop", &Counter::noop);
+    counter.method("add2", &Counter::add2);
+    counter.method("add8", &Counter::add8);
+
+    ns->function("noop", noop);
+    ns->function("add2", add2);
+    ns->function("add8", add8);
+    ns->function("makeVec3", makeVec3);
+    ns->function("echoArray", echoArray);
+    ns->function("echoString", echoString);
+    ns->function("invokeCallback", invokeCallback);
+    describe(ns->function("asyncNoop", asyncNoop)).async();
+}
+
+static const char* BenchmarkSource = R"(
+const b = require("bench");
+globalThis.__benchmarks = {
+    "call.function.args0": (n) => { const f = b.noop; for (let i = 0; i < n; i++) f(); },
+    "call.function.args2": (n) => { const f = b.add2; for (let i = 0; i < n; i++) f(i, 1); },
+    "call.function.args8": (n) => { const f = b.add8; for (let i = 0; i < n; i++) f(i, 1, 2, 3, 4, 5, 6, 7); },
+    "call.method.args0": (n) => {
+        const o = new b.Counter();
+        for (let i = 0; i < n; i++) o.noop();
+        o.destroy();
+    },
+    "call.method.args2": (n) => {
+        const o = new b.Counter();
+        for (let i = 0; i < n; i++) o.add2(i, 1);
+        o.destroy();
+    },
+    "call.method.args8": (n) => {
+        const o = new b.Counter();
+        for (let i = 0; i < n; i++) o.add8(i, 1, 2, 3, 4, 5, 6, 7);
+        o.destroy();
+    },
+    "marshal.struct.return": (n) => { for (let i = 0; i < n; i++) b.makeVec3(i); },
+    "marshal.array.roundTrip": (n) => {
+        const a = [0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15];
+        for (let i = 0; i < n; i++) b.echoArray(a);
+    },
+    "marshal.string.roundTrip": (n) => {
+        const s = "The quick brown fox jumps over the lazy dog";
+        for (let i = 0; i < n; i++) b.echoString(s);
+    },
+    "object.constructDestroy": (n) => { for (let i = 0; i < n; i++) new b.Counter().destroy(); },
+    "callback.create": (n) => { const cb = (x) => x + 1; for (let i = 0; i < n; i++) b.invokeCallback(cb, 1); },
+    "callback.invoke": (n) => { b.invokeCallback((x) => x + 1, n); },
+    "async.roundTrip": async (n) => { for (let i = 0; i < n; i++) await b.asyncNoop(); }
+};
+)";
+
+class BenchLogger : public IWithLogging {
+    public:
+        BenchLogger() : IWithLogging("") {}
+
+    private:
+        // stdout is reserved for results
+        void onWarn(const char* msg) override {
+            if (msg) fprintf(stderr, "%s\n", msg);
+        }
+
+        void onError(const char* msg) override {
+            if (msg) fprintf(stderr, "%s\n", msg);
+        }
+};
+
+struct BenchResult {
+    public:
+        String name;
+        u64 iterations;
+        f64 nsPerOp;
+        f64 minNsPerOp;
+        f64 baselineNsPerOp;
+};
+
+// Runs a benchmark function once, servicing the runtime until the returned promise settles
+static bool runOnce(Runtime& runtime, v8::Local<v8::Function> fn, u64 iterations, f64& outElapsedNs) {
+    v8::Isolate* isolate           = runtime.getIsolate();
+    v8::Local<v8::Context> context = runtime.getContext();
+    v8::TryCatch tryCatch(isolate);
+
+    v8::Local<v8::Value> args[] = {v8::Number::New(isolate, f64(iterations))};
+
+    auto startedAt = std::chrono::steady_clock::now();
+
+    v8::Local<v8::Value> result;
+    if (!fn->Call(context, context->Global(), 1, args).ToLocal(&result)) {
+        v8::String::Utf8Value error(isolate, tryCatch.Exception());
+        fprintf(stderr, "Benchmark threw: %s\n", *error);
+        return false;
+    }
+
+    if (result->IsPromise()) {
+        v8::Local<v8::Promise> promise = result.As<v8::Promise>();
+        while (promise->State() == v8::Promise::kPending) {
+            runtime.service();
+        }
+
+        if (promise->State() == v8::Promise::kRejected) {
+            v8::String::Utf8Value error(isolate, promise->Result());
+            fprintf(stderr, "Benchmark rejected: %s\n", *error);
+            return false;
+        }
+    }
+
+    outElapsedNs = f64(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - startedAt).count()
+    );
+    return true;
+}
+
+static bool runBenchmark(Runtime& runtime, v8::Local<v8::Function> fn, BenchResult& result) {
+    f64 elapsedNs  = 0.0;
+    u64 iterations = 16;
+
+    // Find an iteration count that runs long enough to measure, this also warms up the JIT
+    while (true) {
+        if (!runOnce(runtime, fn, iterations, elapsedNs)) {
+            return false;
+        }
+
+        if (elapsedNs >= f64(MinSampleDurationNs)) {
+            break;
+        }
+
+        iterations *= 2;
+    }
+
+    f64 samples[SampleCount];
+    for (u32 i = 0; i < SampleCount; i++) {
+        if (!runOnce(runtime, fn, iterations, elapsedNs)) {
+            return false;
+        }
+
+        samples[i] = elapsedNs / f64(iterations);
+    }
+
+    std::sort(samples, samples + SampleCount);
+    result.iterations = iterations;
+    result.nsPerOp    = samples[SampleCount / 2];
+    result.minNsPerOp = samples[0];
+    return true;
+}
+
+// Reads the nsPerOp of each benchmark from a previous run's output
+static bool loadBaseline(Runtime& runtime, const char* path, Array<BenchResult>& results) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        fprintf(stderr, "Failed to open baseline '%s'\n", path);
+        return false;
+    }
+
+    std::stringstream contents;
+    contents << file.rdbuf();
+    std::string json = contents.str();
+
+    v8::Isolate* isolate           = runtime.getIsolate();
+    v8::Local<v8::Context> context = runtime.getContext();
+    v8::TryCatch tryCatch(isolate);
+
+    v8::Local<v8::Value> parsed;
+    v8::Local<v8::String> source =
+        v8::String::NewFromUtf8(isolate, json.c_str(), v8::NewStringType::kNormal, int(json.size())).ToLocalChecked();
+    if (!v8::JSON::Parse(context, source).ToLocal(&parsed) || !parsed->IsObject()) {
+        fprintf(stderr, "Failed to parse baseline '%s'\n", path);
+        return false;
+    }
+
+    v8::Local<v8::Value> benchmarks;
+    v8::Local<v8::String> benchmarksKey = v8::String::NewFromUtf8(isolate, "benchmarks").ToLocalChecked();
+    if (!parsed.As<v8::Object>()->Get(context, benchmarksKey).ToLocal(&benchmarks) || !benchmarks->IsArray()) {
+        fprintf(stderr, "Baseline '%s' has no benchmarks\n", path);
+        return false;
+    }
+
+    v8::Local<v8::Array> list = benchmarks.As<v8::Array>();
+    for (u32 i = 0; i < list->Length(); i++) {
+        v8::Local<v8::Value> entry;
+        if (!list->Get(context, i).ToLocal(&entry) || !entry->IsObject()) {
+            continue;
+        }
+
+        v8::Local<v8::Object> entryObj = entry.As<v8::Object>();
+        v8::Local<v8::Value> name;
+        v8::Local<v8::Value> nsPerOp;
+        entryObj->Get(context, v8::String::NewFromUtf8(isolate, "name").ToLocalChecked()).ToLocal(&name);
+        entryObj->Get(context, v8::String::NewFromUtf8(isolate, "nsPerOp").ToLocalChecked()).ToLocal(&nsPerOp);
+        if (name.IsEmpty() || nsPerOp.IsEmpty() || !name->IsString() || !nsPerOp->IsNumber()) {
+            continue;
+        }
+
+        v8::String::Utf8Value nameStr(isolate, name);
+        for (BenchResult& result : results) {
+            if (result.name == *nameStr) {
+                result.baselineNsPerOp = nsPerOp.As<v8::Number>()->Value();
+                break;
+            }
+        }
+    }
+
+    return true;
+}
+
+int main(i32 argc, const char* argv[]) {
+    const char* filter       = nullptr;
+    const char* outPath      = nullptr;
+    const char* baselinePath = nullptr;
+    f64 threshold            = 10.0;
+
+    for (i32 i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            filter = argv[++i];
+        } else if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+            outPath = argv[++i];
+        } else if (strcmp(argv[i], "--baseline") == 0 && i + 1 < argc) {
+            baselinePath = argv[++i];
+        } else if (strcmp(argv[i], "--threshold") == 0 && i + 1 < argc) {
+            threshold = atof(argv[++i]);
+        } else {
+            fprintf(
+                stderr,
+                "Usage: tspp_bench [--filter <substring>] [--out <file>] [--baseline <file>] [--threshold <percent>]\n"
+            );
+            return 2;
+        }
+    }
+
+    bind::Registry::Create();
+
+    i32 exitCode = 0;
+    {
+        BenchLogger logger;
+
+        Runtime runtime;
+        runtime.addLogHandler(&logger);
+
+        if (!runtime.initialize()) {
+            return 1;
+        }
+
+        bindBenchmarks();
+        runtime.commitBindings();
+
+        Array<BenchResult> results;
+
+        {
+            v8::Isolate* isolate = runtime.getIsolate();
+            v8::Isolate::Scope isolateScope(isolate);
+            v8::HandleScope scope(isolate);
+            v8::Local<v8::Context> context = runtime.getContext();
+            v8::Context::Scope contextScope(context);
+
+            runtime.executeString(BenchmarkSource, "bench.js");
+
+            v8::Local<v8::Value> benchmarksVal;
+            v8::Local<v8::String> benchmarksKey = v8::String::NewFromUtf8(isolate, "__benchmarks").ToLocalChecked();
+            if (!context->Global()->Get(context, benchmarksKey).ToLocal(&benchmarksVal) || !benchmarksVal->IsObject()) {
+                fprintf(stderr, "Failed to load benchmarks\n");
+                runtime.shutdown();
+                return 1;
+            }
+
+            v8::Local<v8::Object> benchmarks = benchmarksVal.As<v8::Object>();
+            v8::Local<v8::Array> names       = benchmarks->GetOwnPropertyNames(context).ToLocalChecked();
+
+            for (u32 i = 0; i < names->Length(); i++) {
+                v8::Local<v8::Value> name = names->Get(context, i).ToLocalChecked();
+                v8::String::Utf8Value nameStr(isolate, name);
+                if (filter && !strstr(*nameStr, filter)) {
+                    continue;
+                }
+
+                v8::Local<v8::Value> fn = benchmarks->Get(context, name).ToLocalChecked();
+
+                BenchResult result     = {};
+                result.name            = *nameStr;
+                result.baselineNsPerOp = 0.0;
+
+                fprintf(stderr, "%s...\n", *nameStr);
+                if (!runBenchmark(runtime, fn.As<v8::Function>(), result)) {
+                    exitCode = 1;
+                    continue;
+                }
+
+                results.push(result);
+            }
+
+            if (baselinePath && !loadBaseline(runtime, baselinePath, results)) {
+                exitCode = 1;
+            }
+        }
+
+        std::string json = "{\"benchmarks\":[";
+        for (u32 i = 0; i < results.size(); i++) {
+            const BenchResult& result = results[i];
+
+            json += String::Format(
+                        "%s{\"name\":\"%s\",\"iterations\":%llu,\"nsPerOp\":%.3f,\"minNsPerOp\":%.3f",
+                        i > 0 ? "," : "",
+                        result.name.c_str(),
+                        (unsigned long long)result.iterations,
+                        result.nsPerOp,
+                        result.minNsPerOp
+            ).c_str();
+
+            if (result.baselineNsPerOp > 0.0) {
+                f64 changePercent = (result.nsPerOp / result.baselineNsPerOp - 1.0) * 100.0;
+                bool isRegression = changePercent > threshold;
+                if (isRegression) {
+                    exitCode = 1;
+                }
+
+                json += String::Format(
+                            ",\"baselineNsPerOp\":%.3f,\"changePercent\":%.2f,\"isRegression\":%s",
+                            result.baselineNsPerOp,
+                            changePercent,
+                            isRegression ? "true" : "false"
+                ).c_str();
+            }
+
+            json += "}";
+        }
+
+        json += "]}\n";
+
+        if (outPath) {
+            std::ofstream file(outPath, std::ios::binary);
+            if (!file.is_open()) {
+                fprintf(stderr, "Failed to open '%s' for writing\n", outPath);
+                exitCode = 1;
+            } else {
+                file.write(json.c_str(), json.size());
+            }
+        } else {
+            fwrite(json.c_str(), 1, json.size(), stdout);
+        }
+
+        runtime.shutdown();
+    }
+
+    return exitCode;
+}
@@ -0,0 +1,24 @@
+#pragma once
+#include <tspp/types.h>
+#include <utils/Array.h>
+#include <utils/String.h>
+
+namespace tspp::builtin::compiler_host {
+    /**
+     * @brief Clears the cached file system state gathered during the previous build.
+     * Source text is kept, since it's validated against the modification time and
+     * size of the file whenever it's read.
+     */
+    void beginBuild();
+
+    bool fileExists(const String& path);
+    bool directoryExists(const String& path);
+    String realPath(const String& path);
+    String getCanonicalFileName(const String& path);
+    Array<String> getDirectories(const String& path);
+    String getFileVersion(const String& path);
+    String readFile(const String& path);
+    void writeFile(const String& path, const String& text);
+
+    void init();
+}
@@ -1,6 +1,11 @@
 #pragma once
 #include <tspp/types.h>
 
+#include <memory>
+#include <span>
+
+#include <v8.h>
+
 namespace tspp::builtin::databuffer {
     class DataBuffer {
         public:
@@ -16,5 +21,66 @@ namespace tspp::builtin::databuffer {
             u64 m_size;
     };
 
+    /**
+     * @brief Memory that's shared between the host and scripts without being copied
+     *
+     * Scripts see the buffer as a SharedArrayBuffer. Copies of a SharedDataBuffer refer to
+     * the same memory, which stays alive until the last copy and the last SharedArrayBuffer
+     * referring to it are gone. This means a bound function that receives a SharedDataBuffer
+     * may keep it (or its span) and continue to read and write it from any thread.
+     */
+    class SharedDataBuffer {
+        public:
+            /**
+             * @brief Called when the memory is no longer referenced by the host or any script
+             */
+            using Deleter = v8::BackingStore::DeleterCallback;
+
+            /**
+             * @brief Allocates a new zero-initialized buffer
+             *
+             * @param size The size of the buffer in bytes
+             */
+            SharedDataBuffer(u64 size);
+
+            /**
+             * @brief Wraps memory that's owned by the host
+             *
+             * @param data The memory to share
+             * @param size The size of the memory in bytes
+             * @param deleter Called with data, size and deleterData once the memory is no longer referenced
+             * @param deleterData User data passed to the deleter
+             */
+            SharedDataBuffer(void* data, u64 size, Deleter deleter, void* deleterData);
+
+            /**
+             * @brief Refers to the backing store of an existing SharedArrayBuffer
+             *
+             * @param backingStore The backing store
+             */
+            SharedDataBuffer(const std::shared_ptr<v8::BackingStore>& backingStore);
+
+            SharedDataBuffer(const SharedDataBuffer& other);
+            ~SharedDataBuffer();
+
+            u8* data() const;
+            u64 size() const;
+            std::span<u8> span() const;
+            const std::shared_ptr<v8::BackingStore>& getBackingStore() const;
+
+            /**
+             * @brief Wakes scripts that are waiting on a 32-bit value within this buffer with
+             * HostAtomics.waitAsync. Can be called from any thread.
+             *
+             * @param byteOffset The offset of the value in bytes
+             * @param count The maximum number of waiters to wake
+             * @return The number of waiters that were woken
+             */
+            u32 notify(u64 byteOffset, u32 count = UINT32_MAX) const;
+
+        protected:
+            std::shared_ptr<v8::BackingStore> m_backingStore;
+    };
+
     void init();
 }
\ No newline at end of file
@@ -75,6 +75,30 @@ namespace tspp::builtin::fs {
             FileStatus m_status;
     };
 
+    /**
+     * @brief Recursively walks a directory and returns the paths of the files that match the
+     * given filters. Patterns are matched against paths relative to the root directory and
+     * support '*', '**', '?', '[...]' and '{a,b}'. Patterns that name a directory match
+     * everything beneath it.
+     *
+     * @note When called on the isolate thread, top level subdirectories are walked in parallel
+     * on the runtime's thread pool
+     *
+     * @param root The directory to walk
+     * @param extensions File extensions to include, all files are included if empty
+     * @param include Patterns that files must match, all files are included if empty
+     * @param exclude Patterns that files and directories must not match
+     * @param depth The maximum depth to walk, or a negative number to walk the whole tree
+     * @return The paths of the matching files, prefixed with the root directory
+     */
+    Array<String> walkDirectory(
+        const String& root,
+        const Array<String>& extensions,
+        const Array<String>& include,
+        const Array<String>& exclude,
+        i32 depth
+    );
+
     void init();
 }
 
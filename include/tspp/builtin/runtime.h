@@ -0,0 +1,6 @@
+#pragma once
+#include <tspp/types.h>
+
+namespace tspp::builtin::runtime {
+    void init();
+}
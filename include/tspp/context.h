@@ -0,0 +1,120 @@
+#pragma once
+#include <tspp/types.h>
+#include <utils/Array.h>
+#include <utils/String.h>
+#include <utils/interfaces/IWithLogging.h>
+
+#include <chrono>
+#include <functional>
+#include <v8.h>
+
+namespace tspp {
+    class Runtime;
+    class IScriptSystemModule;
+    class ModuleSystemModule;
+    class ScriptContext;
+
+    /**
+     * @brief The result of measuring the heap usage of a context
+     */
+    struct ContextMemoryUsage {
+        public:
+            /**
+             * @brief The context that was measured, or null for the runtime's main context
+             */
+            ScriptContext* context;
+
+            /**
+             * @brief The size in bytes of the objects on the heap that belong to the context
+             */
+            size_t heapSize;
+    };
+
+    /**
+     * @brief Called with the heap usage of each context, and the size of the objects that
+     * couldn't be attributed to any one context
+     */
+    using ContextMemoryCallback = std::function<void(const Array<ContextMemoryUsage>& usage, size_t unattributedSize)>;
+
+    /**
+     * @brief An additional global scope within a runtime's isolate
+     *
+     * Contexts are much cheaper to create than runtimes since they share the isolate, the
+     * thread pool, the bindings and the constructor templates of bound types with the runtime
+     * that created them. Each context gets its own global object, module registry and timers,
+     * so scripts running in different contexts can't see each other's state.
+     *
+     * Contexts are created with Runtime::createContext and serviced along with the runtime.
+     */
+    class ScriptContext : public IWithLogging {
+        public:
+            /**
+             * @brief Destructor
+             */
+            ~ScriptContext();
+
+            /**
+             * @brief Gets the name of the context
+             */
+            const String& getName() const;
+
+            /**
+             * @brief Gets the runtime this context belongs to
+             */
+            Runtime* getRuntime() const;
+
+            /**
+             * @brief Gets the V8 context
+             */
+            v8::Local<v8::Context> getContext() const;
+
+            /**
+             * @brief Gets the module system of this context
+             */
+            ModuleSystemModule* getModuleSystem() const;
+
+            /**
+             * @brief Executes JavaScript code in this context
+             *
+             * @param code JavaScript code to execute
+             * @param filename Optional filename for source mapping
+             * @return The result of the execution
+             */
+            v8::Local<v8::Value> executeString(const String& code, const String& filename = "<string>");
+
+            /**
+             * @brief Defines a module in this context's module registry
+             *
+             * @param id The module ID
+             * @param dependencies Array of dependency module IDs
+             * @param factory The factory function that creates the module
+             * @return True if definition succeeded
+             */
+            bool defineModule(const String& id, const Array<String>& dependencies, v8::Local<v8::Function> factory);
+
+            /**
+             * @brief Requires a module from this context's module registry
+             *
+             * @param id The module ID to require
+             * @return The module exports
+             */
+            v8::Local<v8::Value> requireModule(const String& id);
+
+        private:
+            friend class Runtime;
+
+            ScriptContext(Runtime* runtime, const String& name);
+
+            bool initialize();
+            void shutdown();
+            void service();
+            bool getNextDeadline(std::chrono::high_resolution_clock::time_point& outDeadline) const;
+
+            Runtime* m_runtime;
+            String m_name;
+            v8::Global<v8::Context> m_context;
+
+            ModuleSystemModule* m_moduleSystem;
+            Array<IScriptSystemModule*> m_modules;
+    };
+}
\ No newline at end of file
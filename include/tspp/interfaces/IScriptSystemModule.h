@@ -2,6 +2,10 @@
 #include <tspp/types.h>
 #include <utils/interfaces/IWithLogging.h>
 
+#include <chrono>
+
+#include <v8.h>
+
 namespace tspp {
     // Forward declarations
     class ScriptSystem;
@@ -49,6 +53,15 @@ namespace tspp {
              */
             virtual void service();
 
+            /**
+             * @brief Gets the next time at which the module needs to be serviced, for runtimes
+             * that are only serviced when there's work to do
+             *
+             * @param outDeadline Set to the deadline if the module has one
+             * @return bool True if the module is waiting on a deadline
+             */
+            virtual bool getNextDeadline(std::chrono::high_resolution_clock::time_point& outDeadline) const;
+
             /**
              * @brief Shuts down the module
              *
@@ -57,6 +70,36 @@ namespace tspp {
              */
             virtual void shutdown();
 
+            /**
+             * @brief Called when an additional context is created in the script system's isolate
+             *
+             * @param context The new context
+             * @param name The name of the context
+             */
+            virtual void onContextCreated(v8::Local<v8::Context> context, const String& name);
+
+            /**
+             * @brief Called before an additional context is destroyed
+             *
+             * @param context The context being destroyed
+             */
+            virtual void onContextDestroyed(v8::Local<v8::Context> context);
+
+            /**
+             * @brief Makes the module operate on a context other than the script system's own.
+             * Must be called before the module is initialized.
+             *
+             * @param context The context to operate on
+             */
+            void setContext(v8::Local<v8::Context> context);
+
+            /**
+             * @brief Gets the context this module operates on
+             *
+             * @return The context set with setContext, or the script system's context if none was set
+             */
+            v8::Local<v8::Context> getContext() const;
+
             /**
              * @brief Gets the script system this module extends
              *
@@ -74,5 +117,6 @@ namespace tspp {
         protected:
             ScriptSystem* m_scriptSystem;
             const char* m_name;
+            v8::Global<v8::Context> m_context;
     };
 }
\ No newline at end of file
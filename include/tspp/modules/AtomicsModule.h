@@ -0,0 +1,78 @@
+#pragma once
+#include <tspp/interfaces/IScriptSystemModule.h>
+
+#include <v8.h>
+
+namespace tspp {
+    /**
+     * @brief Module that provides the global HostAtomics object
+     *
+     * HostAtomics.waitAsync works like Atomics.waitAsync on an Int32Array backed by a
+     * SharedArrayBuffer, except that waiters can also be woken by the host from any thread
+     * with Notify (or SharedDataBuffer::notify). Woken waiters are resolved the next time the
+     * runtime is serviced, so host threads can signal scripts without submitting a job.
+     */
+    class AtomicsModule : public IScriptSystemModule {
+        public:
+            /**
+             * @brief Constructs a new atomics module
+             *
+             * @param scriptSystem The script system this module extends
+             */
+            AtomicsModule(ScriptSystem* scriptSystem);
+
+            /**
+             * @brief Destructor
+             */
+            ~AtomicsModule() override;
+
+            /**
+             * @brief Initializes the atomics module
+             *
+             * Defines the global HostAtomics object.
+             *
+             * @return bool True if initialization succeeded
+             */
+            bool initialize() override;
+
+            /**
+             * @brief Shuts down the atomics module
+             *
+             * Discards any waiters that belong to this runtime, their promises are never settled.
+             */
+            void shutdown() override;
+
+            /**
+             * @brief Resolves the promises of waiters that were woken or timed out
+             */
+            void service() override;
+
+            /**
+             * @brief Gets the time at which the next waiter of this runtime times out
+             */
+            bool getNextDeadline(std::chrono::high_resolution_clock::time_point& outDeadline) const override;
+
+            /**
+             * @brief Wakes scripts in any runtime that are waiting on the 32-bit value at the
+             * specified address. Waiters are woken in the order they started waiting. Can be
+             * called from any thread.
+             *
+             * @param address The address of the value within a SharedArrayBuffer's memory
+             * @param count The maximum number of waiters to wake
+             * @return The number of waiters that were woken
+             */
+            static u32 Notify(void* address, u32 count = UINT32_MAX);
+
+            /**
+             * @brief A pending call to HostAtomics.waitAsync
+             */
+            struct Waiter;
+
+        private:
+
+            static void WaitAsync(const v8::FunctionCallbackInfo<v8::Value>& args);
+            static void NotifyCallback(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+            u32 m_waiterCount;
+    };
+}
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 #include <tspp/interfaces/IScriptSystemModule.h>
 
+#include <unordered_map>
 #include <v8.h>
 
 namespace bind {
@@ -13,6 +14,7 @@ namespace bind {
 namespace tspp {
     class Runtime;
     class SourceFileBuilder;
+    class ModuleSystemModule;
 
     /**
      * @brief Module that provides binding functionality between C++ and JavaScript
@@ -52,12 +54,57 @@ namespace tspp {
 
             /**
              * @brief Commits all bindings to the runtime environment
+             *
+             * Functions, types and values are exposed as lazy properties, their JavaScript
+             * representations are only created when they're first accessed.
              */
             void commitBindings();
 
+            /**
+             * @brief Installs the committed bindings into a context, global symbols are defined
+             * on its global object and namespaces are registered as built-in modules
+             *
+             * @param context The context to install the bindings into
+             * @param moduleSystem The module system of that context
+             */
+            void installBindings(v8::Local<v8::Context> context, ModuleSystemModule* moduleSystem);
+
+            /**
+             * @brief Gets the number of functions, types and values that were committed
+             */
+            u32 getBindingCount() const;
+
+            /**
+             * @brief Gets the number of committed functions, types and values that have
+             * been accessed from JavaScript, and therefore materialized. Bindings are counted once
+             * for each context that they were materialized in.
+             */
+            u32 getMaterializedBindingCount() const;
+
         private:
+            struct LazyBinding {
+                    BindingModule* module;
+                    bind::Namespace* ns;
+                    bind::ISymbol* symbol;
+            };
+
+            static void LazyBindingGetter(v8::Local<v8::Name> property, const v8::PropertyCallbackInfo<v8::Value>& info);
+            void defineLazy(
+                v8::Local<v8::Object>& target,
+                v8::Local<v8::Context>& context,
+                v8::Isolate* isolate,
+                bind::Namespace* ns,
+                bind::ISymbol* symbol,
+                const String& name
+            );
+            v8::Local<v8::Value> materialize(
+                v8::Local<v8::Context> context, bind::Namespace* ns, bind::ISymbol* symbol
+            );
+
             void bindBuiltInTypes();
-            void processGlobalSymbol(SourceFileBuilder& dts, bind::ISymbol* symbol);
+            void processGlobalSymbol(
+                v8::Local<v8::Context> context, ModuleSystemModule* moduleSystem, bind::ISymbol* symbol
+            );
             void defineFunction(
                 v8::Local<v8::Object>& target,
                 v8::Local<v8::Context>& context,
@@ -77,9 +124,15 @@ namespace tspp {
                 bind::Namespace* ns,
                 bind::ValuePointer* value
             );
-            void processNamespace(bind::Namespace* ns);
-            v8::Local<v8::Function> processFunction(bind::Function* function);
-            v8::Local<v8::Value> processDataType(bind::DataType* dataType);
+            void processNamespace(
+                v8::Local<v8::Context> context, ModuleSystemModule* moduleSystem, bind::Namespace* ns
+            );
+            v8::Local<v8::Function> processFunction(v8::Local<v8::Context> context, bind::Function* function);
+            bool isExposedDataType(bind::DataType* dataType);
+            v8::Local<v8::Value> processDataType(v8::Local<v8::Context> context, bind::DataType* dataType);
+            v8::Local<v8::Value> processValue(
+                v8::Local<v8::Context> context, bind::Namespace* ns, bind::ValuePointer* value
+            );
 
             struct ImportModule {
                 public:
@@ -87,6 +140,12 @@ namespace tspp {
                     Array<bind::DataType*> imports;
             };
 
+            u64 hashBindings(bind::Namespace* global);
+            void hashNamespace(u64& hash, bind::Namespace* ns);
+            void hashFunction(u64& hash, bind::Function* function);
+            void hashDataType(u64& hash, bind::DataType* dataType);
+
+            void emitBuiltInDefinitions(SourceFileBuilder& dts, bind::Namespace* global);
             void emitNamespace(SourceFileBuilder& dts, bind::Namespace* ns);
             void eniUseDataType(
                 utils::Array<ImportModule>& importModules, bind::DataType* dataType, bind::Namespace* ns
@@ -101,5 +160,10 @@ namespace tspp {
 
             // Runtime
             Runtime* m_runtime;
+
+            // Lazily materialized bindings
+            Array<LazyBinding*> m_lazyBindings;
+            std::unordered_map<bind::ISymbol*, LazyBinding*> m_lazyBindingMap;
+            u32 m_materializedCount;
     };
 }
\ No newline at end of file
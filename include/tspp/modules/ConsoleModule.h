@@ -43,6 +43,17 @@ namespace tspp {
              */
             void shutdown() override;
 
+            /**
+             * @brief Registers an additional context with the inspector so that its console
+             * messages are captured as well
+             */
+            void onContextCreated(v8::Local<v8::Context> context, const String& name) override;
+
+            /**
+             * @brief Unregisters an additional context from the inspector
+             */
+            void onContextDestroyed(v8::Local<v8::Context> context) override;
+
             // V8InspectorClient implementation
             void runMessageLoopOnPause(int contextGroupId) override;
             void quitMessageLoopOnPause() override;
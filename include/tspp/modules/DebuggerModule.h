@@ -30,7 +30,10 @@ namespace tspp {
             // IScriptSystemModule
             bool initialize() override;
             void shutdown() override;
+            void onContextCreated(v8::Local<v8::Context> context, const String& name) override;
+            void onContextDestroyed(v8::Local<v8::Context> context) override;
             void service() override;
+            bool getNextDeadline(std::chrono::high_resolution_clock::time_point& outDeadline) const override;
 
             // V8InspectorClient -------------------------------------------------
             void runMessageLoopOnPause(i32 contextGroupId) override;
@@ -1,4 +1,5 @@
 #pragma once
+#include <memory>
 #include <unordered_map>
 
 #include <tspp/interfaces/IScriptSystemModule.h>
@@ -7,12 +8,17 @@
 
 namespace tspp {
     class Runtime;
+    class ScriptStream;
 
     /**
      * @brief Module that provides AMD-compliant module system functionality
      *
      * This module implements the Asynchronous Module Definition (AMD) API,
      * providing define() and require() functions for JavaScript modules.
+     *
+     * Modules that haven't been defined when they're required are loaded from
+     * '<module directory>/<id>.js'. When a module loaded this way declares its
+     * dependencies, those are read and parsed on the thread pool ahead of time.
      */
     class ModuleSystemModule : public IScriptSystemModule {
         public:
@@ -80,6 +86,38 @@ namespace tspp {
              */
             String resolveModuleId(const String& id, const String& baseId = "");
 
+            /**
+             * @brief Executes a compiled JavaScript file that contains module definitions
+             *
+             * Any anonymous define() calls made while the file executes are registered
+             * under the specified module ID.
+             *
+             * @param filePath The path to the JavaScript file
+             * @param moduleId The ID to give anonymous modules defined by the file
+             * @return True if the file was read and executed successfully
+             */
+            bool loadModuleFile(const String& filePath, const String& moduleId);
+
+            /**
+             * @brief Executes every JavaScript file in a directory (recursively)
+             *
+             * Anonymous modules are given an ID derived from their path relative to
+             * the directory, without the extension (e.g. 'src/test.js' -> 'src/test').
+             * All files are read and parsed in parallel on the thread pool, and the
+             * directory becomes the module directory.
+             *
+             * @param directory The directory containing the compiled output
+             * @return True if all files were loaded successfully
+             */
+            bool loadModuleDirectory(const String& directory);
+
+            /**
+             * @brief Sets the directory that modules which haven't been defined are loaded from
+             *
+             * @param directory The directory containing the compiled output
+             */
+            void setModuleDirectory(const String& directory);
+
         private:
             // Module registry entry
             struct ModuleEntry {
@@ -112,6 +150,15 @@ namespace tspp {
             // Load a module and its dependencies
             v8::Local<v8::Value> loadModule(const String& id);
 
+            // Start reading and parsing the file for a module that hasn't been defined yet
+            void prefetchModule(const String& id);
+
+            // Load the file for a module that hasn't been defined yet, using the prefetched file if any
+            bool loadModuleFromFile(const String& id);
+
+            // Compile and run a streamed module file
+            bool executeModuleStream(const String& id, const std::shared_ptr<ScriptStream>& stream);
+
             // Create the special module, exports, and require arguments
             void createModuleArgs(
                 const String& id,
@@ -127,6 +174,13 @@ namespace tspp {
             v8::Global<v8::Function> m_defineFunc;
             v8::Global<v8::Function> m_requireFunc;
 
+            // ID given to anonymous modules defined by the file currently being loaded
+            String m_pendingModuleId;
+
+            // File backed modules
+            String m_moduleDirectory;
+            std::unordered_map<String, std::shared_ptr<ScriptStream>> m_prefetched;
+
             // Runtime
             Runtime* m_runtime;
     };
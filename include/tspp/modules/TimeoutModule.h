@@ -46,6 +46,11 @@ namespace tspp {
              */
             void service() override;
 
+            /**
+             * @brief Gets the time at which the next timeout or interval is due
+             */
+            bool getNextDeadline(std::chrono::high_resolution_clock::time_point& outDeadline) const override;
+
             u32 setInterval(
                 v8::Isolate* isolate,
                 const v8::Local<v8::Function>& function,
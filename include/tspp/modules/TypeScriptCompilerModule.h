@@ -2,10 +2,13 @@
 #include <tspp/interfaces/IScriptSystemModule.h>
 #include <utils/String.h>
 
+#include <memory>
+
 #include <v8.h>
 
 namespace tspp {
     class Runtime;
+    class ScriptStream;
 
     /**
      * @brief Module that provides TypeScript compiler functionality
@@ -27,7 +30,8 @@ namespace tspp {
             /**
              * @brief Initializes the TypeScript compiler module
              * 
-             * Loads and executes the TypeScript compiler code.
+             * Starts parsing the TypeScript compiler code on the thread pool, so that
+             * it overlaps with the bindings being committed.
              * 
              * @return True if initialization succeeded
              */
@@ -36,6 +40,8 @@ namespace tspp {
             /**
              * @brief Called after bindings are loaded
              * 
+             * Finishes loading and executes the TypeScript compiler code.
+             * 
              * @return True if initialization succeeded
              */
             bool onAfterBindings() override;
@@ -61,6 +67,16 @@ namespace tspp {
              * @return True if compilation succeeded
              */
             bool compileDirectory(const String& path);
+
+            /**
+             * @brief Transpiles each TypeScript file listed by the tsconfig.json file located
+             * in the specified directory individually, without type checking. Output is written
+             * to the same location that compileDirectory would write it to.
+             * 
+             * @param path The path to the directory to transpile
+             * @return True if transpilation succeeded
+             */
+            bool transpileDirectory(const String& path);
             
             /**
              * @brief Gets the TypeScript compiler version
@@ -72,10 +88,14 @@ namespace tspp {
         private:
             bool loadCompiler();
             bool loadCompilationShims();
+            bool callDirectoryFunction(v8::Global<v8::Function>& func, const String& path);
             
             // Runtime
             Runtime* m_runtime;
             
+            // TypeScript compiler source, parsed on the thread pool
+            std::shared_ptr<ScriptStream> m_compilerStream;
+
             // TypeScript compiler global object
             v8::Global<v8::Object> m_tsCompiler;
 
@@ -83,6 +103,7 @@ namespace tspp {
             v8::Global<v8::Function> m_compileFuncFactory;
             v8::Global<v8::Function> m_compileFile;
             v8::Global<v8::Function> m_compileDirectory;
+            v8::Global<v8::Function> m_transpileDirectory;
 
             // TypeScript compiler version
             String m_version;
@@ -0,0 +1,86 @@
+#pragma once
+#include <tspp/interfaces/IScriptSystemModule.h>
+#include <utils/Array.h>
+
+#include <memory>
+#include <v8.h>
+
+namespace tspp {
+    class Runtime;
+
+    /**
+     * @brief Module that provides the global Worker class
+     *
+     * Each worker runs a module in its own runtime, on its own thread. Messages are passed
+     * between the two with postMessage / onmessage using the structured clone algorithm, and
+     * are delivered whenever the receiving runtime is serviced.
+     *
+     * Within a worker, the global postMessage function sends messages to the parent, the
+     * global onmessage handler receives them and the global close function stops the worker.
+     */
+    class WorkerModule : public IScriptSystemModule {
+        public:
+            /**
+             * @brief Constructs a new worker module
+             *
+             * @param scriptSystem The script system this module extends
+             * @param runtime The runtime that workers will be started from
+             */
+            WorkerModule(ScriptSystem* scriptSystem, Runtime* runtime);
+
+            /**
+             * @brief Destructor
+             */
+            ~WorkerModule() override;
+
+            /**
+             * @brief Initializes the worker module
+             *
+             * Defines the global Worker class.
+             *
+             * @return bool True if initialization succeeded
+             */
+            bool initialize() override;
+
+            /**
+             * @brief Shuts down the worker module
+             *
+             * Terminates all workers that were started from this runtime.
+             */
+            void shutdown() override;
+
+            /**
+             * @brief Delivers messages and errors from workers, and cleans up workers that have stopped
+             */
+            void service() override;
+
+            /**
+             * @brief Gets the number of workers started from this runtime that haven't been cleaned up yet
+             */
+            u32 getWorkerCount() const;
+
+            /**
+             * @brief State shared between a worker's thread and the runtime that started it
+             */
+            struct WorkerState;
+
+        private:
+            struct WorkerHandle {
+                    std::shared_ptr<WorkerState> state;
+                    v8::Global<v8::Object> object;
+            };
+
+            static void Construct(const v8::FunctionCallbackInfo<v8::Value>& args);
+            static void PostMessage(const v8::FunctionCallbackInfo<v8::Value>& args);
+            static void Terminate(const v8::FunctionCallbackInfo<v8::Value>& args);
+            static void RunWorker(WorkerState* state);
+
+            static WorkerHandle* getHandle(const v8::FunctionCallbackInfo<v8::Value>& args);
+            bool removeHandle(WorkerHandle* handle);
+            void terminate(WorkerHandle* handle);
+            void release(WorkerHandle* handle);
+
+            Runtime* m_runtime;
+            Array<WorkerHandle*> m_workers;
+    };
+}
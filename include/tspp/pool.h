@@ -0,0 +1,130 @@
+#pragma once
+#include <tspp/types.h>
+#include <tspp/utils/Thread.h>
+#include <utils/Array.h>
+#include <utils/interfaces/IWithLogging.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+
+namespace tspp {
+    class Runtime;
+
+    /**
+     * @brief Runs several runtimes, each with its own isolate on its own thread
+     *
+     * Work is dispatched to the runtimes as tasks. Each runtime thread executes its
+     * queued tasks and services its runtime (jobs, timers, microtasks) in a loop, so
+     * script work scales across cores as long as it can be split into independent tasks.
+     *
+     * All runtimes share the binding registry and the project output built by the first
+     * runtime. Everything derived from an isolate (constructor templates, callbacks, module
+     * registries) is owned by the runtime it belongs to.
+     */
+    class RuntimePool : public IWithLogging {
+        public:
+            /**
+             * @brief A unit of work, called on the thread of the runtime it was dispatched to
+             * with the runtime's isolate and context entered
+             */
+            using Task = std::function<void(Runtime*)>;
+
+            /**
+             * @brief Constructs a new RuntimePool with the specified configuration
+             *
+             * @param config Configuration options for the pool
+             */
+            RuntimePool(const RuntimePoolConfig& config = RuntimePoolConfig{});
+
+            /**
+             * @brief Destructor
+             */
+            ~RuntimePool();
+
+            /**
+             * @brief Creates and initializes the runtimes
+             *
+             * Runtimes are initialized one at a time since their setup touches the shared
+             * binding registry. Each one commits its bindings and builds the project (if
+             * configured to) before the setup task is called.
+             *
+             * @param setup Optional task that's called on each runtime once it's initialized,
+             * this is where entry modules should be required
+             * @return True if every runtime was initialized
+             */
+            bool initialize(const Task& setup = nullptr);
+
+            /**
+             * @brief Stops the runtime threads and shuts down the runtimes. Tasks that haven't
+             * started yet are discarded.
+             */
+            void shutdown();
+
+            /**
+             * @brief Dispatches a task to a runtime chosen by the configured dispatch mode
+             *
+             * @param task The task to run
+             * @return The index of the runtime that the task was dispatched to
+             */
+            u32 dispatch(const Task& task);
+
+            /**
+             * @brief Dispatches a task to a specific runtime
+             *
+             * @param runtimeIndex The index of the runtime
+             * @param task The task to run
+             */
+            void dispatchTo(u32 runtimeIndex, const Task& task);
+
+            /**
+             * @brief Dispatches a copy of a task to every runtime
+             *
+             * @param task The task to run
+             */
+            void broadcast(const Task& task);
+
+            /**
+             * @brief Gets the number of runtimes in the pool
+             */
+            u32 getRuntimeCount() const;
+
+            /**
+             * @brief Gets the number of tasks that are queued or executing on a runtime
+             *
+             * @param runtimeIndex The index of the runtime
+             */
+            u32 getPendingTaskCount(u32 runtimeIndex) const;
+
+        private:
+            struct Slot {
+                    u32 index;
+                    Runtime* runtime;
+                    Thread thread;
+
+                    std::mutex mutex;
+                    std::condition_variable condition;
+                    Array<Task> tasks;
+                    std::atomic<u32> pendingCount;
+                    bool doStop;
+
+                    // Initialization handshake with the thread that called RuntimePool::initialize
+                    bool isReady;
+                    bool didFail;
+            };
+
+            void run(Slot* slot, const Task& setup);
+            void runTask(Slot* slot, const Task& task);
+
+            // Wakes the slot's thread if it's idle, must be called with the slot's mutex held
+            void wake(Slot* slot);
+            u32 selectRuntime();
+
+            RuntimePoolConfig m_config;
+            Array<Slot*> m_slots;
+            std::atomic<u32> m_nextRuntime;
+            u32 m_threadPoolSize;
+            bool m_initialized;
+    };
+}
@@ -8,9 +8,13 @@
 #include <libplatform/libplatform.h>
 #include <v8.h>
 
+#include <chrono>
+#include <memory>
+
 namespace tspp {
     // Forward declarations
     class IScriptSystemModule;
+    class ScriptStream;
 
     /**
      * @brief Manages the V8 JavaScript engine
@@ -58,6 +62,27 @@ namespace tspp {
              */
             v8::Local<v8::Value> executeString(const String& code, const String& filename = "<string>");
 
+            /**
+             * @brief Executes JavaScript code directly in a specific context
+             *
+             * @param context The context to execute the code in
+             * @param code JavaScript code to execute
+             * @param filename Optional filename for source mapping
+             * @return The result of the execution
+             */
+            v8::Local<v8::Value> executeString(
+                v8::Local<v8::Context> context, const String& code, const String& filename = "<string>"
+            );
+
+            /**
+             * @brief Compiles and executes a script that was streamed on the thread pool, waiting
+             * for the worker to finish parsing it if necessary
+             *
+             * @param stream The script stream, ScriptStream::begin must have been called already
+             * @return The result of the execution
+             */
+            v8::Local<v8::Value> executeStream(const std::shared_ptr<ScriptStream>& stream);
+
             /**
              * @brief Gets the V8 isolate
              *
@@ -77,6 +102,37 @@ namespace tspp {
              */
             void service();
 
+            /**
+             * @brief Runs idle tasks that V8 posted for this isolate, such as incremental
+             * garbage collection steps
+             *
+             * @param idleTimeSeconds The maximum amount of time to spend
+             */
+            void runIdleTasks(f64 idleTimeSeconds);
+
+            /**
+             * @brief Gets the earliest deadline of any module
+             *
+             * @param outDeadline Set to the deadline if any module has one
+             * @return True if any module is waiting on a deadline
+             */
+            bool getNextDeadline(std::chrono::high_resolution_clock::time_point& outDeadline) const;
+
+            /**
+             * @brief Lets modules know that an additional context was created in this isolate
+             *
+             * @param context The new context
+             * @param name The name of the context
+             */
+            void notifyContextCreated(v8::Local<v8::Context> context, const String& name);
+
+            /**
+             * @brief Lets modules know that an additional context is about to be destroyed
+             *
+             * @param context The context being destroyed
+             */
+            void notifyContextDestroyed(v8::Local<v8::Context> context);
+
             /**
              * @brief Shuts down the script system
              */
@@ -85,14 +141,22 @@ namespace tspp {
         private:
             friend class Runtime;
             void onAfterBindings();
+            void reportException(const v8::TryCatch& tryCatch, v8::Local<v8::Context> context, const char* prefix);
+
+            /**
+             * @brief V8 and its platform can only be initialized once per process, they're shared by
+             * every script system and disposed of when the last one shuts down
+             */
+            static bool AcquirePlatform(const ScriptConfig& config);
+            static void ReleasePlatform();
 
             // Configuration
             ScriptConfig m_config;
             bool m_initialized = false;
 
             // V8 components
-            std::unique_ptr<v8::Platform> m_platform;
             v8::Isolate* m_isolate = nullptr;
+            std::shared_ptr<v8::ArrayBuffer::Allocator> m_allocator;
             v8::Global<v8::Context> m_context;
 
             // Modules
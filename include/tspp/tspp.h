@@ -1,17 +1,47 @@
 #pragma once
 #include <tspp/bind.h>
+#include <tspp/context.h>
 #include <tspp/types.h>
+#include <tspp/utils/EventLoopMonitor.h>
+#include <tspp/utils/HeapMonitor.h>
 #include <tspp/utils/Thread.h>
 #include <utils/String.h>
 #include <utils/interfaces/IWithLogging.h>
 
 #include <v8.h>
 
+#include <chrono>
+#include <memory>
+#include <unordered_map>
+
 namespace tspp {
     class ScriptSystem;
+    class ScriptStream;
     class BindingModule;
     class ModuleSystemModule;
     class TypeScriptCompilerModule;
+    class WorkerModule;
+    class Watchdog;
+    class PollHandle;
+    class CpuProfiler;
+    class HeapProfiler;
+    class CallbackRegistry;
+    class HostObjectManager;
+    struct JavaScriptTypeData;
+
+    /**
+     * @brief Snapshot of a runtime's telemetry, see Runtime::getStats
+     */
+    struct RuntimeStats {
+        public:
+            HeapStats heap;
+            GCStats gc;
+
+            // All zero unless RuntimeConfig::eventLoopMonitor.enabled is true
+            EventLoopStats eventLoop;
+
+            ThreadPoolStats threadPool;
+    };
 
     /**
      * @brief Main class for the TypeScript runtime environment
@@ -38,7 +68,8 @@ namespace tspp {
              * @brief Initializes the runtime
              *
              * This sets up V8, loads the TypeScript compiler, and prepares
-             * the execution environment.
+             * the execution environment. Runtimes on different threads are
+             * initialized one at a time.
              *
              * @return True if initialization succeeded
              */
@@ -63,6 +94,48 @@ namespace tspp {
              */
             v8::Local<v8::Context> getContext();
 
+            /**
+             * @brief Gets the runtime that owns an isolate
+             *
+             * @param isolate The isolate, may be null
+             * @return The runtime, or nullptr if the isolate doesn't belong to an initialized runtime
+             */
+            static Runtime* Get(v8::Isolate* isolate);
+
+            /**
+             * @brief Gets this runtime's JavaScript data for a bound object type. Constructor
+             * templates belong to a single isolate, so each runtime keeps its own.
+             *
+             * @param type The bound object type
+             * @return The type's JavaScript data, or nullptr if it hasn't been built yet
+             */
+            JavaScriptTypeData* getTypeData(bind::DataType* type) const;
+
+            /**
+             * @brief Sets this runtime's JavaScript data for a bound object type, the runtime
+             * takes ownership of it
+             *
+             * @param type The bound object type
+             * @param data The type's JavaScript data
+             */
+            void setTypeData(bind::DataType* type, JavaScriptTypeData* data);
+
+            /**
+             * @brief Gets this runtime's object manager for a bound object type. Host objects are
+             * owned by the runtime that created them and are destroyed when it shuts down.
+             *
+             * @param type The bound object type
+             * @param create Whether to create the manager if the runtime hasn't used the type yet
+             * @return The object manager, or nullptr if objects of the type aren't managed
+             */
+            HostObjectManager* getHostObjectManager(bind::DataType* type, bool create = true);
+
+            /**
+             * @brief Gets the registry of the native callbacks that this runtime has created for
+             * JavaScript functions
+             */
+            CallbackRegistry* getCallbackRegistry() const;
+
             /**
              * @brief Gets the runtime configuration
              *
@@ -107,7 +180,33 @@ namespace tspp {
             v8::Local<v8::Value> executeString(const String& code, const String& filename = "<string>");
 
             /**
-             * @brief Commits all bindings to the environment
+             * @brief Executes JavaScript code after parsing it on the thread pool
+             *
+             * The isolate thread is free to service timers and jobs while the code is parsed,
+             * the code is compiled and executed by a later call to service().
+             *
+             * @param code JavaScript code to execute
+             * @param filename Optional filename for source mapping
+             * @return A promise that resolves to the result of the execution, or rejects with
+             * the compilation or execution error
+             */
+            v8::Local<v8::Promise> executeStringAsync(const String& code, const String& filename = "<string>");
+
+            /**
+             * @brief Executes a JavaScript file after reading and parsing it on the thread pool
+             *
+             * The isolate thread is free to service timers and jobs while the file is read and
+             * parsed, the code is compiled and executed by a later call to service().
+             *
+             * @param path The path of the JavaScript file
+             * @return A promise that resolves to the result of the execution, or rejects with
+             * the read, compilation or execution error
+             */
+            v8::Local<v8::Promise> executeFile(const String& path);
+
+            /**
+             * @brief Commits all bindings to the environment. Runtimes on different threads
+             * commit their bindings one at a time.
              */
             void commitBindings();
 
@@ -115,6 +214,9 @@ namespace tspp {
              * @brief Builds the project described by the tsconfig.json file
              * in the project root directory
              *
+             * How the project is built depends on RuntimeConfig::buildMode. Once built,
+             * the output in internal/dist is loaded so its modules can be required.
+             *
              * @return True if building succeeded
              */
             bool buildProject();
@@ -123,6 +225,9 @@ namespace tspp {
              * @brief Builds the project described by the tsconfig.json file
              * in the specified directory
              *
+             * How the project is built depends on RuntimeConfig::buildMode. Once built,
+             * the output in internal/dist is loaded so its modules can be required.
+             *
              * @return True if building succeeded
              */
             bool buildProject(const String& projectRoot);
@@ -150,7 +255,200 @@ namespace tspp {
              */
             bool service();
 
+            /**
+             * @brief Tells V8 that the embedder is idle until the specified time, so that it can
+             * run deferred garbage collection work now rather than when allocation forces it
+             * to, which is usually in the middle of a frame or request
+             *
+             * @param deadline The time at which the embedder needs the thread back
+             */
+            void notifyIdle(std::chrono::high_resolution_clock::time_point deadline);
+
+            /**
+             * @brief Tells V8 how much memory pressure the process is under. Moderate pressure
+             * speeds up incremental collection, critical pressure frees memory as soon as
+             * possible at the cost of long pauses. Can be called from any thread.
+             *
+             * @param level The memory pressure level
+             */
+            void notifyMemoryPressure(v8::MemoryPressureLevel level);
+
+            /**
+             * @brief Starts recording a CPU profile of this runtime's isolate. Must be called on
+             * the runtime's thread.
+             *
+             * @param name The name of the profile, it's written to
+             * <RuntimeConfig::profileOutputDirectory>/<name>.cpuprofile. Names that contain path
+             * separators or that are '.' or '..' are rejected.
+             * @param samplingIntervalUs How often the stack is sampled, in microseconds
+             * @param durationMs If non-zero, the profile is stopped and written by service() after
+             * this long
+             * @return True if the profile was started
+             */
+            bool startCpuProfile(const String& name, u32 samplingIntervalUs = 1000, u32 durationMs = 0);
+
+            /**
+             * @brief Stops recording the current CPU profile and writes it as a .cpuprofile file
+             * that can be loaded into Chrome DevTools. Must be called on the runtime's thread.
+             *
+             * @param outJson Optionally receives the profile's JSON
+             * @return True if the profile was written
+             */
+            bool stopCpuProfile(String* outJson = nullptr);
+
+            /**
+             * @brief Requests a CPU profile, which is started the next time the runtime is serviced.
+             * Can be called from any thread, such as from a signal or admin command handler.
+             *
+             * @param name The name of the profile
+             * @param samplingIntervalUs How often the stack is sampled, in microseconds
+             * @param durationMs How long to record for before the profile is written
+             */
+            void requestCpuProfile(const String& name, u32 samplingIntervalUs = 1000, u32 durationMs = 30000);
+
+            /**
+             * @brief Gets the CPU profiler of this runtime
+             */
+            CpuProfiler* getCpuProfiler() const;
+
+            /**
+             * @brief Takes a heap snapshot of this runtime's isolate and writes it as a .heapsnapshot
+             * file that can be loaded into Chrome DevTools. Must be called on the runtime's thread.
+             *
+             * @param path Path to write the snapshot to, relative to RuntimeConfig::profileOutputDirectory
+             * @return True if the snapshot was written
+             */
+            bool takeHeapSnapshot(const String& path);
+
+            /**
+             * @brief Starts sampling allocations made by this runtime's isolate. Must be called on
+             * the runtime's thread.
+             *
+             * @param samplingIntervalBytes Average number of bytes allocated between samples
+             * @param stackDepth Maximum number of stack frames recorded for each sample
+             * @return True if sampling was started
+             */
+            bool startSamplingHeapProfile(u32 samplingIntervalBytes = 512 * 1024, u32 stackDepth = 16);
+
+            /**
+             * @brief Stops sampling allocations and writes a .heapprofile file that can be loaded
+             * into Chrome DevTools. Must be called on the runtime's thread.
+             *
+             * @param path Path to write the profile to, relative to RuntimeConfig::profileOutputDirectory
+             * @return True if the profile was written
+             */
+            bool stopSamplingHeapProfile(const String& path);
+
+            /**
+             * @brief Gets the heap profiler of this runtime
+             */
+            HeapProfiler* getHeapProfiler() const;
+
+            /**
+             * @brief Gets the handle that becomes ready whenever the runtime has work to do: a job
+             * completed, a timer is due, a worker posted a message, a waiter was notified or the
+             * debugger needs servicing. Embedders with their own event loop can wait on it and
+             * call service() only when it's ready, instead of calling service() at fixed intervals.
+             *
+             * @return The poll handle, or null if RuntimeConfig::enablePollHandle is false
+             */
+            PollHandle* getPollHandle() const;
+
+            /**
+             * @brief Gets the next time at which the runtime needs to be serviced even if nothing
+             * else happens, such as when the next timer is due
+             *
+             * @param outDeadline Set to the deadline if there is one
+             * @return True if there's a deadline
+             */
+            bool getNextDeadline(std::chrono::high_resolution_clock::time_point& outDeadline) const;
+
+            /**
+             * @brief Creates an additional context in this runtime's isolate, with its own global
+             * object, module registry and timers. The bindings are installed into the context, so
+             * commitBindings must have been called already.
+             *
+             * @param name The name of the context, used for logging and debugging
+             * @return The context, or null if it couldn't be created. The runtime owns it until
+             * it's destroyed with destroyContext, or the runtime shuts down.
+             */
+            ScriptContext* createContext(const String& name);
+
+            /**
+             * @brief Destroys a context that was created with createContext
+             *
+             * @param context The context to destroy
+             */
+            void destroyContext(ScriptContext* context);
+
+            /**
+             * @brief Gets the context that wraps a V8 context
+             *
+             * @param context The V8 context
+             * @return The context, or null if it's the main context or belongs to another runtime
+             */
+            ScriptContext* getScriptContext(v8::Local<v8::Context> context) const;
+
+            /**
+             * @brief Measures how much of the heap belongs to each context, including the main one
+             *
+             * The measurement happens during a later garbage collection, the callback is called
+             * from service() once it's done.
+             *
+             * @param callback Called with the results
+             * @return True if the measurement was started
+             */
+            bool measureContextMemory(const ContextMemoryCallback& callback);
+
+            /**
+             * @brief Gets the script system of this runtime
+             */
+            ScriptSystem* getScriptSystem() const;
+
+            /**
+             * @brief Gets the binding module of this runtime
+             */
+            BindingModule* getBindingModule() const;
+
+            /**
+             * @brief Gets the module system of the main context
+             */
+            ModuleSystemModule* getModuleSystem() const;
+
+            /**
+             * @brief Gets the execution watchdog of this runtime
+             *
+             * @return The watchdog, or null if RuntimeConfig::watchdog.budgetMs is 0
+             */
+            Watchdog* getWatchdog() const;
+
+            /**
+             * @brief Gets the event loop monitor of this runtime
+             *
+             * @return The monitor, or null if RuntimeConfig::eventLoopMonitor.enabled is false
+             */
+            EventLoopMonitor* getEventLoopMonitor() const;
+
+            /**
+             * @brief Gets the heap and garbage collection monitor of this runtime
+             */
+            HeapMonitor* getHeapMonitor() const;
+
+            /**
+             * @brief Samples the heap and collects the runtime's telemetry. Must be called on the
+             * runtime's thread.
+             */
+            RuntimeStats getStats();
+
+            /**
+             * @brief Gets the thread pool that this runtime's async calls are run on
+             */
+            ThreadPool* getThreadPool();
+
         private:
+            v8::Local<v8::Promise> executeStreamAsync(const std::shared_ptr<ScriptStream>& stream);
+            void updatePollHandle();
+
             // Configuration
             RuntimeConfig m_config;
             bool m_initialized = false;
@@ -162,8 +460,33 @@ namespace tspp {
             BindingModule* m_bindingModule;
             ModuleSystemModule* m_moduleSystemModule;
             TypeScriptCompilerModule* m_typeScriptCompilerModule;
+            WorkerModule* m_workerModule;
+
+            // Additional contexts
+            Array<ScriptContext*> m_contexts;
+
+            // Execution budget enforcement
+            Watchdog* m_watchdog;
+
+            // Event loop integration
+            PollHandle* m_pollHandle;
+
+            // Profiling
+            CpuProfiler* m_cpuProfiler;
+            HeapProfiler* m_heapProfiler;
+            EventLoopMonitor* m_eventLoopMonitor;
+            HeapMonitor* m_heapMonitor;
 
             // Async
             ThreadPool m_threadPool;
+
+            // Per-isolate data for bound object types
+            std::unordered_map<bind::DataType*, JavaScriptTypeData*> m_typeData;
+
+            // Live host objects, indexed by DataTypeUserData::hostObjectManagerId - 1
+            Array<HostObjectManager*> m_hostObjectManagers;
+
+            // Native callbacks that target functions in this runtime's isolate
+            CallbackRegistry* m_callbackRegistry;
     };
 }
\ No newline at end of file
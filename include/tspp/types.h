@@ -11,6 +11,23 @@ namespace bind {
 namespace tspp {
     using namespace utils;
 
+    /**
+     * @brief Determines which symbol files V8 writes for Linux perf, ignored on other platforms
+     */
+    enum class PerfMode : u8 {
+        /** No symbol files are written (default) */
+        Disabled,
+
+        /** JIT code is listed in /tmp/perf-<pid>.map (--perf-basic-prof) */
+        PerfMap,
+
+        /**
+         * JIT code is also written to jit-<pid>.dump in the working directory (--perf-prof),
+         * which has to be merged with `perf inject --jit` before reporting
+         */
+        JitDump
+    };
+
     /**
      * @brief Configuration options for the script system
      */
@@ -20,6 +37,102 @@ namespace tspp {
             u64 maximumHeapSize = 512 * 1024 * 1024; // 512MB
             u16 debuggerPort    = 9229;              // Default port for the debugger
             bool enableDebugger = false;             // Whether to enable the debugger
+
+            // Symbol files to write for Linux perf. V8's flags are process wide, so this is taken
+            // from whichever script system initializes V8 first.
+            PerfMode perfMode = PerfMode::Disabled;
+    };
+
+    /**
+     * @brief Determines how Runtime::buildProject produces the JavaScript that gets loaded
+     */
+    enum class BuildMode : u8 {
+        /** Type-check and emit the project with the full TypeScript program (default) */
+        Full,
+
+        /** Transpile each file individually with ts.transpileModule, no type checking */
+        TranspileOnly,
+
+        /**
+         * Skip compilation and load the existing output in internal/dist. The TypeScript
+         * compiler is not loaded at all in this mode.
+         */
+        Prebuilt
+    };
+
+    /**
+     * @brief Determines how the execution watchdog measures time spent in script
+     */
+    enum class WatchdogClock : u8 {
+        /** Elapsed real time (default) */
+        WallClock,
+
+        /** CPU time used by the runtime's thread, time spent blocked or preempted doesn't count */
+        ThreadCpu
+    };
+
+    /**
+     * @brief Configuration options for the execution watchdog
+     */
+    struct WatchdogConfig {
+        public:
+            // How long a single entry into script (requiring a module, a timer callback, a job
+            // completion callback, etc.) may run before it's terminated. 0 disables the watchdog
+            u32 budgetMs = 0;
+
+            // How time is measured
+            WatchdogClock clock = WatchdogClock::WallClock;
+
+            // How often the watchdog thread checks the running entry
+            u32 checkIntervalMs = 10;
+
+            // Maximum number of JavaScript stack frames included in the report
+            u32 maxStackFrames = 10;
+    };
+
+    /**
+     * @brief Configuration options for the event loop monitor
+     */
+    struct EventLoopMonitorConfig {
+        public:
+            // Whether to measure event loop lag and detect long tasks
+            bool enabled = false;
+
+            // Entries into script (a module's service function, a timer callback, a job completion
+            // callback, etc.) that run for at least this long are reported as long tasks
+            u32 longTaskThresholdMs = 50;
+
+            // How often the monitor thread checks the running entry
+            u32 checkIntervalMs = 5;
+
+            // Maximum number of long tasks that are kept, older ones are discarded first
+            u32 maxLongTasks = 64;
+
+            // Maximum number of JavaScript stack frames recorded for each long task
+            u32 maxStackFrames = 10;
+    };
+
+    /**
+     * @brief Configuration options for heap and garbage collection telemetry
+     */
+    struct HeapMonitorConfig {
+        public:
+            // How often heap statistics are sampled while servicing the runtime, to track the peak
+            // heap size between calls to Runtime::getStats. 0 disables periodic sampling
+            u32 sampleIntervalMs = 1000;
+
+            // When the heap nears its limit, raise the limit by this percentage instead of running
+            // out of memory. 0 leaves the limit as it is
+            u32 heapLimitGrowthPercent = 0;
+
+            // Maximum number of times the heap limit is raised
+            u32 maxHeapLimitExpansions = 1;
+
+            // Whether to write a heap snapshot to the profile output directory the first time the
+            // heap nears its limit. Taking the snapshot allocates on the heap, so it's only written
+            // when the limit is also being raised (see heapLimitGrowthPercent), and not until V8 has
+            // applied the raised limit
+            bool writeSnapshotNearHeapLimit = false;
     };
 
     /**
@@ -30,8 +143,72 @@ namespace tspp {
             // File system options
             const char* scriptRootDirectory = ".";
 
+            // Build options
+            BuildMode buildMode = BuildMode::Full;
+
             // Script system options
             ScriptConfig scriptConfig;
+
+            // Execution watchdog options
+            WatchdogConfig watchdog;
+
+            // Event loop lag and long task detection options
+            EventLoopMonitorConfig eventLoopMonitor;
+
+            // Heap and garbage collection telemetry options
+            HeapMonitorConfig heapMonitor;
+
+            // Number of threads that run the runtime's background jobs (script streaming, async calls).
+            // 0 creates one per hardware thread
+            u32 threadPoolSize = 0;
+
+            // Whether to create a handle that embedders can wait on with their own event loop
+            // instead of servicing the runtime at fixed intervals (see Runtime::getPollHandle)
+            bool enablePollHandle = false;
+
+            // If non-zero, each call to service() is treated as a frame of this many milliseconds
+            // and whatever time is left after servicing is spent on idle garbage collection tasks
+            u32 idleFrameBudgetMs = 0;
+
+            // Directory that CPU profiles are written to
+            const char* profileOutputDirectory = ".";
+    };
+
+    /**
+     * @brief Determines which runtime in a RuntimePool receives dispatched work
+     */
+    enum class RuntimeDispatchMode : u8 {
+        /** Cycle through the runtimes in order */
+        RoundRobin,
+
+        /** Pick the runtime with the fewest queued or executing tasks (default) */
+        LeastLoaded
+    };
+
+    /**
+     * @brief Configuration options for a RuntimePool
+     */
+    struct RuntimePoolConfig {
+        public:
+            // Configuration for each runtime. Only the first runtime builds the project, the
+            // others load its output as if they were configured with BuildMode::Prebuilt. When
+            // the debugger is enabled each runtime listens on the next port after the previous one.
+            // If threadPoolSize is 0 the hardware threads are divided between the runtimes' pools.
+            RuntimeConfig runtimeConfig;
+
+            // Number of runtimes to create, each on its own thread. 0 creates one per hardware thread
+            u32 runtimeCount = 0;
+
+            // How dispatched work is distributed
+            RuntimeDispatchMode dispatchMode = RuntimeDispatchMode::LeastLoaded;
+
+            // Whether each runtime should build (or load) the project after committing bindings
+            bool buildProject = true;
+
+            // Idle runtime threads sleep on their runtime's poll handle until there's something to do.
+            // If the poll handle can't be created (it isn't supported on every platform) they poll
+            // instead, servicing their runtime again after waiting this long for new work
+            u32 idleWaitMs = 1;
     };
 
 #ifndef TSPP_INCLUDING_WINDOWS_H
@@ -39,12 +216,23 @@ namespace tspp {
     class HostObjectManager;
     class DataTypeDocumentation;
     struct JavaScriptTypeData;
+
+    /**
+     * @brief Measures the native memory owned by a host object, not including the object itself.
+     * The function must not call into V8.
+     */
+    using ExternalSizeFn = u64 (*)(const void* object);
+
     struct DataTypeUserData {
         public:
             const char* typescriptType;
             IDataMarshaller* marshaller;
-            JavaScriptTypeData* javascriptData;
-            HostObjectManager* hostObjectManager;
+
+            /**
+             * @brief Identifies the type's object manager in each runtime, or 0 if objects of this
+             * type aren't managed. See HostObjectManager::Get.
+             */
+            u32 hostObjectManagerId;
 
             /**
              * @brief The element type of the array, if this type is an array.
@@ -52,6 +240,13 @@ namespace tspp {
              */
             bind::DataType* arrayElementType;
             DataTypeDocumentation* documentation;
+
+            /**
+             * @brief Optional function that measures the variable-size resources owned by objects
+             * of this type, so they can be reported to V8 as external memory.
+             * See setExternalSizeOf.
+             */
+            ExternalSizeFn externalSizeOf;
     };
 
     class FunctionDocumentation;
@@ -23,6 +23,7 @@ namespace tspp {
 
             void run() override;
             void afterComplete() override;
+            const char* getName() const override;
 
             void setup(void* selfPtr, const v8::FunctionCallbackInfo<v8::Value>& args);
 
@@ -36,5 +37,10 @@ namespace tspp {
             bool m_hasException;
             String m_exceptionMsg;
             v8::Global<v8::Promise::Resolver> m_resolver;
+
+            // Phase timings for CallStats, only measured if it was enabled when the job was set up
+            bool m_isTimed;
+            u64 m_argumentsNs;
+            u64 m_callNs;
     };
 }
\ No newline at end of file
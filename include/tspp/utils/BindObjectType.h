@@ -13,4 +13,17 @@ namespace tspp {
     );
 
     v8::Local<v8::FunctionTemplate> buildPrototype(v8::Isolate* isolate, bind::DataType* type);
+
+    /**
+     * @brief Gets the JavaScript data for a bound object type in the runtime that owns the
+     * isolate, building its constructor template the first time it's needed.
+     *
+     * @return The type's JavaScript data, or nullptr if the type isn't a bound object type
+     */
+    JavaScriptTypeData* getJavaScriptTypeData(v8::Isolate* isolate, bind::DataType* type);
+
+    /**
+     * @brief Gets the number of bound object types whose constructor template has been built
+     */
+    u32 getMaterializedTypeCount();
 }
\ No newline at end of file
@@ -0,0 +1,100 @@
+#pragma once
+#include <tspp/types.h>
+#include <utils/String.h>
+
+namespace tspp {
+    /**
+     * @brief Per-binding call counters and latency histograms
+     *
+     * When enabled, every call from script into a bound function (and every call from the host
+     * into a script callback) records how long was spent converting the arguments, in the target
+     * and converting the return value. Each thread records into its own counters, so the hot path
+     * takes no locks. Statistics from every thread are merged when they're dumped.
+     *
+     * Disabled by default, the cost of a call while disabled is a single relaxed atomic load.
+     */
+    class CallStats {
+        public:
+            enum class Kind : u8 {
+                /** A bound function or method called from script, keyed by its bind::Function */
+                Function,
+
+                /** A host function pointer called from script, keyed by its bind::FunctionType */
+                FunctionPointer,
+
+                /** A script function called through a host function pointer, keyed by its bind::FunctionType */
+                Callback
+            };
+
+            /**
+             * @brief Measures the phases of a single call
+             */
+            class Timer {
+                public:
+                    Timer();
+
+                    /**
+                     * @brief Marks the end of argument conversion
+                     */
+                    void argumentsDone();
+
+                    /**
+                     * @brief Marks the end of the call to the target
+                     */
+                    void callDone();
+
+                    /**
+                     * @brief Marks the end of return value conversion and records the call
+                     *
+                     * @param key The bind::Function or bind::FunctionType that was called
+                     * @param kind What the key is
+                     */
+                    void finish(const void* key, Kind kind);
+
+                private:
+                    u64 m_startedAt;
+                    u64 m_argumentsDoneAt;
+                    u64 m_callDoneAt;
+            };
+
+            /**
+             * @brief Enables or disables recording. Can be called from any thread.
+             */
+            static void SetEnabled(bool enabled);
+
+            /**
+             * @brief Whether calls are being recorded
+             */
+            static bool IsEnabled();
+
+            /**
+             * @brief Gets a monotonic timestamp in nanoseconds
+             */
+            static u64 Now();
+
+            /**
+             * @brief Records a call on the current thread
+             *
+             * @param key The bind::Function or bind::FunctionType that was called
+             * @param kind What the key is
+             * @param argumentsNs Time spent converting arguments
+             * @param callNs Time spent in the target
+             * @param returnNs Time spent converting the return value
+             */
+            static void Record(const void* key, Kind kind, u64 argumentsNs, u64 callNs, u64 returnNs);
+
+            /**
+             * @brief Clears the statistics of every thread
+             */
+            static void Reset();
+
+            /**
+             * @brief Merges the statistics of every thread and formats them as JSON
+             *
+             * The result is an object with a "bindings" array, with an element for each binding and
+             * kind that was called. Each element has the binding's name, kind, call count, the total time spent in each phase (in nanoseconds) and a latency
+             * histogram of the non-empty buckets, each with the bucket's upper bound in nanoseconds.
+             */
+            static String ToJSON();
+    };
+}
@@ -2,6 +2,7 @@
 #include <tspp/types.h>
 #include <utils/MemoryPool.h>
 
+#include <mutex>
 #include <unordered_map>
 #include <v8.h>
 
@@ -10,23 +11,59 @@ namespace bind {
 }
 
 namespace tspp {
+    class Callback;
+
+    /**
+     * @brief The callbacks created by a single runtime. Each runtime owns one, so runtimes on
+     * different threads never contend over it. Callbacks that are still registered when it's
+     * destroyed are destroyed with it.
+     */
+    class CallbackRegistry {
+        public:
+            CallbackRegistry();
+            ~CallbackRegistry();
+
+        private:
+            friend class Callback;
+
+            // Callbacks may be released by host code on other threads
+            std::mutex m_mutex;
+            MemoryPool m_pool;
+            std::unordered_map<void*, Callback*> m_map;
+    };
+
     class Callback {
         public:
             v8::Isolate* getIsolate() const;
             v8::Local<v8::Function> getTarget() const;
             bind::FunctionType* getSig() const;
 
-            static void AddRef(void* callback);
-            static void Release(void* callback);
+            /**
+             * @brief Adds a reference to a callback
+             *
+             * @param isolate The isolate of the function that the callback targets
+             * @param callback The callback's function pointer
+             */
+            static void AddRef(v8::Isolate* isolate, void* callback);
+
+            /**
+             * @brief Releases a reference to a callback, the callback is destroyed when the last
+             * reference is released
+             *
+             * @param isolate The isolate of the function that the callback targets
+             * @param callback The callback's function pointer
+             */
+            static void Release(v8::Isolate* isolate, void* callback);
+
             static void* Create(
                 v8::Isolate* isolate,
                 bind::FunctionType* sig,
                 const v8::Local<v8::Function>& target
             );
 
-            static void DestroyAll();
-        
         private:
+            friend class CallbackRegistry;
+
             Callback(
                 v8::Isolate* isolate,
                 void* closure,
@@ -40,8 +77,5 @@ namespace tspp {
             bind::FunctionType* m_sig;
             v8::Global<v8::Function> m_target;
             u32 m_refCount;
-
-            static MemoryPool m_pool;
-            static std::unordered_map<void*, Callback*> s_map;
     };
 }
@@ -0,0 +1,106 @@
+#pragma once
+#include <tspp/types.h>
+#include <utils/String.h>
+#include <utils/interfaces/IWithLogging.h>
+
+#include <chrono>
+#include <mutex>
+
+#include <v8.h>
+
+namespace v8 {
+    class CpuProfiler;
+}
+
+namespace tspp {
+    /**
+     * @brief Records CPU profiles of a runtime's isolate without the inspector, and writes them
+     * as Chrome compatible .cpuprofile files that can be opened in DevTools
+     *
+     * Only one profile is recorded at a time. Profiles can be given a duration, in which case they
+     * are stopped and written by service() once it elapses.
+     */
+    class CpuProfiler : public IWithLogging {
+        public:
+            /**
+             * @brief Constructs a new CPU profiler
+             *
+             * @param isolate The isolate to profile
+             * @param outputDirectory The directory that profiles are written to
+             */
+            CpuProfiler(v8::Isolate* isolate, const String& outputDirectory);
+
+            /**
+             * @brief Destructor, discards the current profile if there is one
+             */
+            ~CpuProfiler();
+
+            /**
+             * @brief Starts recording a profile. Must be called on the isolate's thread.
+             *
+             * @param name The name of the profile, it's written to <outputDirectory>/<name>.cpuprofile.
+             * Names that contain path separators or that are '.' or '..' are rejected.
+             * @param samplingIntervalUs How often the stack is sampled, in microseconds
+             * @param durationMs If non-zero, the profile is stopped and written after this long
+             * @return True if the profile was started
+             */
+            bool start(const String& name, u32 samplingIntervalUs = 1000, u32 durationMs = 0);
+
+            /**
+             * @brief Stops recording and writes the profile. Must be called on the isolate's thread.
+             *
+             * @param outJson Optionally receives the profile's JSON
+             * @return True if the profile was written
+             */
+            bool stop(String* outJson = nullptr);
+
+            /**
+             * @brief Requests that a profile be started the next time the profiler is serviced.
+             * Can be called from any thread, such as from a signal or admin command handler.
+             *
+             * @param name The name of the profile
+             * @param samplingIntervalUs How often the stack is sampled, in microseconds
+             * @param durationMs If non-zero, the profile is stopped and written after this long
+             */
+            void request(const String& name, u32 samplingIntervalUs = 1000, u32 durationMs = 30000);
+
+            /**
+             * @brief Whether a profile is currently being recorded
+             */
+            bool isProfiling() const;
+
+            /**
+             * @brief Starts requested profiles and stops profiles whose duration has elapsed
+             */
+            void service();
+
+            /**
+             * @brief Gets the time at which the current profile's duration elapses
+             */
+            bool getNextDeadline(std::chrono::high_resolution_clock::time_point& outDeadline) const;
+
+        private:
+            using Clock = std::chrono::high_resolution_clock;
+
+            struct Request {
+                public:
+                    String name;
+                    u32 samplingIntervalUs;
+                    u32 durationMs;
+            };
+
+            v8::Isolate* m_isolate;
+            v8::CpuProfiler* m_profiler;
+            String m_outputDirectory;
+
+            // The current profile
+            String m_name;
+            bool m_hasDeadline;
+            Clock::time_point m_stopAt;
+
+            // Requests from other threads
+            std::mutex m_requestMutex;
+            bool m_hasRequest;
+            Request m_request;
+    };
+}
@@ -0,0 +1,172 @@
+#pragma once
+#include <tspp/types.h>
+#include <tspp/utils/Histogram.h>
+#include <tspp/utils/IsolateMonitor.h>
+#include <utils/Array.h>
+#include <utils/String.h>
+
+namespace tspp {
+    /**
+     * @brief An entry into script that ran for longer than the long task threshold
+     */
+    struct LongTask {
+        public:
+            // Description of the entry point, e.g. 'timer callback' or the name of a module
+            String entryPoint;
+
+            // Time since the monitor was started when the task began
+            f64 startedAtMs;
+
+            // How long the task ran for
+            f64 durationMs;
+
+            // JavaScript stack sampled while the task was running, empty if it never ran
+            // JavaScript long enough to be sampled
+            String stack;
+    };
+
+    /**
+     * @brief Summary of the event loop's responsiveness since the monitor was started or reset
+     */
+    struct EventLoopStats {
+        public:
+            // Calls to Runtime::service and how long they took
+            u64 iterationCount;
+            f64 iterationMeanMs;
+            f64 iterationMaxMs;
+
+            // How late timers fired compared to when they were scheduled to
+            u64 lagSampleCount;
+            f64 lagMeanMs;
+            f64 lagP50Ms;
+            f64 lagP90Ms;
+            f64 lagP99Ms;
+            f64 lagMaxMs;
+
+            // Number of long tasks detected, including those that were discarded
+            u64 longTaskCount;
+    };
+
+    /**
+     * @brief Measures event loop lag and reports entries into script that block it for too long
+     *
+     * Entries from the host into script made while servicing the runtime are wrapped in an
+     * EventLoopMonitor::Scope. Any entry that runs for longer than the configured threshold is
+     * recorded as a long task. A separate thread watches the running entry, and once it passes
+     * the threshold an interrupt is requested on the isolate to sample the JavaScript stack, so
+     * the report says what was running and not just where it was entered from.
+     */
+    class EventLoopMonitor : public IsolateMonitor {
+        public:
+            /**
+             * @brief Marks an entry into script for the duration of its lifetime. Scopes may be
+             * nested, when both are long only the innermost one is reported.
+             */
+            class Scope {
+                public:
+                    /**
+                     * @param monitor The monitor to report to, may be null
+                     * @param entryPoint Description of the entry point, must outlive the scope
+                     */
+                    Scope(EventLoopMonitor* monitor, const char* entryPoint);
+                    ~Scope();
+
+                private:
+                    EventLoopMonitor* m_monitor;
+            };
+
+            /**
+             * @brief Constructs a new event loop monitor
+             *
+             * @param config Configuration options for the monitor
+             */
+            EventLoopMonitor(const EventLoopMonitorConfig& config);
+
+            /**
+             * @brief Destructor
+             */
+            ~EventLoopMonitor();
+
+            /**
+             * @brief Starts the monitor thread. Must be called on the isolate's thread.
+             *
+             * @param isolate The isolate to monitor
+             */
+            void start(v8::Isolate* isolate);
+
+            /**
+             * @brief Stops the monitor thread
+             */
+            void stop();
+
+            /**
+             * @brief Records how long a call to Runtime::service took
+             */
+            void recordIteration(u64 durationUs);
+
+            /**
+             * @brief Records how late a timer fired compared to when it was scheduled to
+             */
+            void recordLag(u64 lagUs);
+
+            /**
+             * @brief Gets a summary of the event loop's responsiveness. Must be called on the
+             * isolate's thread.
+             */
+            EventLoopStats getStats() const;
+
+            /**
+             * @brief Gets the most recent long tasks, oldest first. Must be called on the
+             * isolate's thread.
+             */
+            const Array<LongTask>& getLongTasks() const;
+
+            /**
+             * @brief Discards all recorded measurements and long tasks. Must be called on the
+             * isolate's thread.
+             */
+            void reset();
+
+            /**
+             * @brief Gets the time since the monitor was started, in milliseconds
+             */
+            f64 now() const;
+
+            /**
+             * @brief Gets the event loop monitor of the runtime that owns an isolate, if it has one
+             */
+            static EventLoopMonitor* Get(v8::Isolate* isolate);
+
+        private:
+            struct ActiveScope {
+                    const char* entryPoint;
+                    u64 enteredAt;
+                    bool didReportChild;
+            };
+
+            void enter(const char* entryPoint);
+            void exit();
+            void check() override;
+            void interrupt(v8::Isolate* isolate) override;
+            u64 getTimeUs() const;
+
+            EventLoopMonitorConfig m_config;
+            u64 m_startedAt;
+
+            // Only accessed on the isolate thread
+            Array<ActiveScope> m_scopes;
+            Histogram m_iterations;
+            Histogram m_lag;
+            Array<LongTask> m_longTasks;
+            u64 m_longTaskCount;
+
+            // Stack sampled by the interrupt, and the depth of the scope it was sampled in
+            String m_stack;
+            u32 m_stackDepth;
+
+            // Shared with the monitor thread
+            u64 m_enteredAt;
+            bool m_didRequestStack;
+            bool m_didSampleStack;
+    };
+}
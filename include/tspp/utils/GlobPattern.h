@@ -0,0 +1,40 @@
+#pragma once
+#include <tspp/types.h>
+#include <utils/Array.h>
+#include <utils/String.h>
+
+#include <string>
+
+namespace tspp {
+    /**
+     * @brief A tsconfig style include / exclude pattern
+     *
+     * Supports '*', '?', character classes ('[a-z]', '[!0-9]'), brace alternatives ('{a,b}') and
+     * '**' for any number of directories. Patterns whose last segment has no wildcard or extension
+     * name a directory and match everything beneath it. Paths are matched as arrays of segments,
+     * relative to the directory the pattern is relative to.
+     */
+    class GlobPattern {
+        public:
+            GlobPattern(const String& pattern);
+
+            /**
+             * @brief Checks if the pattern matches a file
+             *
+             * @param path The segments of the file's path
+             */
+            bool matches(const Array<std::string>& path) const;
+
+            /**
+             * @brief Checks if the pattern matches everything beneath a directory, so that it can
+             * be skipped entirely when used to exclude files
+             *
+             * @param path The segments of the directory's path
+             */
+            bool matchesDirectory(const Array<std::string>& path) const;
+
+        private:
+            Array<Array<std::string>> m_alternatives;
+            Array<Array<std::string>> m_directories;
+    };
+}
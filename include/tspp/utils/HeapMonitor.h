@@ -0,0 +1,159 @@
+#pragma once
+#include <tspp/types.h>
+#include <tspp/utils/Histogram.h>
+#include <utils/Array.h>
+#include <utils/String.h>
+#include <utils/interfaces/IWithLogging.h>
+
+#include <chrono>
+
+#include <v8.h>
+
+namespace tspp {
+    class HeapProfiler;
+
+    /**
+     * @brief Size of one of the spaces that V8's heap is divided into
+     */
+    struct HeapSpaceStats {
+        public:
+            String name;
+            u64 size;
+            u64 used;
+            u64 available;
+            u64 physicalSize;
+    };
+
+    /**
+     * @brief Size of the heap as of the most recent sample
+     */
+    struct HeapStats {
+        public:
+            u64 totalHeapSize;
+            u64 usedHeapSize;
+            u64 heapSizeLimit;
+            u64 totalPhysicalSize;
+            u64 mallocedMemory;
+            u64 externalMemory;
+            u64 nativeContexts;
+            u64 detachedContexts;
+
+            // Largest used heap size seen by any sample since the monitor was created or reset
+            u64 peakUsedHeapSize;
+
+            Array<HeapSpaceStats> spaces;
+    };
+
+    /**
+     * @brief Garbage collections of a single type
+     */
+    struct GCTypeStats {
+        public:
+            u64 count;
+            f64 totalPauseMs;
+            f64 maxPauseMs;
+
+            // Difference in used heap size from before to after each collection, collections
+            // that grew the heap don't count
+            u64 bytesReclaimed;
+    };
+
+    /**
+     * @brief Garbage collections since the monitor was created or reset
+     */
+    struct GCStats {
+        public:
+            GCTypeStats scavenge;
+            GCTypeStats minorMarkSweep;
+            GCTypeStats markSweepCompact;
+            GCTypeStats incrementalMarking;
+            GCTypeStats processWeakCallbacks;
+
+            // Pauses of every type
+            u64 pauseCount;
+            f64 totalPauseMs;
+            f64 pauseP50Ms;
+            f64 pauseP99Ms;
+            f64 pauseMaxMs;
+
+            // Times the heap neared its limit, and how many of those the limit was raised
+            u64 nearHeapLimitCount;
+            u64 heapLimitExpansions;
+    };
+
+    /**
+     * @brief Records garbage collection pauses and samples heap statistics for a runtime's isolate
+     *
+     * Also handles the isolate nearing its heap limit, where it reports the state of the heap and
+     * can raise the limit or write a heap snapshot before the process runs out of memory.
+     */
+    class HeapMonitor : public IWithLogging {
+        public:
+            /**
+             * @brief Constructs a new heap monitor and registers its callbacks with the isolate
+             *
+             * @param isolate The isolate to monitor
+             * @param config Configuration options for the monitor
+             * @param profiler The profiler used to write a heap snapshot when the heap nears its limit
+             */
+            HeapMonitor(v8::Isolate* isolate, const HeapMonitorConfig& config, HeapProfiler* profiler);
+
+            /**
+             * @brief Destructor, unregisters the monitor's callbacks
+             */
+            ~HeapMonitor();
+
+            /**
+             * @brief Samples heap statistics if the sample interval has elapsed
+             */
+            void service();
+
+            /**
+             * @brief Samples heap statistics now. Must be called on the isolate's thread.
+             */
+            void sample();
+
+            /**
+             * @brief Gets the heap statistics as of the most recent sample
+             */
+            const HeapStats& getHeapStats() const;
+
+            /**
+             * @brief Gets the garbage collection statistics
+             */
+            GCStats getGCStats() const;
+
+            /**
+             * @brief Discards the recorded garbage collections and peak heap size
+             */
+            void reset();
+
+        private:
+            using Clock = std::chrono::high_resolution_clock;
+
+            GCTypeStats* getTypeStats(v8::GCType type);
+            void writePendingSnapshot();
+
+            static void OnGCPrologue(v8::Isolate* isolate, v8::GCType type, v8::GCCallbackFlags flags, void* data);
+            static void OnGCEpilogue(v8::Isolate* isolate, v8::GCType type, v8::GCCallbackFlags flags, void* data);
+            static size_t OnNearHeapLimit(void* data, size_t currentHeapLimit, size_t initialHeapLimit);
+            static void OnSnapshotInterrupt(v8::Isolate* isolate, void* data);
+
+            v8::Isolate* m_isolate;
+            HeapMonitorConfig m_config;
+            HeapProfiler* m_profiler;
+
+            HeapStats m_heap;
+            Clock::time_point m_nextSampleAt;
+
+            GCStats m_gc;
+            Histogram m_pauses;
+            Clock::time_point m_gcStartedAt;
+            u64 m_gcUsedBefore;
+
+            bool m_didWriteSnapshot;
+
+            // Set when the heap limit was raised to make room for a snapshot that hasn't been written yet
+            bool m_isSnapshotPending;
+    };
+}
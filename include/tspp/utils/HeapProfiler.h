@@ -0,0 +1,80 @@
+#pragma once
+#include <tspp/types.h>
+#include <utils/String.h>
+#include <utils/interfaces/IWithLogging.h>
+
+#include <v8.h>
+
+namespace v8 {
+    class EmbedderGraph;
+}
+
+namespace tspp {
+    /**
+     * @brief Writes heap snapshots and sampling heap profiles of a runtime's isolate without the
+     * inspector, as Chrome compatible .heapsnapshot and .heapprofile files that can be opened in
+     * DevTools
+     *
+     * Host objects that are wrapped by JavaScript objects show up in snapshots under the name of
+     * their bound type, with their native size (including resources reported by the type's
+     * externalSizeOf function) added to the wrapper, so leaks across the boundary are visible.
+     */
+    class HeapProfiler : public IWithLogging {
+        public:
+            /**
+             * @brief Constructs a new heap profiler
+             *
+             * @param isolate The isolate to profile
+             * @param outputDirectory The directory that relative paths are resolved against
+             */
+            HeapProfiler(v8::Isolate* isolate, const String& outputDirectory);
+
+            /**
+             * @brief Destructor, discards the current sampling heap profile if there is one
+             */
+            ~HeapProfiler();
+
+            /**
+             * @brief Takes a heap snapshot and streams it to a file as it's serialized, the
+             * snapshot is never held in memory as a whole. Must be called on the isolate's thread.
+             *
+             * @param path Path to write the snapshot to, relative to the output directory. It isn't
+             * restricted to the output directory, paths that come from scripts should be checked
+             * with isPlainFileName first
+             * @return True if the snapshot was written
+             */
+            bool takeHeapSnapshot(const String& path);
+
+            /**
+             * @brief Starts sampling allocations. Must be called on the isolate's thread.
+             *
+             * @param samplingIntervalBytes Average number of bytes allocated between samples
+             * @param stackDepth Maximum number of stack frames recorded for each sample
+             * @return True if sampling was started
+             */
+            bool startSamplingHeapProfile(u32 samplingIntervalBytes = 512 * 1024, u32 stackDepth = 16);
+
+            /**
+             * @brief Stops sampling allocations and writes the stacks that allocated the sampled
+             * objects that are still alive. Must be called on the isolate's thread.
+             *
+             * @param path Path to write the profile to, relative to the output directory
+             * @return True if the profile was written
+             */
+            bool stopSamplingHeapProfile(const String& path);
+
+            /**
+             * @brief Whether allocations are currently being sampled
+             */
+            bool isSampling() const;
+
+        private:
+            String resolvePath(const String& path) const;
+
+            static void BuildEmbedderGraph(v8::Isolate* isolate, v8::EmbedderGraph* graph, void* data);
+
+            v8::Isolate* m_isolate;
+            String m_outputDirectory;
+            bool m_isSampling;
+    };
+}
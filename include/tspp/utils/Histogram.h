@@ -0,0 +1,67 @@
+#pragma once
+#include <tspp/types.h>
+
+namespace tspp {
+    /**
+     * @brief Log-linear histogram of unsigned integer values, such as latencies
+     *
+     * Values below 4 get a bucket each, above that every power of two is split into 4 buckets,
+     * so percentiles are accurate to within 25% regardless of the range of values recorded.
+     * Not thread safe.
+     */
+    class Histogram {
+        public:
+            static constexpr u32 LinearBucketCount = 4;
+            static constexpr u32 SubBucketBits     = 2;
+            static constexpr u32 BucketCount       = LinearBucketCount + (64 - SubBucketBits) * (1 << SubBucketBits);
+
+            Histogram();
+
+            /**
+             * @brief Records a value
+             */
+            void record(u64 value);
+
+            /**
+             * @brief Discards all recorded values
+             */
+            void reset();
+
+            u64 getCount() const;
+            u64 getSum() const;
+            u64 getMin() const;
+            u64 getMax() const;
+            f64 getMean() const;
+
+            /**
+             * @brief Estimates the value below which a percentage of the recorded values fall
+             *
+             * @param percentile The percentile, between 0 and 100
+             * @return The upper bound of the bucket that the percentile falls in, clamped to the
+             * largest recorded value. 0 if nothing has been recorded.
+             */
+            u64 getPercentile(f64 percentile) const;
+
+            /**
+             * @brief Gets the number of values recorded in a bucket
+             */
+            u64 getBucketCount(u32 index) const;
+
+            /**
+             * @brief Gets the index of the bucket that a value is recorded in
+             */
+            static u32 GetBucketIndex(u64 value);
+
+            /**
+             * @brief Gets the largest value that's recorded in a bucket
+             */
+            static u64 GetBucketUpperBound(u32 index);
+
+        private:
+            u64 m_buckets[BucketCount];
+            u64 m_count;
+            u64 m_sum;
+            u64 m_min;
+            u64 m_max;
+    };
+}
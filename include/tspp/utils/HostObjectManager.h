@@ -4,6 +4,7 @@
 #include <utils/MemoryPool.h>
 #include <utils/interfaces/IWithLogging.h>
 
+#include <mutex>
 #include <unordered_map>
 #include <v8.h>
 
@@ -12,7 +13,32 @@ namespace bind {
     class Function;
 }
 
+namespace v8 {
+    class EmbedderGraph;
+}
+
 namespace tspp {
+    /**
+     * @brief Memory statistics for the live host objects of a single bound type
+     */
+    struct HostObjectStats {
+        public:
+            bind::DataType* dataType;
+
+            // Number of objects that haven't been freed yet
+            u32 liveCount;
+
+            // Memory occupied by the objects themselves
+            u64 liveMemSize;
+
+            // Memory owned by the objects, as reported by the type's externalSizeOf function
+            u64 externalMemSize;
+    };
+
+    /**
+     * @brief Owns the live host objects of a single bound type in a single runtime. Each runtime
+     * has its own manager for each type, and destroys its objects when it shuts down.
+     */
     class HostObjectManager : public IWithLogging {
         public:
             HostObjectManager(bind::DataType* dataType, u32 elementsPerPool = 256);
@@ -24,15 +50,96 @@ namespace tspp {
             void free(void* mem);
             u32 getLiveCount();
             u32 getLiveMemSize();
+            u64 getExternalMemSize();
+            HostObjectStats getStats();
             v8::Local<v8::Object> getTargetIfMapped(v8::Isolate* isolate, void* mem);
 
+            /**
+             * @brief Measures an object again with the type's externalSizeOf function and reports
+             * the difference to V8. Should be called whenever an object's owned resources change
+             * size, and is called after an object is constructed from JS.
+             *
+             * @param mem The object
+             */
+            void updateExternalSize(void* mem);
+
+            /**
+             * @brief Gives a bound type an object manager id, so that each runtime can create its
+             * own manager for the type. Does nothing if the type already has one.
+             *
+             * @param dataType The bound type
+             */
+            static void RegisterType(bind::DataType* dataType);
+
+            /**
+             * @brief Gets the object manager of a bound type in the runtime that owns an isolate,
+             * creating it if the runtime hasn't used the type yet
+             *
+             * @param isolate The isolate
+             * @param dataType The bound type
+             * @return The object manager, or nullptr if objects of the type aren't managed or the
+             * isolate doesn't belong to a runtime
+             */
+            static HostObjectManager* Get(v8::Isolate* isolate, bind::DataType* dataType);
+
+            /**
+             * @brief Gets the statistics of every bound type that a runtime has allocated objects of
+             *
+             * @param isolate The runtime's isolate
+             */
+            static Array<HostObjectStats> GetAllStats(v8::Isolate* isolate);
+
+            /**
+             * @brief Adds each live object that's wrapped by a JavaScript object in an isolate to
+             * a heap snapshot, named after its bound type and merged into its wrapper
+             *
+             * @param isolate The isolate that the snapshot is being taken of
+             * @param graph The snapshot's embedder graph
+             */
+            void addToEmbedderGraph(v8::Isolate* isolate, v8::EmbedderGraph* graph);
+
+            /**
+             * @brief Adds the live objects of every bound type in the isolate's runtime to a heap
+             * snapshot, see addToEmbedderGraph
+             */
+            static void AddAllToEmbedderGraph(v8::Isolate* isolate, v8::EmbedderGraph* graph);
+
         private:
             using ObjRef = std::unique_ptr<v8::Global<v8::Object>>;
+
+            struct LiveObject {
+                public:
+                    ObjRef ref;
+
+                    // The isolate that the object's memory was reported to, null until it has a JS reference
+                    v8::Isolate* isolate;
+
+                    // Size of the resources owned by the object when it was last measured
+                    u64 externalSize;
+
+                    // Whether the object's size (and externalSize) has been reported to the isolate
+                    bool isReported;
+            };
+
             void bindGCListener(ObjRef& ref, void* mem);
+            void reportSize(LiveObject& object, void* mem, bool isConstructed);
 
+            // Destructors may free other objects of the same type
+            std::recursive_mutex m_mutex;
             MemoryPool m_pool;
-            std::unordered_map<void*, ObjRef> m_liveObjects;
+            std::unordered_map<void*, LiveObject> m_liveObjects;
             bind::Function* m_destructor;
             bind::DataType* m_dataType;
+            u64 m_externalMemSize;
     };
+
+    /**
+     * @brief Sets the function used to measure the native resources (textures, buffers, etc.)
+     * owned by objects of a bound type. The size is reported to V8 as external memory so that
+     * small wrappers holding on to large allocations are collected sooner.
+     *
+     * @param dataType The bound type
+     * @param sizeOf The function, or null to only report the size of the objects themselves
+     */
+    void setExternalSizeOf(bind::DataType* dataType, ExternalSizeFn sizeOf);
 }
\ No newline at end of file
@@ -0,0 +1,76 @@
+#pragma once
+#include <tspp/types.h>
+#include <tspp/utils/Thread.h>
+#include <utils/interfaces/IWithLogging.h>
+
+#include <condition_variable>
+#include <mutex>
+
+namespace v8 {
+    class Isolate;
+}
+
+namespace tspp {
+    /**
+     * @brief Base of the monitors that watch an isolate's entries into script from a separate
+     * thread, and interrupt the isolate when an entry runs for too long
+     *
+     * The derived class tracks entries on the isolate's thread and sets m_isActive while one is
+     * running. Every check interval the monitor thread calls check() for the active entry, which
+     * may call requestInterrupt() to have interrupt() called on the isolate's thread the next time
+     * it runs JavaScript.
+     */
+    class IsolateMonitor : public IWithLogging {
+        public:
+            /**
+             * @param name The name to log with
+             * @param checkIntervalMs How often the monitor thread checks the active entry
+             */
+            IsolateMonitor(const String& name, u32 checkIntervalMs);
+
+        protected:
+            /**
+             * @brief Starts the monitor thread. Must be called on the isolate's thread.
+             *
+             * @param isolate The isolate to monitor
+             */
+            void startMonitoring(v8::Isolate* isolate);
+
+            /**
+             * @brief Stops the monitor thread, does nothing if it isn't running. Must be called
+             * before the derived class is destroyed.
+             */
+            void stopMonitoring();
+
+            /**
+             * @brief Requests a call to interrupt() on the isolate's thread
+             */
+            void requestInterrupt();
+
+            /**
+             * @brief Called on the monitor thread with m_mutex held, while an entry is active
+             */
+            virtual void check() = 0;
+
+            /**
+             * @brief Called on the isolate's thread after requestInterrupt(), without m_mutex held.
+             * The entry may have returned by the time it's called.
+             */
+            virtual void interrupt(v8::Isolate* isolate) = 0;
+
+            v8::Isolate* m_isolate;
+
+            // Shared with the monitor thread
+            std::mutex m_mutex;
+            bool m_isActive;
+
+        private:
+            void run();
+            static void OnInterrupt(v8::Isolate* isolate, void* data);
+
+            u32 m_checkIntervalMs;
+            Thread m_thread;
+            std::condition_variable m_condition;
+            bool m_doStop;
+    };
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include <tspp/types.h>
+#include <utils/String.h>
+
+namespace tspp {
+    /**
+     * @brief Symbols for host generated code that Linux perf can't otherwise resolve
+     *
+     * V8 writes its own JIT code to /tmp/perf-<pid>.map when a perf mode is enabled (see
+     * ScriptConfig::perfMode). Bound functions and fast API targets are ordinary native
+     * functions that perf resolves from the binary, but callback trampolines are generated at
+     * runtime by libffi and would show up as anonymous addresses.
+     *
+     * V8 keeps the map open and writes to it at its own file position, so entries for those can't
+     * be appended while it's running. Instead each one is written to /tmp/perf-<pid>.tspp.map as
+     * soon as it's added, and that file is appended to the map once V8 has closed it. If the
+     * process exits without disposing V8 (for example when it's killed), append the fragment by
+     * hand before running perf report:
+     *
+     *     cat /tmp/perf-<pid>.tspp.map >> /tmp/perf-<pid>.map
+     *
+     * Does nothing on platforms other than Linux.
+     */
+    class PerfMap {
+        public:
+            /**
+             * @brief Starts collecting entries
+             */
+            static void Enable();
+
+            /**
+             * @brief Returns true if entries are being collected
+             */
+            static bool IsEnabled();
+
+            /**
+             * @brief Adds a symbol for a range of generated code, and writes it to the fragment
+             * right away so that it isn't lost if the process doesn't exit cleanly
+             *
+             * @param address The address of the first instruction
+             * @param size The size of the code in bytes
+             * @param name The name to show for the code
+             */
+            static void AddEntry(const void* address, u64 size, const String& name);
+
+            /**
+             * @brief Appends the fragment to /tmp/perf-<pid>.map and deletes it. Must only be called
+             * once every isolate has been disposed, V8 truncates the file when it opens it.
+             */
+            static void Flush();
+    };
+}
@@ -0,0 +1,102 @@
+#pragma once
+#include <tspp/types.h>
+#include <utils/interfaces/IWithLogging.h>
+
+#include <chrono>
+
+namespace tspp {
+    /**
+     * @brief A handle that an embedder can add to its own event loop to find out when a
+     * runtime needs to be serviced
+     *
+     * On Linux the handle is an epoll descriptor that becomes readable when either its eventfd
+     * is signaled (work was queued from any thread) or its timerfd expires (the next deadline of
+     * a timer or waiter was reached). On Windows the handle is a manual-reset event that's set
+     * when work is queued, deadlines aren't represented by the handle and should be used as the
+     * wait timeout instead (see Runtime::getNextDeadline).
+     *
+     * signal may be called from any thread, everything else must be called on the runtime's thread.
+     */
+    class PollHandle : public IWithLogging {
+        public:
+            using Clock = std::chrono::high_resolution_clock;
+
+#ifdef _WIN32
+            using NativeHandle = void*;
+#else
+            using NativeHandle = i32;
+#endif
+
+            PollHandle();
+            ~PollHandle();
+
+            /**
+             * @brief Creates the underlying OS objects
+             *
+             * @return True if the handle was created
+             */
+            bool open();
+
+            /**
+             * @brief Destroys the underlying OS objects
+             */
+            void close();
+
+            /**
+             * @brief Gets the handle to wait on, wait for it to become readable (or signaled)
+             * and then service the runtime
+             */
+            NativeHandle getNativeHandle() const;
+
+            /**
+             * @brief Makes the handle ready. Thread safe.
+             */
+            void signal();
+
+            /**
+             * @brief Blocks until the handle is ready, for runtimes that are serviced by a thread of
+             * their own. Doesn't make the handle not ready, that's left to the next service.
+             *
+             * @return False if the handle isn't open or waiting failed
+             */
+            bool wait();
+
+            /**
+             * @brief Makes the handle not ready, and forgets the current deadline. Called by the
+             * runtime before it services its modules.
+             */
+            void clear();
+
+            /**
+             * @brief Makes the handle ready at the specified time, replacing the current deadline
+             *
+             * @param deadline The time at which the runtime next needs to be serviced
+             */
+            void setDeadline(Clock::time_point deadline);
+
+            /**
+             * @brief Sets the deadline only if there is no deadline yet or the new one is sooner
+             *
+             * @param deadline The time at which the runtime next needs to be serviced
+             */
+            void setDeadlineIfEarlier(Clock::time_point deadline);
+
+            /**
+             * @brief Removes the current deadline
+             */
+            void clearDeadline();
+
+        private:
+            bool m_isOpen;
+            bool m_hasDeadline;
+            Clock::time_point m_deadline;
+
+#ifdef _WIN32
+            void* m_event;
+#else
+            i32 m_epollFd;
+            i32 m_eventFd;
+            i32 m_timerFd;
+#endif
+    };
+}
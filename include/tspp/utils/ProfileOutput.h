@@ -0,0 +1,47 @@
+#pragma once
+#include <tspp/types.h>
+#include <utils/String.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+namespace tspp {
+    /**
+     * @brief Appends a string to JSON output, escaped to be placed between double quotes
+     *
+     * @param out The JSON being built
+     * @param str The null-terminated string to escape
+     */
+    void appendJSONEscaped(std::string& out, const char* str);
+
+    /**
+     * @brief Checks that a name refers to a file directly inside whatever directory it's resolved
+     * against. Names that come from scripts must pass this before being used as output paths, so
+     * that scripts can't write outside the profile output directory.
+     *
+     * @param name The name to check
+     * @return Whether the name is non-empty and has no directory separators, drive or parent references
+     */
+    bool isPlainFileName(const String& name);
+
+    /**
+     * @brief Opens a file that profiling output will be written to, creating its parent
+     * directories if they don't exist yet
+     *
+     * @param path The path of the file, replaced if it already exists
+     * @param file The stream to open the file with
+     * @return Whether the file was opened
+     */
+    bool openOutputFile(const std::filesystem::path& path, std::ofstream& file);
+
+    /**
+     * @brief Writes profiling output to a file, creating its parent directories if they don't
+     * exist yet
+     *
+     * @param path The path of the file, replaced if it already exists
+     * @param data The data to write
+     * @return Whether all of the data was written
+     */
+    bool writeOutputFile(const std::filesystem::path& path, const std::string& data);
+}
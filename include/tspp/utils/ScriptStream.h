@@ -0,0 +1,104 @@
+#pragma once
+#include <tspp/types.h>
+#include <tspp/utils/Thread.h>
+#include <utils/String.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include <v8.h>
+
+namespace tspp {
+    class Runtime;
+
+    /**
+     * @brief A script whose source is read and parsed on a worker thread using V8's
+     * streaming compiler. Only the final compilation step has to happen on the isolate
+     * thread.
+     *
+     * Instances must be owned by a std::shared_ptr, the job running on the thread pool
+     * keeps the stream alive until it's done with it.
+     */
+    class ScriptStream : public std::enable_shared_from_this<ScriptStream> {
+        public:
+            /**
+             * @brief Creates a stream that reads the script from a file on the worker thread
+             *
+             * @param filename The path of the script file
+             */
+            ScriptStream(const String& filename);
+
+            /**
+             * @brief Creates a stream for script source that's already in memory
+             *
+             * @param filename The name to report in stack traces
+             * @param code The script source
+             */
+            ScriptStream(const String& filename, const String& code);
+            ~ScriptStream();
+
+            /**
+             * @brief Starts streaming the script on the runtime's thread pool
+             *
+             * @note This must be called on the isolate thread
+             *
+             * @param runtime The runtime whose isolate the script will be compiled for
+             * @param onParsed Optional callback that's called on the isolate thread once parsing finishes
+             */
+            void begin(Runtime* runtime, const std::function<void(ScriptStream*)>& onParsed = nullptr);
+
+            /**
+             * @brief Blocks the calling thread until the worker has finished parsing the script
+             */
+            void waitForParse();
+
+            /**
+             * @brief Whether the worker has finished parsing the script
+             */
+            bool isParsed() const;
+
+            /**
+             * @brief Whether the script file could not be read
+             */
+            bool didReadFail() const;
+
+            /**
+             * @brief Finishes compiling the script, waiting for the worker if it hasn't finished parsing.
+             * Compilation errors are left on any TryCatch that is active in the calling scope.
+             *
+             * @note This must be called on the isolate thread, and only once
+             *
+             * @param context The context to compile the script in
+             * @return The compiled script, or an empty handle if reading or compilation failed
+             */
+            v8::MaybeLocal<v8::Script> compile(v8::Local<v8::Context> context);
+
+            const String& getFilename() const;
+
+        protected:
+            class SourceStream;
+            class StreamJob;
+
+            void onParsed();
+
+            String m_filename;
+            bool m_isFile;
+
+            // Read by the worker, also the full source that's needed by the final compilation step
+            std::string m_code;
+            size_t m_codeOffset;
+            std::atomic<bool> m_readFailed;
+
+            std::unique_ptr<v8::ScriptCompiler::StreamedSource> m_source;
+            std::unique_ptr<v8::ScriptCompiler::ScriptStreamingTask> m_task;
+            std::function<void(ScriptStream*)> m_onParsed;
+
+            std::mutex m_parseMutex;
+            std::condition_variable m_parseCondition;
+            std::atomic<bool> m_isParsed;
+    };
+}
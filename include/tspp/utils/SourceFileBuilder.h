@@ -3,10 +3,18 @@
 
 #include <utils/String.h>
 
+#include <string>
+
 namespace tspp {
+    /**
+     * @brief Builds indented source text in a single growable buffer
+     */
     class SourceFileBuilder {
         public:
-            SourceFileBuilder();
+            /**
+             * @param reserve The number of bytes to reserve for the content up front
+             */
+            SourceFileBuilder(u32 reserve = 64 * 1024);
             ~SourceFileBuilder();
 
             void indent();
@@ -16,13 +24,17 @@ namespace tspp {
             void line(const String& str);
             void line(const char* fmt, ...);
 
-            const String& getContent() const;
+            String getContent() const;
             bool writeToFile(const String& path) const;
 
         protected:
+            void append(const char* str, size_t length);
             void ensureIndent();
             u32 m_indentLevel;
             bool m_needsIndent;
-            String m_content;
+            std::string m_content;
+
+            // Reused by line(fmt, ...) so formatting doesn't allocate once it has grown large enough
+            std::string m_formatBuffer;
     };
 }
@@ -0,0 +1,20 @@
+#pragma once
+#include <tspp/types.h>
+#include <utils/String.h>
+
+namespace v8 {
+    class Isolate;
+}
+
+namespace tspp {
+    /**
+     * @brief Formats the JavaScript stack that's currently running in an isolate, as one
+     * "\n    at <function> (<script>:<line>:<column>)" line per frame. Must be called on the
+     * isolate's thread.
+     *
+     * @param isolate The isolate
+     * @param maxFrames The maximum number of frames to include
+     * @return The formatted stack, empty if no JavaScript is running
+     */
+    String formatCurrentStack(v8::Isolate* isolate, u32 maxFrames);
+}
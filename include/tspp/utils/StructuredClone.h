@@ -0,0 +1,70 @@
+#pragma once
+#include <tspp/types.h>
+
+#include <memory>
+#include <vector>
+
+#include <v8.h>
+
+namespace tspp {
+    /**
+     * @brief A JavaScript value serialized with V8's implementation of the structured clone
+     * algorithm, so that it can be deserialized in another isolate
+     *
+     * ArrayBuffers in the transfer list have their backing stores moved into the serialized
+     * value rather than copied. SharedArrayBuffers are never copied, every isolate that
+     * deserializes the value shares the same backing store.
+     */
+    class SerializedValue {
+        public:
+            SerializedValue();
+            SerializedValue(SerializedValue&& rhs);
+            SerializedValue(const SerializedValue&) = delete;
+            ~SerializedValue();
+
+            SerializedValue& operator=(SerializedValue&& rhs);
+            SerializedValue& operator=(const SerializedValue&) = delete;
+
+            /**
+             * @brief Serializes a value. If the value can't be cloned an exception is thrown in
+             * the context's isolate.
+             *
+             * @param context The context that the value belongs to
+             * @param value The value to serialize
+             * @param transferList Optional array of ArrayBuffers whose contents should be moved
+             * rather than copied. They're detached once the value has been serialized.
+             * @return True if the value was serialized
+             */
+            bool serialize(
+                v8::Local<v8::Context> context,
+                v8::Local<v8::Value> value,
+                v8::Local<v8::Value> transferList = v8::Local<v8::Value>()
+            );
+
+            /**
+             * @brief Deserializes the value. Transferred ArrayBuffers are handed over to the
+             * deserializing isolate, so a value should only be deserialized once.
+             *
+             * @param context The context to create the value in
+             * @return The value, or an empty handle if deserialization failed
+             */
+            v8::MaybeLocal<v8::Value> deserialize(v8::Local<v8::Context> context);
+
+            /**
+             * @brief Gets the size of the serialized data in bytes, not including the contents
+             * of transferred or shared buffers
+             */
+            size_t getSize() const;
+
+        private:
+            class SerializerDelegate;
+            class DeserializerDelegate;
+
+            void release();
+
+            u8* m_data;
+            size_t m_size;
+            std::vector<std::shared_ptr<v8::BackingStore>> m_transferred;
+            std::vector<std::shared_ptr<v8::BackingStore>> m_shared;
+    };
+}
@@ -1,13 +1,17 @@
 #pragma once
 #include <tspp/types.h>
 #include <utils/Array.h>
+#include <utils/String.h>
 
+#include <atomic>
 #include <thread>
 #include <mutex>
 #include <condition_variable>
 #include <functional>
 
 namespace tspp {
+    class EventLoopMonitor;
+
     typedef u32 thread_id;
     typedef u32 worker_id;
 
@@ -28,6 +32,23 @@ namespace tspp {
             static u32 MaxHardwareThreads();
             static u32 CurrentCpuIndex();
 
+            /**
+             * @brief Opens a handle that can be used to read the calling thread's CPU time
+             * from any thread. Returns 0 if that isn't supported on this platform.
+             */
+            static u64 OpenCpuClock();
+
+            /**
+             * @brief Reads the CPU time (user + kernel) consumed by the thread a clock was
+             * opened for, in microseconds
+             */
+            static bool ReadCpuClock(u64 clock, u64& outTimeUs);
+
+            /**
+             * @brief Releases a handle returned by OpenCpuClock
+             */
+            static void CloseCpuClock(u64 clock);
+
         protected:
             std::thread m_thread;
             std::mutex m_isRunningMutex;
@@ -52,6 +73,82 @@ namespace tspp {
              * @note This is called on the runtime thread.
              */
             virtual void afterComplete() = 0;
+
+            /**
+             * @brief Gets the name that the job's statistics are grouped under. Every job of a class
+             * should return the same string, and it must outlive the thread pool.
+             */
+            virtual const char* getName() const;
+
+        private:
+            friend class ThreadPool;
+            friend class Worker;
+
+            // Steady clock timestamps in nanoseconds, for the thread pool's statistics
+            u64 m_submittedAt;
+            u64 m_completedAt;
+    };
+
+    /**
+     * @brief Statistics of the jobs that share a name, see IJob::getName. Jobs with names beyond
+     * the first 16 that a worker runs are reported together under the name "(other)"
+     */
+    struct ThreadPoolJobStats {
+        public:
+            String name;
+            u64 count;
+            f64 totalRunMs;
+            f64 maxRunMs;
+    };
+
+    /**
+     * @brief Statistics of a single worker thread
+     */
+    struct ThreadPoolWorkerStats {
+        public:
+            worker_id id;
+            u64 jobCount;
+            f64 busyMs;
+            f64 idleMs;
+
+            // Fraction of the worker's time spent running jobs, between 0 and 1
+            f64 utilization;
+    };
+
+    /**
+     * @brief Statistics of a thread pool since it was started
+     */
+    struct ThreadPoolStats {
+        public:
+            u32 workerCount;
+
+            // Jobs waiting for a worker, and the most that have ever been waiting at once
+            u32 pendingJobs;
+            u32 peakPendingJobs;
+
+            // Jobs that finished running and are waiting for processCompleted to call afterComplete
+            u32 completedJobs;
+
+            u64 submittedJobCount;
+            u64 finishedJobCount;
+
+            // Time from a job being submitted to a worker starting it
+            f64 meanWaitMs;
+            f64 maxWaitMs;
+
+            // Time spent in IJob::run
+            f64 meanRunMs;
+            f64 maxRunMs;
+
+            // Time from a job finishing to its afterComplete being called
+            f64 meanCompletionDelayMs;
+            f64 maxCompletionDelayMs;
+
+            // Fraction of the workers' time spent running jobs, between 0 and 1
+            f64 utilization;
+
+            Array<ThreadPoolWorkerStats> workers;
+            Array<ThreadPoolJobStats> jobs;
     };
 
     class Worker {
@@ -63,13 +160,39 @@ namespace tspp {
             Worker();
             ~Worker();
 
-            void start(worker_id id, u32 cpuIdx);
+            void start(worker_id id, u32 cpuIdx, bool pinToCpu);
             void run();
+            void recordJob(IJob* job, u64 startedAt, u64 completedAt);
+
+            // Distinct job names tracked per worker, any more are counted together in an extra
+            // slot after these, reported under OtherJobClassName
+            static constexpr u32 MaxJobClasses = 16;
+            static constexpr const char* OtherJobClassName = "(other)";
+
+            struct JobClassCounters {
+                public:
+                    const char* name;
+                    std::atomic<u64> count;
+                    std::atomic<u64> totalRunNs;
+                    std::atomic<u64> maxRunNs;
+            };
 
             worker_id m_id;
             bool m_doStop;
             Thread m_thread;
             ThreadPool* m_pool;
+
+            // Only written by the worker's thread, so they can be read from any thread without locking
+            std::atomic<u64> m_jobCount;
+            std::atomic<u64> m_busyNs;
+            std::atomic<u64> m_idleNs;
+
+            // When the worker started waiting for its current job, 0 while it's running one
+            std::atomic<u64> m_idleStartedAt;
+            std::atomic<u64> m_totalWaitNs;
+            std::atomic<u64> m_maxWaitNs;
+            JobClassCounters m_jobClasses[MaxJobClasses + 1];
+            std::atomic<u32> m_jobClassCount;
     };
 
     class ThreadPool {
@@ -77,12 +200,43 @@ namespace tspp {
             ThreadPool();
             ~ThreadPool();
 
-            void start();
+            /**
+             * @brief Starts the worker threads
+             *
+             * @param workerCount Number of workers, 0 starts one per hardware thread. Workers are only
+             * pinned to a CPU each when there's one per hardware thread.
+             */
+            void start(u32 workerCount = 0);
             void shutdown();
 
             void submitJob(IJob* job);
             void submitJobs(const Array<IJob*>& jobs);
-            bool processCompleted();
+            /**
+             * @brief Runs the completion callbacks of jobs that have finished
+             *
+             * @param eventLoopMonitor Monitor that each completion callback is reported to as an
+             * entry into script, may be null
+             * @return True if any jobs completed or are still pending
+             */
+            bool processCompleted(EventLoopMonitor* eventLoopMonitor = nullptr);
+
+            /**
+             * @brief Sets a function that's called from the worker thread whenever a job completes.
+             * Must be set before the pool is started.
+             */
+            void setCompletionCallback(const std::function<void()>& callback);
+
+            /**
+             * @brief Gets the number of jobs that have been submitted but not picked up by a worker yet
+             */
+            u32 getPendingJobCount();
+
+            /**
+             * @brief Gets the pool's statistics. Doesn't block on the workers or the completion
+             * queue, so it's safe to call from within a job's afterComplete. Must not be called
+             * while the pool is being started or shut down.
+             */
+            ThreadPoolStats getStats();
 
         protected:
             friend class Worker;
@@ -100,6 +254,19 @@ namespace tspp {
             std::mutex m_jobMutex;
             std::mutex m_completedMutex;
             std::condition_variable m_workCondition;
+            std::function<void()> m_onCompleted;
+
+            u32 m_workerCount;
+
+            // Queue statistics, pending counts are written with m_jobMutex held
+            std::atomic<u32> m_peakPendingCount;
+            std::atomic<u32> m_completedCount;
+            std::atomic<u64> m_submittedCount;
+
+            // Only written by the thread that calls processCompleted
+            std::atomic<u64> m_completionDelayCount;
+            std::atomic<u64> m_totalCompletionDelayNs;
+            std::atomic<u64> m_maxCompletionDelayNs;
     };
 
     // TODO
@@ -0,0 +1,101 @@
+#pragma once
+#include <tspp/types.h>
+#include <utils/String.h>
+
+#include <memory>
+
+namespace v8 {
+    class TracingController;
+}
+
+namespace tspp {
+    /**
+     * @brief Records a timeline of runtime phases that can be viewed with chrome://tracing or
+     * Perfetto
+     *
+     * Each thread records fixed size events into its own ring buffer, so recording takes no
+     * locks. Once the buffer is full the oldest events are overwritten. Events from V8 (GC,
+     * compilation, etc.) are recorded through the platform's tracing controller, so a single
+     * trace covers the runtime threads, the thread pool workers and V8's background threads.
+     *
+     * Event categories and names are stored by pointer and must be string literals.
+     */
+    class Trace {
+        public:
+            /**
+             * @brief Records a begin event when constructed and an end event when destroyed
+             */
+            class Scope {
+                public:
+                    Scope(const char* category, const char* name);
+                    ~Scope();
+
+                private:
+                    const char* m_category;
+                    const char* m_name;
+            };
+
+            /**
+             * @brief Starts recording events. Events already recorded are discarded.
+             *
+             * @param v8Categories Comma separated list of V8 trace categories to record, eg.
+             * "v8,disabled-by-default-v8.gc". A category matches if it starts with any of the
+             * listed names. If null or empty, no V8 events are recorded.
+             */
+            static void Start(const char* v8Categories = "v8");
+
+            /**
+             * @brief Stops recording events. Recorded events are kept until the next call to Start.
+             */
+            static void Stop();
+
+            /**
+             * @brief Returns true if events are being recorded
+             */
+            static bool IsEnabled();
+
+            /**
+             * @brief Names the calling thread in the trace. Cheap enough to call for every thread,
+             * the thread's event buffer isn't allocated until it records an event while tracing.
+             *
+             * @param name The name to show for the thread
+             */
+            static void SetThreadName(const String& name);
+
+            /**
+             * @brief Records the start of a slice on the calling thread
+             */
+            static void Begin(const char* category, const char* name);
+
+            /**
+             * @brief Records the end of the most recent slice on the calling thread
+             */
+            static void End(const char* category, const char* name);
+
+            /**
+             * @brief Records a single point in time on the calling thread
+             */
+            static void Instant(const char* category, const char* name);
+
+            /**
+             * @brief Serializes the recorded events in the Chrome trace event format. Events that
+             * are recorded while this runs may be missing or partially written, so tracing should
+             * be stopped first.
+             */
+            static String ToJSON();
+
+            /**
+             * @brief Writes the recorded events to a file in the Chrome trace event format
+             *
+             * @param path The path of the file to write
+             * @return True if the file was written
+             */
+            static bool Write(const String& path);
+
+            /**
+             * @brief Creates the tracing controller that the V8 platform is initialized with,
+             * it forwards V8's trace events to the per-thread buffers
+             */
+            static std::unique_ptr<v8::TracingController> CreateTracingController();
+    };
+}
@@ -0,0 +1,93 @@
+#pragma once
+#include <tspp/types.h>
+#include <tspp/utils/IsolateMonitor.h>
+
+#include <atomic>
+
+namespace tspp {
+    /**
+     * @brief Terminates script execution that runs over a time budget
+     *
+     * Each entry from the host into script is wrapped in a Watchdog::Scope. A separate thread
+     * checks how long the current entry has been running, and once it exceeds the budget an
+     * interrupt is requested on the isolate. The interrupt reports the entry point along with
+     * a sample of the JavaScript stack, then terminates execution. The termination is canceled
+     * once the entry returns, so the runtime stays usable afterwards.
+     */
+    class Watchdog : public IsolateMonitor {
+        public:
+            /**
+             * @brief Marks an entry into script for the duration of its lifetime. Scopes may be
+             * nested, only the outermost one is timed.
+             */
+            class Scope {
+                public:
+                    /**
+                     * @param watchdog The watchdog to report to, may be null
+                     * @param entryPoint Description of the entry point, must outlive the scope
+                     */
+                    Scope(Watchdog* watchdog, const char* entryPoint);
+                    ~Scope();
+
+                private:
+                    Watchdog* m_watchdog;
+            };
+
+            /**
+             * @brief Constructs a new watchdog
+             *
+             * @param config Configuration options for the watchdog
+             */
+            Watchdog(const WatchdogConfig& config);
+
+            /**
+             * @brief Destructor
+             */
+            ~Watchdog();
+
+            /**
+             * @brief Starts the watchdog thread. Must be called on the isolate's thread.
+             *
+             * @param isolate The isolate to watch
+             */
+            void start(v8::Isolate* isolate);
+
+            /**
+             * @brief Stops the watchdog thread
+             */
+            void stop();
+
+            /**
+             * @brief Gets the number of times execution was terminated for running over budget
+             */
+            u32 getTerminationCount() const;
+
+            /**
+             * @brief Gets the watchdog of the runtime that owns an isolate, if it has one
+             */
+            static Watchdog* Get(v8::Isolate* isolate);
+
+        private:
+            void enter(const char* entryPoint);
+            void exit();
+            void check() override;
+            void interrupt(v8::Isolate* isolate) override;
+            u64 getTimeUs() const;
+
+            WatchdogConfig m_config;
+
+            // Handle used to read the isolate thread's CPU time, see Thread::OpenCpuClock
+            u64 m_threadClock;
+
+            // Only accessed on the isolate thread
+            u32 m_depth;
+
+            // Shared with the watchdog thread
+            const char* m_entryPoint;
+            u64 m_enteredAt;
+            bool m_isTerminating;
+            bool m_didInterrupt;
+            u64 m_terminatingAt;
+            std::atomic<u32> m_terminationCount;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,36 @@
+#include "ProcessMemory.h"
+
+#ifdef _WIN32
+    #include <Windows.h>
+    #include <psapi.h>
+#else
+    #include <stdio.h>
+    #include <unistd.h>
+#endif
+
+utils::u64 getResidentSetSize() {
+    #ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return 0;
+    }
+
+    return counters.WorkingSetSize;
+    #else
+    FILE* file = fopen("/proc/self/statm", "r");
+    if (!file) {
+        return 0;
+    }
+
+    unsigned long long totalPages    = 0;
+    unsigned long long residentPages = 0;
+    int count                        = fscanf(file, "%llu %llu", &totalPages, &residentPages);
+    fclose(file);
+
+    if (count != 2) {
+        return 0;
+    }
+
+    return residentPages * utils::u64(sysconf(_SC_PAGESIZE));
+    #endif
+}
@@ -0,0 +1,9 @@
+#pragma once
+#include <utils/types.h>
+
+/**
+ * @brief Gets the resident set size of the current process in bytes, or 0 if it can't be read
+ *
+ * Kept apart from the rest of the harness since it needs platform headers that conflict with tspp's
+ */
+utils::u64 getResidentSetSize();
@@ -0,0 +1,392 @@
+#include "ProcessMemory.h"
+
+#include <tspp/bind.h>
+#include <tspp/tspp.h>
+#include <tspp/utils/Thread.h>
+#include <utils/Array.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace utils;
+using namespace tspp;
+
+/*
+ * Runs a TypeScript workload against a single runtime for a fixed duration and reports how the
+ * event loop holds up under sustained load.
+ *
+ * Usage: tspp_loadtest [--duration <seconds>] [--concurrency <workers>] [--sample-interval <ms>]
+ *                      [--project <dir>] [--out <file>]
+ *
+ * The workload (workload/src/workload.ts by default) is built and required once the bindings
+ * below are committed. It starts `getConcurrency()` async workers that loop until `isRunning()`
+ * returns false, calling `recordOperation()` after each iteration and reporting event loop lag
+ * with `recordLag()`.
+ *
+ * Every sample interval the harness records operations per second, event loop lag percentiles,
+ * thread pool queue depth, GC pause times and resident memory. The samples and a summary of the
+ * whole run are written as JSON to stdout or the --out file, progress is written to stderr.
+ */
+
+#ifndef TSPP_LOADTEST_WORKLOAD_DIR
+    #define TSPP_LOADTEST_WORKLOAD_DIR "workload"
+#endif
+
+// How long to keep servicing the runtime after the run ends, so workers can finish their iteration
+static constexpr u32 DrainTimeoutMs = 5000;
+
+using Clock = std::chrono::steady_clock;
+
+struct LoadTestState {
+    public:
+        bool isRunning;
+        u32 concurrency;
+        u32 finishedWorkers;
+        String scratchDirectory;
+        Clock::time_point startedAt;
+
+        u64 operationCount;
+        std::vector<f64> lagMs;
+        std::vector<f64> gcPauseMs;
+        Clock::time_point gcStartedAt;
+};
+
+static LoadTestState s_state;
+
+struct Sample {
+    public:
+        f64 timeS;
+        f64 operationsPerSecond;
+        f64 lagP50Ms;
+        f64 lagP99Ms;
+        f64 lagMaxMs;
+        u32 queueDepth;
+        u32 gcCount;
+        f64 gcPauseTotalMs;
+        f64 gcPauseMaxMs;
+        u64 residentBytes;
+};
+
+class Payload {
+    public:
+        Payload(u32 size) : m_data(size, 0) {}
+        ~Payload() {}
+
+        void touch() {
+            for (size_t i = 0; i < m_data.size(); i += 64) {
+                m_data[i]++;
+            }
+        }
+
+    private:
+        std::vector<u8> m_data;
+};
+
+u32 getConcurrency() {
+    return s_state.concurrency;
+}
+
+String getScratchDirectory() {
+    return s_state.scratchDirectory;
+}
+
+bool isRunning() {
+    return s_state.isRunning;
+}
+
+f64 now() {
+    return std::chrono::duration<f64, std::milli>(Clock::now() - s_state.startedAt).count();
+}
+
+void recordOperation() {
+    s_state.operationCount++;
+}
+
+void recordLag(f64 lagMs) {
+    s_state.lagMs.push_back(lagMs);
+}
+
+void workerFinished() {
+    s_state.finishedWorkers++;
+}
+
+void bindLoadTest() {
+    bind::Namespace* ns = new bind::Namespace("loadtest");
+    bind::Registry::Add(ns);
+
+    bind::ObjectTypeBuilder<Payload> payload = ns->type<Payload>("Payload");
+    payload.ctor<u32>();
+    payload.dtor();
+    payload.method("touch", &Payload::touch);
+
+    ns->function("getConcurrency", getConcurrency);
+    ns->function("getScratchDirectory", getScratchDirectory);
+    ns->function("isRunning", isRunning);
+    ns->function("now", now);
+    ns->function("recordOperation", recordOperation);
+    ns->function("recordLag", recordLag);
+    ns->function("workerFinished", workerFinished);
+}
+
+static void onGCPrologue(v8::Isolate* isolate, v8::GCType type, v8::GCCallbackFlags flags) {
+    s_state.gcStartedAt = Clock::now();
+}
+
+static void onGCEpilogue(v8::Isolate* isolate, v8::GCType type, v8::GCCallbackFlags flags) {
+    s_state.gcPauseMs.push_back(std::chrono::duration<f64, std::milli>(Clock::now() - s_state.gcStartedAt).count());
+}
+
+static f64 percentile(std::vector<f64>& sorted, f64 p) {
+    if (sorted.empty()) {
+        return 0.0;
+    }
+
+    return sorted[size_t(p * f64(sorted.size() - 1) + 0.5)];
+}
+
+class LoadTestLogger : public IWithLogging {
+    public:
+        LoadTestLogger() : IWithLogging("") {}
+
+    private:
+        // stdout is reserved for results
+        void onWarn(const char* msg) override {
+            if (msg) fprintf(stderr, "%s\n", msg);
+        }
+
+        void onError(const char* msg) override {
+            if (msg) fprintf(stderr, "%s\n", msg);
+        }
+};
+
+int main(i32 argc, const char* argv[]) {
+    u32 durationS        = 30;
+    u32 sampleIntervalMs = 1000;
+    const char* project  = TSPP_LOADTEST_WORKLOAD_DIR;
+    const char* outPath  = nullptr;
+
+    s_state.concurrency = 64;
+
+    for (i32 i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--duration") == 0 && i + 1 < argc) {
+            durationS = u32(atoi(argv[++i]));
+        } else if (strcmp(argv[i], "--concurrency") == 0 && i + 1 < argc) {
+            s_state.concurrency = u32(atoi(argv[++i]));
+        } else if (strcmp(argv[i], "--sample-interval") == 0 && i + 1 < argc) {
+            sampleIntervalMs = u32(atoi(argv[++i]));
+        } else if (strcmp(argv[i], "--project") == 0 && i + 1 < argc) {
+            project = argv[++i];
+        } else if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+            outPath = argv[++i];
+        } else {
+            fprintf(
+                stderr,
+                "Usage: tspp_loadtest [--duration <seconds>] [--concurrency <workers>] [--sample-interval <ms>] "
+                "[--project <dir>] [--out <file>]\n"
+            );
+            return 2;
+        }
+    }
+
+    std::filesystem::path scratch = std::filesystem::path(project) / "internal" / "scratch";
+    std::error_code ec;
+    std::filesystem::create_directories(scratch, ec);
+    s_state.scratchDirectory = scratch.string().c_str();
+
+    bind::Registry::Create();
+
+    Array<Sample> samples;
+    u64 totalOperations = 0;
+    std::vector<f64> allLagMs;
+    std::vector<f64> allGcPauseMs;
+    u64 peakResidentBytes = 0;
+    f64 elapsedS          = 0.0;
+
+    {
+        LoadTestLogger logger;
+
+        RuntimeConfig config;
+        config.scriptRootDirectory = project;
+
+        Runtime runtime(config);
+        runtime.addLogHandler(&logger);
+
+        if (!runtime.initialize()) {
+            return 1;
+        }
+
+        bindLoadTest();
+        runtime.commitBindings();
+
+        if (!runtime.buildProject()) {
+            runtime.shutdown();
+            return 1;
+        }
+
+        v8::Isolate* isolate = runtime.getIsolate();
+        isolate->AddGCPrologueCallback(onGCPrologue);
+        isolate->AddGCEpilogueCallback(onGCEpilogue);
+
+        s_state.isRunning = true;
+        s_state.startedAt = Clock::now();
+
+        {
+            v8::Isolate::Scope isolateScope(isolate);
+            v8::HandleScope scope(isolate);
+            runtime.requireModule("src/workload");
+        }
+
+        Clock::time_point endsAt       = s_state.startedAt + std::chrono::seconds(durationS);
+        Clock::time_point nextSampleAt = s_state.startedAt + std::chrono::milliseconds(sampleIntervalMs);
+        Clock::time_point lastSampleAt = s_state.startedAt;
+
+        while (true) {
+            runtime.service();
+
+            Clock::time_point current = Clock::now();
+            if (current < nextSampleAt && current < endsAt) {
+                continue;
+            }
+
+            f64 intervalS = std::chrono::duration<f64>(current - lastSampleAt).count();
+            lastSampleAt  = current;
+            nextSampleAt  = current + std::chrono::milliseconds(sampleIntervalMs);
+
+            Sample sample              = {};
+            sample.timeS               = std::chrono::duration<f64>(current - s_state.startedAt).count();
+            sample.operationsPerSecond = intervalS > 0.0 ? f64(s_state.operationCount) / intervalS : 0.0;
+            sample.queueDepth          = runtime.getThreadPool()->getPendingJobCount();
+            sample.residentBytes       = getResidentSetSize();
+
+            std::sort(s_state.lagMs.begin(), s_state.lagMs.end());
+            sample.lagP50Ms = percentile(s_state.lagMs, 0.5);
+            sample.lagP99Ms = percentile(s_state.lagMs, 0.99);
+            sample.lagMaxMs = s_state.lagMs.empty() ? 0.0 : s_state.lagMs.back();
+
+            sample.gcCount = u32(s_state.gcPauseMs.size());
+            for (f64 pause : s_state.gcPauseMs) {
+                sample.gcPauseTotalMs += pause;
+                sample.gcPauseMaxMs = std::max(sample.gcPauseMaxMs, pause);
+            }
+
+            fprintf(
+                stderr,
+                "[%6.1fs] %10.1f ops/s | lag p50 %6.2fms p99 %6.2fms max %6.2fms | queue %4u | gc %3u (%6.2fms) | rss "
+                "%6.1fMB\n",
+                sample.timeS,
+                sample.operationsPerSecond,
+                sample.lagP50Ms,
+                sample.lagP99Ms,
+                sample.lagMaxMs,
+                sample.queueDepth,
+                sample.gcCount,
+                sample.gcPauseTotalMs,
+                f64(sample.residentBytes) / (1024.0 * 1024.0)
+            );
+
+            totalOperations += s_state.operationCount;
+            allLagMs.insert(allLagMs.end(), s_state.lagMs.begin(), s_state.lagMs.end());
+            allGcPauseMs.insert(allGcPauseMs.end(), s_state.gcPauseMs.begin(), s_state.gcPauseMs.end());
+            peakResidentBytes = std::max(peakResidentBytes, sample.residentBytes);
+
+            s_state.operationCount = 0;
+            s_state.lagMs.clear();
+            s_state.gcPauseMs.clear();
+            samples.push(sample);
+
+            if (current >= endsAt) {
+                elapsedS = sample.timeS;
+                break;
+            }
+        }
+
+        // Let the workers finish their current iteration
+        s_state.isRunning           = false;
+        Clock::time_point drainEnds = Clock::now() + std::chrono::milliseconds(DrainTimeoutMs);
+        while (s_state.finishedWorkers < s_state.concurrency && Clock::now() < drainEnds) {
+            runtime.service();
+        }
+
+        if (s_state.finishedWorkers < s_state.concurrency) {
+            u32 unfinished = s_state.concurrency - s_state.finishedWorkers;
+            fprintf(stderr, "%u of %u workers did not finish\n", unfinished, s_state.concurrency);
+        }
+
+        isolate->RemoveGCPrologueCallback(onGCPrologue);
+        isolate->RemoveGCEpilogueCallback(onGCEpilogue);
+        runtime.shutdown();
+    }
+
+    std::sort(allLagMs.begin(), allLagMs.end());
+
+    f64 gcPauseTotalMs = 0.0;
+    f64 gcPauseMaxMs   = 0.0;
+    for (f64 pause : allGcPauseMs) {
+        gcPauseTotalMs += pause;
+        gcPauseMaxMs = std::max(gcPauseMaxMs, pause);
+    }
+
+    std::string json = String::Format(
+                           "{\"config\":{\"durationS\":%u,\"concurrency\":%u,\"sampleIntervalMs\":%u},\"samples\":[",
+                           durationS,
+                           s_state.concurrency,
+                           sampleIntervalMs
+    )
+                           .c_str();
+
+    for (u32 i = 0; i < samples.size(); i++) {
+        const Sample& sample = samples[i];
+        json += String::Format(
+                    "%s{\"timeS\":%.3f,\"operationsPerSecond\":%.1f,\"lagP50Ms\":%.3f,\"lagP99Ms\":%.3f,"
+                    "\"lagMaxMs\":%.3f,\"queueDepth\":%u,\"gcCount\":%u,\"gcPauseTotalMs\":%.3f,"
+                    "\"gcPauseMaxMs\":%.3f,\"residentBytes\":%llu}",
+                    i > 0 ? "," : "",
+                    sample.timeS,
+                    sample.operationsPerSecond,
+                    sample.lagP50Ms,
+                    sample.lagP99Ms,
+                    sample.lagMaxMs,
+                    sample.queueDepth,
+                    sample.gcCount,
+                    sample.gcPauseTotalMs,
+                    sample.gcPauseMaxMs,
+                    (unsigned long long)sample.residentBytes
+        )
+                    .c_str();
+    }
+
+    json += String::Format(
+                "],\"summary\":{\"operations\":%llu,\"operationsPerSecond\":%.1f,\"lagP50Ms\":%.3f,\"lagP90Ms\":%.3f,"
+                "\"lagP99Ms\":%.3f,\"lagMaxMs\":%.3f,\"gcCount\":%u,\"gcPauseTotalMs\":%.3f,\"gcPauseMaxMs\":%.3f,"
+                "\"peakResidentBytes\":%llu}}\n",
+                (unsigned long long)totalOperations,
+                elapsedS > 0.0 ? f64(totalOperations) / elapsedS : 0.0,
+                percentile(allLagMs, 0.5),
+                percentile(allLagMs, 0.9),
+                percentile(allLagMs, 0.99),
+                allLagMs.empty() ? 0.0 : allLagMs.back(),
+                u32(allGcPauseMs.size()),
+                gcPauseTotalMs,
+                gcPauseMaxMs,
+                (unsigned long long)peakResidentBytes
+    )
+                .c_str();
+
+    if (outPath) {
+        std::ofstream file(outPath, std::ios::binary);
+        if (!file.is_open()) {
+            fprintf(stderr, "Failed to open '%s' for writing\n", outPath);
+            return 1;
+        }
+
+        file.write(json.c_str(), json.size());
+    } else {
+        fwrite(json.c_str(), 1, json.size(), stdout);
+    }
+
+    return 0;
+}
@@ -0,0 +1,78 @@
+import { readFileText, writeFileText } from '__internal:fs';
+import {
+    Payload,
+    getConcurrency,
+    getScratchDirectory,
+    isRunning,
+    now,
+    recordLag,
+    recordOperation,
+    workerFinished
+} from 'loadtest';
+
+// How often the event loop lag monitor expects to be called
+const LagIntervalMs = 10;
+
+// Number of host objects created and destroyed per operation
+const PayloadChurn = 16;
+
+function makeText(length: number): string {
+    let text = '';
+    while (text.length < length) {
+        text += 'The quick brown fox jumps over the lazy dog. ';
+    }
+
+    return text;
+}
+
+/**
+ * Each operation is a fixed mix of async host calls (run on the thread pool), a timer, a promise
+ * chain and host object churn
+ */
+async function runWorker(id: number) {
+    const path = `${getScratchDirectory()}/worker_${id}.txt`;
+    await writeFileText(path, makeText(4096));
+
+    while (isRunning()) {
+        const text = await readFileText(path);
+        await writeFileText(path, text);
+
+        await new Promise<void>(resolve => setTimeout(resolve, 1));
+
+        const value = await Promise.resolve(id)
+            .then(x => x + 1)
+            .then(x => x * 2)
+            .then(x => x - 1);
+
+        for (let i = 0; i < PayloadChurn; i++) {
+            const payload = new Payload(256 + value);
+            payload.touch();
+            payload.destroy();
+        }
+
+        recordOperation();
+    }
+
+    workerFinished();
+}
+
+// Measures how late a short interval fires, which is how long the event loop was blocked
+function monitorLag() {
+    let expectedAt = now() + LagIntervalMs;
+
+    const timer = setInterval(() => {
+        const current = now();
+        recordLag(Math.max(0, current - expectedAt));
+        expectedAt = current + LagIntervalMs;
+
+        if (!isRunning()) {
+            clearInterval(timer);
+        }
+    }, LagIntervalMs);
+}
+
+monitorLag();
+
+for (let i = 0; i < getConcurrency(); i++) {
+    runWorker(i);
+}
@@ -0,0 +1,258 @@
+#include <tspp/bind.h>
+#include <tspp/builtin/compiler_host.h>
+#include <tspp/utils/Docs.h>
+#include <utils/Array.hpp>
+#include <utils/Exception.h>
+
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <unordered_map>
+
+using namespace bind;
+
+namespace tspp::builtin::compiler_host {
+    struct CachedStatus {
+        bool exists;
+        bool isDirectory;
+        u64 modifiedOn;
+        u64 size;
+    };
+
+    struct CachedDirectory {
+        Array<String> directories;
+    };
+
+    struct CachedSource {
+        u64 modifiedOn;
+        u64 size;
+        String text;
+    };
+
+    /*
+     * Status, real path and directory caches only live for the duration of a single
+     * build. Sources live for as long as the process does.
+     */
+    static std::mutex s_cacheMutex;
+    static std::unordered_map<String, CachedStatus> s_statusCache;
+    static std::unordered_map<String, String> s_realPathCache;
+    static std::unordered_map<String, CachedDirectory> s_directoryCache;
+    static std::unordered_map<String, CachedSource> s_sourceCache;
+
+    const CachedStatus& getStatus(const String& path) {
+        auto it = s_statusCache.find(path);
+        if (it != s_statusCache.end()) {
+            return it->second;
+        }
+
+        CachedStatus s = {false, false, 0, 0};
+
+        std::error_code ec;
+        std::filesystem::file_status status = std::filesystem::status(path.c_str(), ec);
+        if (!ec && std::filesystem::exists(status)) {
+            s.exists      = true;
+            s.isDirectory = std::filesystem::is_directory(status);
+
+            if (!s.isDirectory) {
+                s.modifiedOn = std::filesystem::last_write_time(path.c_str(), ec).time_since_epoch().count();
+                s.size       = std::filesystem::file_size(path.c_str(), ec);
+            }
+        }
+
+        return s_statusCache[path] = s;
+    }
+
+    void beginBuild() {
+        std::lock_guard<std::mutex> lock(s_cacheMutex);
+        s_statusCache.clear();
+        s_realPathCache.clear();
+        s_directoryCache.clear();
+    }
+
+    bool fileExists(const String& path) {
+        std::lock_guard<std::mutex> lock(s_cacheMutex);
+        const CachedStatus& s = getStatus(path);
+        return s.exists && !s.isDirectory;
+    }
+
+    bool directoryExists(const String& path) {
+        std::lock_guard<std::mutex> lock(s_cacheMutex);
+        const CachedStatus& s = getStatus(path);
+        return s.exists && s.isDirectory;
+    }
+
+    String realPathUnlocked(const String& path) {
+        auto it = s_realPathCache.find(path);
+        if (it != s_realPathCache.end()) {
+            return it->second;
+        }
+
+        std::error_code ec;
+        std::filesystem::path canonical = std::filesystem::canonical(path.c_str(), ec);
+
+        // Paths that can't be resolved are returned as-is, the same as TypeScript's own host does
+        String result = ec ? path : String(canonical.string());
+        s_realPathCache[path] = result;
+
+        return result;
+    }
+
+    String realPath(const String& path) {
+        std::lock_guard<std::mutex> lock(s_cacheMutex);
+        return realPathUnlocked(path);
+    }
+
+    String getCanonicalFileName(const String& path) {
+        std::lock_guard<std::mutex> lock(s_cacheMutex);
+        if (getStatus(path).exists) {
+            return realPathUnlocked(path);
+        }
+
+        return std::filesystem::path(path.c_str()).lexically_normal().string();
+    }
+
+    Array<String> getDirectories(const String& path) {
+        std::lock_guard<std::mutex> lock(s_cacheMutex);
+
+        auto it = s_directoryCache.find(path);
+        if (it != s_directoryCache.end()) {
+            return it->second.directories;
+        }
+
+        CachedDirectory& dir = s_directoryCache[path];
+
+        std::error_code ec;
+        for (const auto& entry : std::filesystem::directory_iterator(path.c_str(), ec)) {
+            if (entry.is_directory(ec)) {
+                dir.directories.push(entry.path().filename().string());
+            }
+        }
+
+        return dir.directories;
+    }
+
+    String getFileVersion(const String& path) {
+        std::lock_guard<std::mutex> lock(s_cacheMutex);
+        const CachedStatus& s = getStatus(path);
+        if (!s.exists || s.isDirectory) {
+            return String();
+        }
+
+        return String::Format("%llu:%llu", (unsigned long long)s.modifiedOn, (unsigned long long)s.size);
+    }
+
+    String readFile(const String& path) {
+        std::lock_guard<std::mutex> lock(s_cacheMutex);
+        const CachedStatus& s = getStatus(path);
+        if (!s.exists || s.isDirectory) {
+            throw FileException("File not found");
+        }
+
+        auto it = s_sourceCache.find(path);
+        if (it != s_sourceCache.end() && it->second.modifiedOn == s.modifiedOn && it->second.size == s.size) {
+            return it->second.text;
+        }
+
+        std::ifstream file(path.c_str(), std::ios::in | std::ios::binary);
+        if (!file.is_open()) {
+            throw FileException("File not found");
+        }
+
+        String text;
+        if (s.size > 0) {
+            std::string contents((size_t)s.size, '\0');
+            file.read(contents.data(), contents.size());
+            contents.resize((size_t)file.gcount());
+            text = contents;
+        }
+
+        s_sourceCache[path] = CachedSource{s.modifiedOn, s.size, text};
+        return text;
+    }
+
+    void writeFile(const String& path, const String& text) {
+        std::lock_guard<std::mutex> lock(s_cacheMutex);
+
+        try {
+            std::filesystem::path parent = std::filesystem::path(path.c_str()).parent_path();
+            if (!parent.empty()) {
+                std::filesystem::create_directories(parent);
+            }
+
+            std::ofstream file(path.c_str(), std::ios::out | std::ios::binary);
+            file.write(text.c_str(), text.size());
+        } catch (const std::exception& e) {
+            throw FileException(e.what());
+        }
+
+        s_statusCache.erase(path);
+        s_realPathCache.erase(path);
+        s_sourceCache.erase(path);
+
+        // Writing may also have created any of the file's ancestors, which then show up in their
+        // own parent's listing. Paths are in the same form that the compiler passed them in, so
+        // these are the keys it would have used to look them up.
+        std::filesystem::path ancestor = std::filesystem::path(path.c_str()).parent_path();
+        while (!ancestor.empty()) {
+            String key = ancestor.string();
+            s_statusCache.erase(key);
+            s_realPathCache.erase(key);
+            s_directoryCache.erase(key);
+
+            std::filesystem::path parent = ancestor.parent_path();
+            if (parent == ancestor) {
+                break;
+            }
+
+            ancestor = parent;
+        }
+    }
+
+    void init() {
+        Namespace* ns = new Namespace("__internal:compiler_host");
+        Registry::Add(ns);
+
+        describe(ns->function("beginBuild", beginBuild))
+            .desc("Discards the cached file system state gathered during the previous build");
+
+        describe(ns->function("fileExists", fileExists))
+            .desc("Checks if a regular file exists, the result is cached until the next build begins")
+            .param(0, "path", "The path to check")
+            .returns("true if the file exists, false otherwise", false);
+
+        describe(ns->function("directoryExists", directoryExists))
+            .desc("Checks if a directory exists, the result is cached until the next build begins")
+            .param(0, "path", "The path to check")
+            .returns("true if the directory exists, false otherwise", false);
+
+        describe(ns->function("realPath", realPath))
+            .desc("Gets the canonical pathname of a file or directory, or the path itself if it can't be resolved")
+            .param(0, "path", "The path to resolve")
+            .returns("The canonical pathname", false);
+
+        describe(ns->function("getCanonicalFileName", getCanonicalFileName))
+            .desc("Gets the canonical pathname of a file if it exists, or the normalized path if it doesn't")
+            .param(0, "path", "The path to resolve")
+            .returns("The canonical file name", false);
+
+        describe(ns->function("getDirectories", getDirectories))
+            .desc("Gets the names of the subdirectories of a directory")
+            .param(0, "path", "The path of the directory")
+            .returns("The names of the subdirectories", false);
+
+        describe(ns->function("getFileVersion", getFileVersion))
+            .desc("Gets a string that changes whenever the file's modification time or size changes")
+            .param(0, "path", "The path of the file")
+            .returns("The version of the file, or an empty string if it doesn't exist", false);
+
+        describe(ns->function("readFile", readFile))
+            .desc("Reads a file as a UTF-8 string, reusing the previously read text if the file has not changed")
+            .param(0, "path", "The path to read")
+            .returns("The contents of the file as a UTF-8 string", false);
+
+        describe(ns->function("writeFile", writeFile))
+            .desc("Writes a UTF-8 string to a file, creating any missing parent directories")
+            .param(0, "path", "The path to write to")
+            .param(1, "text", "The UTF-8 string to write");
+    }
+}
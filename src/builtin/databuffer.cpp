@@ -1,6 +1,8 @@
 #include <tspp/bind.h>
 #include <tspp/builtin/databuffer.h>
 #include <tspp/marshalling/DataBufferMarshaller.h>
+#include <tspp/marshalling/SharedDataBufferMarshaller.h>
+#include <tspp/modules/AtomicsModule.h>
 #include <tspp/utils/Docs.h>
 using namespace bind;
 
@@ -39,6 +41,56 @@ namespace tspp::builtin::databuffer {
         return m_size;
     }
 
+    static void deleteAllocation(void* data, size_t size, void* deleterData) {
+        delete[] (u8*)data;
+    }
+
+    SharedDataBuffer::SharedDataBuffer(u64 size) {
+        // Always allocate, V8 doesn't accept a null pointer for the backing store
+        u8* data = new u8[size]();
+        m_backingStore = v8::SharedArrayBuffer::NewBackingStore(data, size, deleteAllocation, nullptr);
+    }
+
+    SharedDataBuffer::SharedDataBuffer(void* data, u64 size, Deleter deleter, void* deleterData) {
+        m_backingStore = v8::SharedArrayBuffer::NewBackingStore(data, size, deleter, deleterData);
+    }
+
+    SharedDataBuffer::SharedDataBuffer(const std::shared_ptr<v8::BackingStore>& backingStore) {
+        m_backingStore = backingStore;
+    }
+
+    SharedDataBuffer::SharedDataBuffer(const SharedDataBuffer& other) {
+        m_backingStore = other.m_backingStore;
+    }
+
+    SharedDataBuffer::~SharedDataBuffer() {
+        m_backingStore.reset();
+    }
+
+    u8* SharedDataBuffer::data() const {
+        return (u8*)m_backingStore->Data();
+    }
+
+    u64 SharedDataBuffer::size() const {
+        return m_backingStore->ByteLength();
+    }
+
+    std::span<u8> SharedDataBuffer::span() const {
+        return std::span<u8>(data(), size());
+    }
+
+    const std::shared_ptr<v8::BackingStore>& SharedDataBuffer::getBackingStore() const {
+        return m_backingStore;
+    }
+
+    u32 SharedDataBuffer::notify(u64 byteOffset, u32 count) const {
+        if (byteOffset + sizeof(i32) > size()) {
+            return 0;
+        }
+
+        return AtomicsModule::Notify(data() + byteOffset, count);
+    }
+
     String decodeUTF8(const DataBuffer& buffer) {
         u64 sz = buffer.size();
         if (sz == 0) {
@@ -73,6 +125,21 @@ namespace tspp::builtin::databuffer {
         userData.typescriptType    = "ArrayBuffer";
         userData.marshaller        = new DataBufferMarshaller(type);
 
+        ObjectTypeBuilder<SharedDataBuffer> sharedBuilder = ns->type<SharedDataBuffer>("SharedDataBuffer");
+        describe(sharedBuilder.ctor<u64>())
+            .desc("Creates a new zero-initialized SharedDataBuffer with the specified size")
+            .param(0, "size", "The size of the SharedDataBuffer");
+        describe(sharedBuilder.ctor<const SharedDataBuffer&>())
+            .desc("Creates a new SharedDataBuffer that refers to the same memory as another SharedDataBuffer")
+            .param(0, "buffer", "The SharedDataBuffer to refer to");
+
+        sharedBuilder.dtor();
+
+        DataType* sharedType             = sharedBuilder.getType();
+        DataTypeUserData& sharedUserData = sharedType->getUserData<DataTypeUserData>();
+        sharedUserData.typescriptType    = "SharedArrayBuffer";
+        sharedUserData.marshaller        = new SharedDataBufferMarshaller(sharedType);
+
         describe(ns->function("decodeUTF8", decodeUTF8))
             .desc("Decodes an ArrayBuffer as a UTF-8 string")
             .param(0, "buffer", "The ArrayBuffer to decode")
@@ -1,11 +1,21 @@
 #include <tspp/bind.h>
 #include <tspp/builtin/databuffer.h>
 #include <tspp/builtin/fs.h>
+#include <tspp/tspp.h>
 #include <tspp/utils/Docs.h>
+#include <tspp/utils/GlobPattern.h>
+#include <tspp/utils/Thread.h>
 #include <utils/Array.hpp>
 
+#include <condition_variable>
 #include <filesystem>
 #include <fstream>
+#include <mutex>
+
+#ifndef _WIN32
+#include <dirent.h>
+#include <sys/stat.h>
+#endif
 
 using namespace bind;
 
@@ -198,6 +208,287 @@ namespace tspp::builtin::fs {
         return std::filesystem::create_directory(path.c_str());
     }
 
+    /*
+     * Directory walking
+     */
+
+    struct WalkFilter {
+        Array<String> extensions;
+        Array<GlobPattern> include;
+        Array<GlobPattern> exclude;
+        i32 maxDepth;
+    };
+
+    struct WalkEntry {
+        std::string name;
+        bool isDirectory;
+    };
+
+    void listDirectory(const std::string& path, Array<WalkEntry>& entries) {
+#ifndef _WIN32
+        // readdir is backed by getdents64, d_type lets us skip a stat call for almost every entry
+        DIR* dir = opendir(path.size() > 0 ? path.c_str() : ".");
+        if (!dir) {
+            return;
+        }
+
+        while (dirent* entry = readdir(dir)) {
+            if (entry->d_name[0] == '.' && (entry->d_name[1] == 0 || (entry->d_name[1] == '.' && entry->d_name[2] == 0))) {
+                continue;
+            }
+
+            bool isDirectory = entry->d_type == DT_DIR;
+            bool isFile      = entry->d_type == DT_REG;
+
+            if (entry->d_type == DT_UNKNOWN || entry->d_type == DT_LNK) {
+                std::string full = path.size() > 0 ? path + "/" + entry->d_name : std::string(entry->d_name);
+                struct stat st;
+                if (::stat(full.c_str(), &st) != 0) {
+                    continue;
+                }
+
+                isDirectory = S_ISDIR(st.st_mode);
+                isFile      = S_ISREG(st.st_mode);
+            }
+
+            if (isDirectory || isFile) {
+                entries.push(WalkEntry{entry->d_name, isDirectory});
+            }
+        }
+
+        closedir(dir);
+#else
+        std::error_code ec;
+        for (const auto& entry : std::filesystem::directory_iterator(path.size() > 0 ? path : ".", ec)) {
+            bool isDirectory = entry.is_directory(ec);
+            if (isDirectory || entry.is_regular_file(ec)) {
+                entries.push(WalkEntry{entry.path().filename().string(), isDirectory});
+            }
+        }
+#endif
+    }
+
+    bool matchesFile(const WalkFilter& filter, const std::string& name, const Array<std::string>& relative) {
+        if (filter.extensions.size() > 0) {
+            bool found = false;
+            for (const String& ext : filter.extensions) {
+                if (name.size() >= ext.size() && name.compare(name.size() - ext.size(), ext.size(), ext.c_str()) == 0) {
+                    found = true;
+                    break;
+                }
+            }
+
+            if (!found) {
+                return false;
+            }
+        }
+
+        if (filter.include.size() > 0) {
+            bool found = false;
+            for (const GlobPattern& pattern : filter.include) {
+                if (pattern.matches(relative)) {
+                    found = true;
+                    break;
+                }
+            }
+
+            if (!found) {
+                return false;
+            }
+        }
+
+        for (const GlobPattern& pattern : filter.exclude) {
+            if (pattern.matches(relative)) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    void walk(
+        const WalkFilter& filter,
+        const std::string& path,
+        Array<std::string>& relative,
+        i32 depth,
+        Array<String>& results
+    ) {
+        Array<WalkEntry> entries;
+        listDirectory(path, entries);
+
+        std::string prefix = path.size() == 0 || path.back() == '/' ? path : path + "/";
+
+        for (const WalkEntry& entry : entries) {
+            if (entry.isDirectory) {
+                continue;
+            }
+
+            relative.push(entry.name);
+            if (matchesFile(filter, entry.name, relative)) {
+                results.push(prefix + entry.name);
+            }
+            relative.pop();
+        }
+
+        if (filter.maxDepth >= 0 && depth >= filter.maxDepth) {
+            return;
+        }
+
+        for (const WalkEntry& entry : entries) {
+            if (!entry.isDirectory) {
+                continue;
+            }
+
+            relative.push(entry.name);
+
+            bool excluded = false;
+            for (const GlobPattern& pattern : filter.exclude) {
+                if (pattern.matchesDirectory(relative)) {
+                    excluded = true;
+                    break;
+                }
+            }
+
+            if (!excluded) {
+                walk(filter, prefix + entry.name, relative, depth + 1, results);
+            }
+
+            relative.pop();
+        }
+    }
+
+    class WalkJob : public IJob {
+        public:
+            struct SharedState {
+                std::mutex mutex;
+                std::condition_variable condition;
+                u32 remaining;
+            };
+
+            WalkJob(const WalkFilter* filter, SharedState* state, const std::string& path, const std::string& name)
+                : m_filter(filter), m_state(state), m_path(path), m_name(name) {}
+
+            void run() override {
+                Array<std::string> relative;
+                relative.push(m_name);
+                walk(*m_filter, m_path, relative, 2, results);
+
+                // The state lives on the stack of the thread waiting for this job, it must not be
+                // touched after this point
+                std::lock_guard<std::mutex> lock(m_state->mutex);
+                m_state->remaining--;
+                m_state->condition.notify_all();
+            }
+
+            void afterComplete() override {}
+
+            const char* getName() const override {
+                return "fs walk";
+            }
+
+            Array<String> results;
+
+        private:
+            const WalkFilter* m_filter;
+            SharedState* m_state;
+            std::string m_path;
+            std::string m_name;
+    };
+
+    Array<String> walkDirectory(
+        const String& root,
+        const Array<String>& extensions,
+        const Array<String>& include,
+        const Array<String>& exclude,
+        i32 depth
+    ) {
+        WalkFilter filter;
+        filter.extensions = extensions;
+        filter.maxDepth   = depth;
+
+        for (const String& pattern : include) {
+            filter.include.push(GlobPattern(pattern));
+        }
+
+        for (const String& pattern : exclude) {
+            filter.exclude.push(GlobPattern(pattern));
+        }
+
+        Array<String> results;
+        Array<std::string> relative;
+
+        v8::Isolate* isolate = v8::Isolate::TryGetCurrent();
+        Runtime* runtime     = Runtime::Get(isolate);
+
+        if (!runtime || (depth >= 0 && depth <= 1)) {
+            // Not on the isolate thread (or nothing to parallelize), walk on this thread
+            walk(filter, root, relative, 1, results);
+            return results;
+        }
+
+        // Walk the files in the root directory here, and each top level subdirectory on a worker.
+        // The jobs are owned by the thread pool and will be deleted after they're processed.
+        WalkFilter rootFilter = filter;
+        rootFilter.maxDepth   = 1;
+        walk(rootFilter, root, relative, 1, results);
+
+        Array<WalkEntry> entries;
+        std::string rootPath = root;
+        listDirectory(rootPath, entries);
+
+        std::string prefix = rootPath.size() == 0 || rootPath.back() == '/' ? rootPath : rootPath + "/";
+
+        WalkJob::SharedState state;
+        state.remaining = 0;
+
+        Array<WalkJob*> jobs;
+        for (const WalkEntry& entry : entries) {
+            if (!entry.isDirectory) {
+                continue;
+            }
+
+            relative.push(entry.name);
+
+            bool excluded = false;
+            for (const GlobPattern& pattern : filter.exclude) {
+                if (pattern.matchesDirectory(relative)) {
+                    excluded = true;
+                    break;
+                }
+            }
+
+            relative.pop();
+
+            if (!excluded) {
+                jobs.push(new WalkJob(&filter, &state, prefix + entry.name, entry.name));
+            }
+        }
+
+        if (jobs.size() == 0) {
+            return results;
+        }
+
+        state.remaining = jobs.size();
+
+        Array<IJob*> submit;
+        for (WalkJob* job : jobs) {
+            submit.push(job);
+        }
+
+        runtime->submitJobs(submit);
+
+        {
+            std::unique_lock<std::mutex> lock(state.mutex);
+            state.condition.wait(lock, [&state] { return state.remaining == 0; });
+        }
+
+        for (WalkJob* job : jobs) {
+            results.append(job->results);
+        }
+
+        return results;
+    }
+
     /*
      * Bindings
      */
@@ -368,6 +659,25 @@ namespace tspp::builtin::fs {
             .returns("An array of DirEntry objects", false)
             .async();
 
+        describe(ns->function("walkDirectorySync", walkDirectory))
+            .desc("Synchronously finds the files beneath a directory that match the given filters")
+            .param(0, "root", "The directory to walk")
+            .param(1, "extensions", "File extensions to include, all files are included if empty")
+            .param(2, "include", "Glob patterns relative to the root that files must match, all files are included if empty")
+            .param(3, "exclude", "Glob patterns relative to the root that files and directories must not match")
+            .param(4, "depth", "The maximum depth to walk, or -1 to walk the whole tree")
+            .returns("The paths of the matching files, prefixed with the root directory", false);
+
+        describe(ns->function("walkDirectory", walkDirectory))
+            .desc("Asynchronously finds the files beneath a directory that match the given filters")
+            .param(0, "root", "The directory to walk")
+            .param(1, "extensions", "File extensions to include, all files are included if empty")
+            .param(2, "include", "Glob patterns relative to the root that files must match, all files are included if empty")
+            .param(3, "exclude", "Glob patterns relative to the root that files and directories must not match")
+            .param(4, "depth", "The maximum depth to walk, or -1 to walk the whole tree")
+            .returns("The paths of the matching files, prefixed with the root directory", false)
+            .async();
+
         describe(ns->function("readFileSync", readFile))
             .desc("Synchronously reads the contents of a file")
             .param(0, "path", "The path to read")
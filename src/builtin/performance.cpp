@@ -0,0 +1,120 @@
+#include <tspp/bind.h>
+#include <tspp/builtin/performance.h>
+#include <tspp/utils/Docs.h>
+#include <tspp/utils/EventLoopMonitor.h>
+
+#include <chrono>
+
+#include <v8.h>
+
+using namespace bind;
+
+namespace tspp::builtin::performance {
+    static std::chrono::steady_clock::time_point s_timeOrigin;
+
+    EventLoopMonitor* getMonitor() {
+        return EventLoopMonitor::Get(v8::Isolate::GetCurrent());
+    }
+
+    f64 now() {
+        return std::chrono::duration<f64, std::milli>(std::chrono::steady_clock::now() - s_timeOrigin).count();
+    }
+
+    EventLoopStats eventLoopStats() {
+        EventLoopMonitor* monitor = getMonitor();
+        if (!monitor) {
+            return EventLoopStats{};
+        }
+
+        return monitor->getStats();
+    }
+
+    Array<LongTask> longTasks() {
+        EventLoopMonitor* monitor = getMonitor();
+        if (!monitor) {
+            return Array<LongTask>();
+        }
+
+        return monitor->getLongTasks();
+    }
+
+    bool resetEventLoopStats() {
+        EventLoopMonitor* monitor = getMonitor();
+        if (!monitor) {
+            return false;
+        }
+
+        monitor->reset();
+        return true;
+    }
+
+    void bindEventLoopStats(Namespace* ns) {
+        ObjectTypeBuilder<EventLoopStats> builder = ns->type<EventLoopStats>("EventLoopStats");
+        builder.prop("iterationCount", &EventLoopStats::iterationCount);
+        builder.prop("iterationMeanMs", &EventLoopStats::iterationMeanMs);
+        builder.prop("iterationMaxMs", &EventLoopStats::iterationMaxMs);
+        builder.prop("lagSampleCount", &EventLoopStats::lagSampleCount);
+        builder.prop("lagMeanMs", &EventLoopStats::lagMeanMs);
+        builder.prop("lagP50Ms", &EventLoopStats::lagP50Ms);
+        builder.prop("lagP90Ms", &EventLoopStats::lagP90Ms);
+        builder.prop("lagP99Ms", &EventLoopStats::lagP99Ms);
+        builder.prop("lagMaxMs", &EventLoopStats::lagMaxMs);
+        builder.prop("longTaskCount", &EventLoopStats::longTaskCount);
+        builder.getMeta().is_trivially_constructible = 1;
+
+        describe(builder.getType())
+            .desc("Summary of the event loop's responsiveness since the monitor was started or reset")
+            .property("iterationCount", "The number of times the runtime was serviced")
+            .property("iterationMeanMs", "The mean time it took to service the runtime, in milliseconds")
+            .property("iterationMaxMs", "The longest time it took to service the runtime, in milliseconds")
+            .property("lagSampleCount", "The number of timers that fired")
+            .property("lagMeanMs", "The mean delay between when timers were due and when they fired")
+            .property("lagP50Ms", "The median timer delay, in milliseconds")
+            .property("lagP90Ms", "The 90th percentile timer delay, in milliseconds")
+            .property("lagP99Ms", "The 99th percentile timer delay, in milliseconds")
+            .property("lagMaxMs", "The longest timer delay, in milliseconds")
+            .property("longTaskCount", "The number of long tasks detected, including discarded ones");
+    }
+
+    void bindLongTask(Namespace* ns) {
+        ObjectTypeBuilder<LongTask> builder = ns->type<LongTask>("LongTask");
+        builder.prop("entryPoint", &LongTask::entryPoint);
+        builder.prop("startedAtMs", &LongTask::startedAtMs);
+        builder.prop("durationMs", &LongTask::durationMs);
+        builder.prop("stack", &LongTask::stack);
+
+        describe(builder.getType())
+            .desc("An entry into script that blocked the event loop for longer than the long task threshold")
+            .property("entryPoint", "What the runtime was doing when it entered script, e.g. 'timer callback'")
+            .property("startedAtMs", "When the task began, in milliseconds since the monitor was started")
+            .property("durationMs", "How long the task ran for, in milliseconds")
+            .property("stack", "The JavaScript stack sampled while the task was running, if it was sampled");
+    }
+
+    void init() {
+        s_timeOrigin = std::chrono::steady_clock::now();
+
+        Namespace* ns = new Namespace("performance");
+        Registry::Add(ns);
+
+        bindEventLoopStats(ns);
+        bindLongTask(ns);
+
+        describe(ns->function("now", now))
+            .desc("Gets a high resolution timestamp")
+            .returns("The number of milliseconds since the runtime was first initialized", false);
+
+        describe(ns->function("eventLoopStats", eventLoopStats))
+            .desc("Gets a summary of the event loop's responsiveness. All values are zero unless the event loop "
+                  "monitor is enabled")
+            .returns("The event loop statistics", false);
+
+        describe(ns->function("longTasks", longTasks))
+            .desc("Gets the most recent entries into script that blocked the event loop, oldest first")
+            .returns("The long tasks, empty unless the event loop monitor is enabled", false);
+
+        describe(ns->function("resetEventLoopStats", resetEventLoopStats))
+            .desc("Discards the event loop statistics and long tasks recorded so far")
+            .returns("true if the event loop monitor is enabled", false);
+    }
+}
@@ -0,0 +1,138 @@
+#include <tspp/bind.h>
+#include <tspp/builtin/profiler.h>
+#include <tspp/tspp.h>
+#include <tspp/utils/CpuProfiler.h>
+#include <tspp/utils/Docs.h>
+#include <tspp/utils/HeapProfiler.h>
+#include <tspp/utils/ProfileOutput.h>
+
+#include <v8.h>
+
+using namespace bind;
+
+namespace tspp::builtin::profiler {
+    CpuProfiler* getProfiler() {
+        Runtime* runtime = Runtime::Get(v8::Isolate::GetCurrent());
+        if (!runtime) {
+            return nullptr;
+        }
+
+        return runtime->getCpuProfiler();
+    }
+
+    bool start(const String& name, u32 samplingIntervalUs, u32 durationMs) {
+        CpuProfiler* profiler = getProfiler();
+        if (!profiler) {
+            return false;
+        }
+
+        return profiler->start(name, samplingIntervalUs, durationMs);
+    }
+
+    bool stop() {
+        CpuProfiler* profiler = getProfiler();
+        if (!profiler) {
+            return false;
+        }
+
+        return profiler->stop();
+    }
+
+    bool isProfiling() {
+        CpuProfiler* profiler = getProfiler();
+        if (!profiler) {
+            return false;
+        }
+
+        return profiler->isProfiling();
+    }
+
+    HeapProfiler* getHeapProfiler() {
+        Runtime* runtime = Runtime::Get(v8::Isolate::GetCurrent());
+        if (!runtime) {
+            return nullptr;
+        }
+
+        return runtime->getHeapProfiler();
+    }
+
+    bool takeHeapSnapshot(const String& path) {
+        HeapProfiler* profiler = getHeapProfiler();
+        if (!profiler) {
+            return false;
+        }
+
+        // Scripts must not be able to write outside the output directory
+        if (!isPlainFileName(path)) {
+            profiler->error(
+                "Can't write heap snapshot to '%s', the path must be a file name without a directory", path.c_str()
+            );
+            return false;
+        }
+
+        return profiler->takeHeapSnapshot(path);
+    }
+
+    bool startSamplingHeapProfile(u32 samplingIntervalBytes, u32 stackDepth) {
+        HeapProfiler* profiler = getHeapProfiler();
+        if (!profiler) {
+            return false;
+        }
+
+        return profiler->startSamplingHeapProfile(samplingIntervalBytes, stackDepth);
+    }
+
+    bool stopSamplingHeapProfile(const String& path) {
+        HeapProfiler* profiler = getHeapProfiler();
+        if (!profiler) {
+            return false;
+        }
+
+        // Checked before stopping, so that sampling can still be stopped with a valid name
+        if (!isPlainFileName(path)) {
+            profiler->error(
+                "Can't write sampling heap profile to '%s', the path must be a file name without a directory",
+                path.c_str()
+            );
+            return false;
+        }
+
+        return profiler->stopSamplingHeapProfile(path);
+    }
+
+    void init() {
+        Namespace* ns = new Namespace("profiler");
+        Registry::Add(ns);
+
+        describe(ns->function("start", start))
+            .desc("Starts recording a CPU profile of the current runtime")
+            .param(0, "name", "The name of the profile, it's written to <name>.cpuprofile in the output directory")
+            .param(1, "samplingIntervalUs", "How often the stack is sampled, in microseconds")
+            .param(2, "durationMs", "If non-zero, the profile is stopped and written after this many milliseconds")
+            .returns("true if the profile was started, false if a profile is already being recorded", false);
+
+        describe(ns->function("stop", stop))
+            .desc("Stops recording the current CPU profile and writes it as a .cpuprofile file")
+            .returns("true if the profile was written", false);
+
+        describe(ns->function("isProfiling", isProfiling))
+            .desc("Checks if a CPU profile is being recorded")
+            .returns("true if a profile is being recorded", false);
+
+        describe(ns->function("takeHeapSnapshot", takeHeapSnapshot))
+            .desc("Takes a heap snapshot of the current runtime and writes it as a .heapsnapshot file")
+            .param(0, "path", "Name of the file to write the snapshot to in the output directory")
+            .returns("true if the snapshot was written", false);
+
+        describe(ns->function("startSamplingHeapProfile", startSamplingHeapProfile))
+            .desc("Starts sampling allocations made by the current runtime")
+            .param(0, "samplingIntervalBytes", "Average number of bytes allocated between samples")
+            .param(1, "stackDepth", "Maximum number of stack frames recorded for each sample")
+            .returns("true if sampling was started, false if allocations are already being sampled", false);
+
+        describe(ns->function("stopSamplingHeapProfile", stopSamplingHeapProfile))
+            .desc("Stops sampling allocations and writes the stacks of live sampled objects as a .heapprofile file")
+            .param(0, "path", "Name of the file to write the profile to in the output directory")
+            .returns("true if the profile was written", false);
+    }
+}
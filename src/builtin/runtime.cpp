@@ -0,0 +1,214 @@
+#include <tspp/bind.h>
+#include <tspp/builtin/runtime.h>
+#include <tspp/tspp.h>
+#include <tspp/utils/Docs.h>
+
+#include <v8.h>
+
+using namespace bind;
+
+namespace tspp::builtin::runtime {
+    RuntimeStats stats() {
+        Runtime* runtime = Runtime::Get(v8::Isolate::GetCurrent());
+        if (!runtime) {
+            return RuntimeStats{};
+        }
+
+        return runtime->getStats();
+    }
+
+    void bindHeapSpaceStats(Namespace* ns) {
+        ObjectTypeBuilder<HeapSpaceStats> builder = ns->type<HeapSpaceStats>("HeapSpaceStats");
+        builder.prop("name", &HeapSpaceStats::name);
+        builder.prop("size", &HeapSpaceStats::size);
+        builder.prop("used", &HeapSpaceStats::used);
+        builder.prop("available", &HeapSpaceStats::available);
+        builder.prop("physicalSize", &HeapSpaceStats::physicalSize);
+
+        describe(builder.getType())
+            .desc("Size of one of the spaces that the heap is divided into")
+            .property("name", "The name of the space")
+            .property("size", "The size of the space in bytes")
+            .property("used", "The number of bytes in use")
+            .property("available", "The number of bytes available")
+            .property("physicalSize", "The number of bytes committed in physical memory");
+    }
+
+    void bindHeapStats(Namespace* ns) {
+        ObjectTypeBuilder<HeapStats> builder = ns->type<HeapStats>("HeapStats");
+        builder.prop("totalHeapSize", &HeapStats::totalHeapSize);
+        builder.prop("usedHeapSize", &HeapStats::usedHeapSize);
+        builder.prop("heapSizeLimit", &HeapStats::heapSizeLimit);
+        builder.prop("totalPhysicalSize", &HeapStats::totalPhysicalSize);
+        builder.prop("mallocedMemory", &HeapStats::mallocedMemory);
+        builder.prop("externalMemory", &HeapStats::externalMemory);
+        builder.prop("nativeContexts", &HeapStats::nativeContexts);
+        builder.prop("detachedContexts", &HeapStats::detachedContexts);
+        builder.prop("peakUsedHeapSize", &HeapStats::peakUsedHeapSize);
+        builder.prop("spaces", &HeapStats::spaces);
+
+        describe(builder.getType())
+            .desc("Size of the heap")
+            .property("totalHeapSize", "The size of the heap in bytes")
+            .property("usedHeapSize", "The number of bytes in use")
+            .property("heapSizeLimit", "The size the heap can grow to before running out of memory")
+            .property("totalPhysicalSize", "The number of bytes committed in physical memory")
+            .property("mallocedMemory", "The number of bytes allocated by V8 outside of the heap")
+            .property("externalMemory", "The number of bytes held by ArrayBuffers and other external objects")
+            .property("nativeContexts", "The number of live contexts")
+            .property("detachedContexts", "The number of contexts that were detached but not yet collected")
+            .property("peakUsedHeapSize", "The largest used heap size sampled since the statistics were reset")
+            .property("spaces", "The spaces that the heap is divided into");
+    }
+
+    void bindGCTypeStats(Namespace* ns) {
+        ObjectTypeBuilder<GCTypeStats> builder = ns->type<GCTypeStats>("GCTypeStats");
+        builder.prop("count", &GCTypeStats::count);
+        builder.prop("totalPauseMs", &GCTypeStats::totalPauseMs);
+        builder.prop("maxPauseMs", &GCTypeStats::maxPauseMs);
+        builder.prop("bytesReclaimed", &GCTypeStats::bytesReclaimed);
+        builder.getMeta().is_trivially_constructible = 1;
+
+        describe(builder.getType())
+            .desc("Garbage collections of a single type")
+            .property("count", "The number of collections")
+            .property("totalPauseMs", "The total time script was paused for, in milliseconds")
+            .property("maxPauseMs", "The longest pause, in milliseconds")
+            .property("bytesReclaimed", "The total number of bytes freed");
+    }
+
+    void bindGCStats(Namespace* ns) {
+        ObjectTypeBuilder<GCStats> builder = ns->type<GCStats>("GCStats");
+        builder.prop("scavenge", &GCStats::scavenge);
+        builder.prop("minorMarkSweep", &GCStats::minorMarkSweep);
+        builder.prop("markSweepCompact", &GCStats::markSweepCompact);
+        builder.prop("incrementalMarking", &GCStats::incrementalMarking);
+        builder.prop("processWeakCallbacks", &GCStats::processWeakCallbacks);
+        builder.prop("pauseCount", &GCStats::pauseCount);
+        builder.prop("totalPauseMs", &GCStats::totalPauseMs);
+        builder.prop("pauseP50Ms", &GCStats::pauseP50Ms);
+        builder.prop("pauseP99Ms", &GCStats::pauseP99Ms);
+        builder.prop("pauseMaxMs", &GCStats::pauseMaxMs);
+        builder.prop("nearHeapLimitCount", &GCStats::nearHeapLimitCount);
+        builder.prop("heapLimitExpansions", &GCStats::heapLimitExpansions);
+        builder.getMeta().is_trivially_constructible = 1;
+
+        describe(builder.getType())
+            .desc("Garbage collections since the runtime was started")
+            .property("scavenge", "Young generation collections")
+            .property("minorMarkSweep", "Young generation mark-sweep collections")
+            .property("markSweepCompact", "Full collections")
+            .property("incrementalMarking", "Incremental marking steps")
+            .property("processWeakCallbacks", "Weak callback processing")
+            .property("pauseCount", "The number of pauses of any type")
+            .property("totalPauseMs", "The total time script was paused for, in milliseconds")
+            .property("pauseP50Ms", "The median pause, in milliseconds")
+            .property("pauseP99Ms", "The 99th percentile pause, in milliseconds")
+            .property("pauseMaxMs", "The longest pause, in milliseconds")
+            .property("nearHeapLimitCount", "The number of times the heap neared its limit")
+            .property("heapLimitExpansions", "The number of times the heap limit was raised");
+    }
+
+    void bindThreadPoolJobStats(Namespace* ns) {
+        ObjectTypeBuilder<ThreadPoolJobStats> builder = ns->type<ThreadPoolJobStats>("ThreadPoolJobStats");
+        builder.prop("name", &ThreadPoolJobStats::name);
+        builder.prop("count", &ThreadPoolJobStats::count);
+        builder.prop("totalRunMs", &ThreadPoolJobStats::totalRunMs);
+        builder.prop("maxRunMs", &ThreadPoolJobStats::maxRunMs);
+
+        describe(builder.getType())
+            .desc("Jobs of a single kind that were run by the thread pool")
+            .property("name", "The kind of job, e.g. 'async call'")
+            .property("count", "The number of jobs that finished running")
+            .property("totalRunMs", "The total time spent running the jobs, in milliseconds")
+            .property("maxRunMs", "The longest time spent running a single job, in milliseconds");
+    }
+
+    void bindThreadPoolWorkerStats(Namespace* ns) {
+        ObjectTypeBuilder<ThreadPoolWorkerStats> builder = ns->type<ThreadPoolWorkerStats>("ThreadPoolWorkerStats");
+        builder.prop("id", &ThreadPoolWorkerStats::id);
+        builder.prop("jobCount", &ThreadPoolWorkerStats::jobCount);
+        builder.prop("busyMs", &ThreadPoolWorkerStats::busyMs);
+        builder.prop("idleMs", &ThreadPoolWorkerStats::idleMs);
+        builder.prop("utilization", &ThreadPoolWorkerStats::utilization);
+        builder.getMeta().is_trivially_constructible = 1;
+
+        describe(builder.getType())
+            .desc("A single thread pool worker")
+            .property("id", "The worker's ID")
+            .property("jobCount", "The number of jobs the worker has run")
+            .property("busyMs", "The time spent running jobs, in milliseconds")
+            .property("idleMs", "The time spent waiting for jobs, in milliseconds")
+            .property("utilization", "The fraction of the worker's time spent running jobs, between 0 and 1");
+    }
+
+    void bindThreadPoolStats(Namespace* ns) {
+        ObjectTypeBuilder<ThreadPoolStats> builder = ns->type<ThreadPoolStats>("ThreadPoolStats");
+        builder.prop("workerCount", &ThreadPoolStats::workerCount);
+        builder.prop("pendingJobs", &ThreadPoolStats::pendingJobs);
+        builder.prop("peakPendingJobs", &ThreadPoolStats::peakPendingJobs);
+        builder.prop("completedJobs", &ThreadPoolStats::completedJobs);
+        builder.prop("submittedJobCount", &ThreadPoolStats::submittedJobCount);
+        builder.prop("finishedJobCount", &ThreadPoolStats::finishedJobCount);
+        builder.prop("meanWaitMs", &ThreadPoolStats::meanWaitMs);
+        builder.prop("maxWaitMs", &ThreadPoolStats::maxWaitMs);
+        builder.prop("meanRunMs", &ThreadPoolStats::meanRunMs);
+        builder.prop("maxRunMs", &ThreadPoolStats::maxRunMs);
+        builder.prop("meanCompletionDelayMs", &ThreadPoolStats::meanCompletionDelayMs);
+        builder.prop("maxCompletionDelayMs", &ThreadPoolStats::maxCompletionDelayMs);
+        builder.prop("utilization", &ThreadPoolStats::utilization);
+        builder.prop("workers", &ThreadPoolStats::workers);
+        builder.prop("jobs", &ThreadPoolStats::jobs);
+
+        describe(builder.getType())
+            .desc("The thread pool that async calls and other background work are run on")
+            .property("workerCount", "The number of worker threads")
+            .property("pendingJobs", "The number of jobs waiting for a worker")
+            .property("peakPendingJobs", "The most jobs that have been waiting for a worker at once")
+            .property("completedJobs", "The number of finished jobs waiting for their completion callbacks")
+            .property("submittedJobCount", "The number of jobs submitted")
+            .property("finishedJobCount", "The number of jobs that finished running")
+            .property("meanWaitMs", "The mean time from a job being submitted to it starting, in milliseconds")
+            .property("maxWaitMs", "The longest time from a job being submitted to it starting, in milliseconds")
+            .property("meanRunMs", "The mean time spent running a job, in milliseconds")
+            .property("maxRunMs", "The longest time spent running a job, in milliseconds")
+            .property("meanCompletionDelayMs", "The mean time from a job finishing to its completion callback")
+            .property("maxCompletionDelayMs", "The longest time from a job finishing to its completion callback")
+            .property("utilization", "The fraction of the workers' time spent running jobs, between 0 and 1")
+            .property("workers", "Statistics of each worker")
+            .property("jobs", "Statistics of each kind of job");
+    }
+
+    void bindRuntimeStats(Namespace* ns) {
+        ObjectTypeBuilder<RuntimeStats> builder = ns->type<RuntimeStats>("RuntimeStats");
+        builder.prop("heap", &RuntimeStats::heap);
+        builder.prop("gc", &RuntimeStats::gc);
+        builder.prop("eventLoop", &RuntimeStats::eventLoop);
+        builder.prop("threadPool", &RuntimeStats::threadPool);
+
+        describe(builder.getType())
+            .desc("Telemetry of the current runtime")
+            .property("heap", "Size of the heap")
+            .property("gc", "Garbage collection statistics")
+            .property("eventLoop", "Event loop statistics, all zero unless the event loop monitor is enabled")
+            .property("threadPool", "Thread pool statistics");
+    }
+
+    void init() {
+        Namespace* ns = new Namespace("runtime");
+        Registry::Add(ns);
+
+        bindHeapSpaceStats(ns);
+        bindHeapStats(ns);
+        bindGCTypeStats(ns);
+        bindGCStats(ns);
+        bindThreadPoolJobStats(ns);
+        bindThreadPoolWorkerStats(ns);
+        bindThreadPoolStats(ns);
+        bindRuntimeStats(ns);
+
+        describe(ns->function("stats", stats))
+            .desc("Samples the heap and collects telemetry of the current runtime")
+            .returns("The runtime's statistics", false);
+    }
+}
@@ -0,0 +1,144 @@
+#include <tspp/context.h>
+#include <tspp/modules/BindingModule.h>
+#include <tspp/modules/ModuleSystemModule.h>
+#include <tspp/modules/TimeoutModule.h>
+#include <tspp/systems/script.h>
+#include <tspp/tspp.h>
+#include <tspp/utils/Watchdog.h>
+
+#include <utils/Array.hpp>
+
+#include <chrono>
+
+namespace tspp {
+    using Clock = std::chrono::high_resolution_clock;
+
+    ScriptContext::ScriptContext(Runtime* runtime, const String& name) : IWithLogging("Context") {
+        m_runtime      = runtime;
+        m_name         = name;
+        m_moduleSystem = nullptr;
+    }
+
+    ScriptContext::~ScriptContext() {
+        shutdown();
+    }
+
+    const String& ScriptContext::getName() const {
+        return m_name;
+    }
+
+    Runtime* ScriptContext::getRuntime() const {
+        return m_runtime;
+    }
+
+    v8::Local<v8::Context> ScriptContext::getContext() const {
+        return m_context.Get(m_runtime->getIsolate());
+    }
+
+    ModuleSystemModule* ScriptContext::getModuleSystem() const {
+        return m_moduleSystem;
+    }
+
+    v8::Local<v8::Value> ScriptContext::executeString(const String& code, const String& filename) {
+        Watchdog::Scope watchdogScope(m_runtime->getWatchdog(), "executeString");
+        return m_runtime->getScriptSystem()->executeString(getContext(), code, filename);
+    }
+
+    bool ScriptContext::defineModule(
+        const String& id, const Array<String>& dependencies, v8::Local<v8::Function> factory
+    ) {
+        return m_moduleSystem->defineModule(id, dependencies, factory);
+    }
+
+    v8::Local<v8::Value> ScriptContext::requireModule(const String& id) {
+        Watchdog::Scope watchdogScope(m_runtime->getWatchdog(), "requireModule");
+        return m_moduleSystem->requireModule(id);
+    }
+
+    bool ScriptContext::initialize() {
+        Clock::time_point startedAt = Clock::now();
+        ScriptSystem* scriptSystem  = m_runtime->getScriptSystem();
+        v8::Isolate* isolate        = scriptSystem->getIsolate();
+        v8::Isolate::Scope isolateScope(isolate);
+        v8::HandleScope scope(isolate);
+
+        v8::Local<v8::Context> context = v8::Context::New(isolate);
+        m_context.Reset(isolate, context);
+        v8::Context::Scope contextScope(context);
+
+        m_moduleSystem = new ModuleSystemModule(scriptSystem, m_runtime);
+        m_modules.push(m_moduleSystem);
+        m_modules.push(new TimeoutModule(scriptSystem));
+
+        for (IScriptSystemModule* module : m_modules) {
+            addNestedLogger(module);
+            module->setContext(context);
+
+            if (!module->initialize()) {
+                error("Failed to initialize module '%s' for context '%s'", module->getName(), m_name.c_str());
+                return false;
+            }
+        }
+
+        // Only the global object and its lazy properties are created here, the bindings
+        // themselves are materialized on first access like they are in the main context
+        m_runtime->getBindingModule()->installBindings(context, m_moduleSystem);
+
+        // Lets the console and debugger see this context
+        scriptSystem->notifyContextCreated(context, m_name);
+
+        debug(
+            "Created context '%s' in %lld us",
+            m_name.c_str(),
+            (long long)std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - startedAt).count()
+        );
+
+        return true;
+    }
+
+    void ScriptContext::shutdown() {
+        if (m_context.IsEmpty()) {
+            return;
+        }
+
+        ScriptSystem* scriptSystem = m_runtime->getScriptSystem();
+        v8::Isolate* isolate       = scriptSystem->getIsolate();
+        v8::Isolate::Scope isolateScope(isolate);
+        v8::HandleScope scope(isolate);
+
+        scriptSystem->notifyContextDestroyed(m_context.Get(isolate));
+
+        for (IScriptSystemModule* module : m_modules) {
+            module->shutdown();
+            delete module;
+        }
+
+        m_modules.clear();
+        m_moduleSystem = nullptr;
+        m_context.Reset();
+    }
+
+    void ScriptContext::service() {
+        for (IScriptSystemModule* module : m_modules) {
+            module->service();
+        }
+    }
+
+    bool ScriptContext::getNextDeadline(std::chrono::high_resolution_clock::time_point& outDeadline) const {
+        bool hasDeadline = false;
+
+        for (IScriptSystemModule* module : m_modules) {
+            std::chrono::high_resolution_clock::time_point deadline;
+            if (!module->getNextDeadline(deadline)) {
+                continue;
+            }
+
+            if (!hasDeadline || deadline < outDeadline) {
+                outDeadline = deadline;
+                hasDeadline = true;
+            }
+        }
+
+        return hasDeadline;
+    }
+}
\ No newline at end of file
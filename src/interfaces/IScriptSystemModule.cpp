@@ -7,7 +7,9 @@ namespace tspp {
     )
         : IWithLogging(logContextName), m_scriptSystem(scriptSystem), m_name(submoduleName) {}
 
-    IScriptSystemModule::~IScriptSystemModule() {}
+    IScriptSystemModule::~IScriptSystemModule() {
+        m_context.Reset();
+    }
 
     bool IScriptSystemModule::initialize() {
         return true;
@@ -19,8 +21,28 @@ namespace tspp {
 
     void IScriptSystemModule::service() {}
 
+    bool IScriptSystemModule::getNextDeadline(std::chrono::high_resolution_clock::time_point& outDeadline) const {
+        return false;
+    }
+
     void IScriptSystemModule::shutdown() {}
 
+    void IScriptSystemModule::onContextCreated(v8::Local<v8::Context> context, const String& name) {}
+
+    void IScriptSystemModule::onContextDestroyed(v8::Local<v8::Context> context) {}
+
+    void IScriptSystemModule::setContext(v8::Local<v8::Context> context) {
+        m_context.Reset(m_scriptSystem->getIsolate(), context);
+    }
+
+    v8::Local<v8::Context> IScriptSystemModule::getContext() const {
+        if (m_context.IsEmpty()) {
+            return m_scriptSystem->getContext();
+        }
+
+        return m_context.Get(m_scriptSystem->getIsolate());
+    }
+
     ScriptSystem* IScriptSystemModule::getScriptSystem() const {
         return m_scriptSystem;
     }
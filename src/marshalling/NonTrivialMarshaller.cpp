@@ -41,7 +41,7 @@ namespace tspp {
     ) {
         v8::Isolate* isolate = callCtx.getIsolate();
 
-        HostObjectManager* objMgr = m_dataType->getUserData<DataTypeUserData>().hostObjectManager;
+        HostObjectManager* objMgr = HostObjectManager::Get(isolate, m_dataType);
         if (!objMgr) {
             isolate->ThrowException(v8::Exception::TypeError(
                 v8::String::NewFromUtf8(
@@ -73,7 +73,7 @@ namespace tspp {
             return convertToV8WithCopy(callCtx, value, objMgr);
         }
 
-        JavaScriptTypeData* typeData = m_dataType->getUserData<DataTypeUserData>().javascriptData;
+        JavaScriptTypeData* typeData = getJavaScriptTypeData(isolate, m_dataType);
         if (!typeData) {
             isolate->ThrowException(
                 v8::Exception::TypeError(v8::String::NewFromUtf8(
@@ -201,7 +201,7 @@ namespace tspp {
         v8::Isolate* isolate           = callCtx.getIsolate();
         v8::Local<v8::Context> context = callCtx.getContext();
 
-        JavaScriptTypeData* typeData = m_dataType->getUserData<DataTypeUserData>().javascriptData;
+        JavaScriptTypeData* typeData = getJavaScriptTypeData(isolate, m_dataType);
         if (!typeData) {
             isolate->ThrowException(
                 v8::Exception::TypeError(v8::String::NewFromUtf8(
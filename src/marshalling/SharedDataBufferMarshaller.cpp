@@ -0,0 +1,40 @@
+#include <bind/DataType.h>
+#include <tspp/builtin/databuffer.h>
+#include <tspp/marshalling/SharedDataBufferMarshaller.h>
+#include <tspp/utils/CallContext.h>
+
+namespace tspp {
+    SharedDataBufferMarshaller::SharedDataBufferMarshaller(bind::DataType* dataType) : IDataMarshaller(dataType) {}
+
+    SharedDataBufferMarshaller::~SharedDataBufferMarshaller() {}
+
+    bool SharedDataBufferMarshaller::canAccept(v8::Isolate* isolate, const v8::Local<v8::Value>& value) {
+        return value->IsSharedArrayBuffer();
+    }
+
+    v8::Local<v8::Value> SharedDataBufferMarshaller::convertToV8(
+        CallContext& context, void* value, bool valueNeedsCopy, bool isHostReturn
+    ) {
+        v8::Isolate* isolate = context.getIsolate();
+
+        // The memory is shared rather than copied, regardless of valueNeedsCopy
+        builtin::databuffer::SharedDataBuffer* buffer = (builtin::databuffer::SharedDataBuffer*)value;
+        return v8::SharedArrayBuffer::New(isolate, buffer->getBackingStore());
+    }
+
+    void* SharedDataBufferMarshaller::convertFromV8(CallContext& callCtx, const v8::Local<v8::Value>& value) {
+        v8::Isolate* isolate = callCtx.getIsolate();
+        u8* data             = callCtx.alloc(m_dataType);
+
+        if (!value->IsSharedArrayBuffer()) {
+            isolate->ThrowException(v8::Exception::TypeError(
+                v8::String::NewFromUtf8(isolate, "Value is not a SharedArrayBuffer").ToLocalChecked()
+            ));
+
+            return new (data) builtin::databuffer::SharedDataBuffer(0);
+        }
+
+        v8::Local<v8::SharedArrayBuffer> sharedArrayBuffer = value.As<v8::SharedArrayBuffer>();
+        return new (data) builtin::databuffer::SharedDataBuffer(sharedArrayBuffer->GetBackingStore());
+    }
+}
\ No newline at end of file
@@ -0,0 +1,337 @@
+#include <tspp/modules/AtomicsModule.h>
+#include <tspp/systems/script.h>
+#include <tspp/tspp.h>
+#include <tspp/utils/PollHandle.h>
+
+#include <utils/Array.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <mutex>
+
+namespace tspp {
+    using Clock = std::chrono::high_resolution_clock;
+
+    // Longer timeouts are treated as infinite, so that converting them to a deadline can't overflow
+    static constexpr f64 MaxTimeoutMS = 365.0 * 24.0 * 60.0 * 60.0 * 1000.0;
+
+    struct AtomicsModule::Waiter {
+        public:
+            AtomicsModule* module;
+            void* address;
+            bool hasDeadline;
+            Clock::time_point deadline;
+            bool isNotified;
+
+            // Signaled when the waiter is notified, may be null
+            PollHandle* pollHandle;
+
+            // Keeps the memory alive while waiting, only the module's thread touches the resolver
+            std::shared_ptr<v8::BackingStore> backingStore;
+            v8::Global<v8::Promise::Resolver> resolver;
+    };
+
+    // Waiters from every runtime, in the order they started waiting
+    static std::mutex s_waitersMutex;
+    static Array<AtomicsModule::Waiter*> s_waiters;
+
+    static void throwTypeError(v8::Isolate* isolate, const char* message) {
+        isolate->ThrowException(v8::Exception::TypeError(v8::String::NewFromUtf8(isolate, message).ToLocalChecked()));
+    }
+
+    /*
+     * Validates the (typedArray, index) arguments shared by waitAsync and notify, and gets
+     * the address of the value they refer to
+     */
+    static bool getValueAddress(
+        const v8::FunctionCallbackInfo<v8::Value>& args, std::shared_ptr<v8::BackingStore>& outStore, i32*& outAddress
+    ) {
+        v8::Isolate* isolate           = args.GetIsolate();
+        v8::Local<v8::Context> context = isolate->GetCurrentContext();
+
+        if (args.Length() < 2) {
+            throwTypeError(isolate, "Invalid number of arguments");
+            return false;
+        }
+
+        if (!args[0]->IsInt32Array()) {
+            throwTypeError(isolate, "First argument must be an Int32Array");
+            return false;
+        }
+
+        v8::Local<v8::Int32Array> array = args[0].As<v8::Int32Array>();
+        outStore                        = array->Buffer()->GetBackingStore();
+        if (!outStore->IsShared()) {
+            throwTypeError(isolate, "First argument must be backed by a SharedArrayBuffer");
+            return false;
+        }
+
+        u32 index = 0;
+        if (!args[1]->IsNumber() || !args[1]->Uint32Value(context).To(&index)) {
+            throwTypeError(isolate, "Second argument must be a number");
+            return false;
+        }
+
+        if (index >= array->Length()) {
+            isolate->ThrowException(v8::Exception::RangeError(
+                v8::String::NewFromUtf8(isolate, "Index is out of range").ToLocalChecked()
+            ));
+            return false;
+        }
+
+        outAddress = (i32*)((u8*)outStore->Data() + array->ByteOffset()) + index;
+        return true;
+    }
+
+    AtomicsModule::AtomicsModule(ScriptSystem* scriptSystem)
+        : IScriptSystemModule(scriptSystem, "Atomics", "Atomics") {
+        m_waiterCount = 0;
+    }
+
+    AtomicsModule::~AtomicsModule() {
+        shutdown();
+    }
+
+    bool AtomicsModule::initialize() {
+        v8::Isolate* isolate = m_scriptSystem->getIsolate();
+        v8::Isolate::Scope isolateScope(isolate);
+        v8::HandleScope scope(isolate);
+        v8::Local<v8::Context> context = m_scriptSystem->getContext();
+        v8::Context::Scope contextScope(context);
+
+        v8::Local<v8::External> data    = v8::External::New(isolate, this);
+        v8::Local<v8::Object> hostAtomics = v8::Object::New(isolate);
+
+        v8::Local<v8::Function> waitAsync = v8::Function::New(context, WaitAsync, data).ToLocalChecked();
+        v8::Local<v8::Function> notify    = v8::Function::New(context, NotifyCallback, data).ToLocalChecked();
+        hostAtomics->Set(context, v8::String::NewFromUtf8(isolate, "waitAsync").ToLocalChecked(), waitAsync).Check();
+        hostAtomics->Set(context, v8::String::NewFromUtf8(isolate, "notify").ToLocalChecked(), notify).Check();
+
+        context->Global()
+            ->Set(context, v8::String::NewFromUtf8(isolate, "HostAtomics").ToLocalChecked(), hostAtomics)
+            .Check();
+
+        return true;
+    }
+
+    void AtomicsModule::shutdown() {
+        if (m_waiterCount == 0) {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(s_waitersMutex);
+
+        Array<Waiter*> remaining;
+        for (Waiter* waiter : s_waiters) {
+            if (waiter->module != this) {
+                remaining.push(waiter);
+                continue;
+            }
+
+            waiter->resolver.Reset();
+            delete waiter;
+        }
+
+        s_waiters     = remaining;
+        m_waiterCount = 0;
+    }
+
+    void AtomicsModule::service() {
+        if (m_waiterCount == 0) {
+            return;
+        }
+
+        Array<Waiter*> woken;
+        Array<Waiter*> timedOut;
+
+        {
+            std::lock_guard<std::mutex> lock(s_waitersMutex);
+            Clock::time_point now = Clock::now();
+
+            Array<Waiter*> remaining;
+            for (Waiter* waiter : s_waiters) {
+                if (waiter->module != this) {
+                    remaining.push(waiter);
+                } else if (waiter->isNotified) {
+                    woken.push(waiter);
+                } else if (waiter->hasDeadline && now >= waiter->deadline) {
+                    timedOut.push(waiter);
+                } else {
+                    remaining.push(waiter);
+                }
+            }
+
+            if (woken.size() == 0 && timedOut.size() == 0) {
+                return;
+            }
+
+            s_waiters = remaining;
+        }
+
+        m_waiterCount -= woken.size() + timedOut.size();
+
+        v8::Isolate* isolate = m_scriptSystem->getIsolate();
+        v8::Isolate::Scope isolateScope(isolate);
+        v8::HandleScope scope(isolate);
+        v8::Local<v8::Context> context = m_scriptSystem->getContext();
+        v8::Context::Scope contextScope(context);
+
+        v8::Local<v8::String> ok      = v8::String::NewFromUtf8(isolate, "ok").ToLocalChecked();
+        v8::Local<v8::String> timeout = v8::String::NewFromUtf8(isolate, "timed-out").ToLocalChecked();
+
+        for (Waiter* waiter : woken) {
+            waiter->resolver.Get(isolate)->Resolve(context, ok).Check();
+            waiter->resolver.Reset();
+            delete waiter;
+        }
+
+        for (Waiter* waiter : timedOut) {
+            waiter->resolver.Get(isolate)->Resolve(context, timeout).Check();
+            waiter->resolver.Reset();
+            delete waiter;
+        }
+    }
+
+    u32 AtomicsModule::Notify(void* address, u32 count) {
+        std::lock_guard<std::mutex> lock(s_waitersMutex);
+
+        u32 wokenCount = 0;
+        for (Waiter* waiter : s_waiters) {
+            if (wokenCount == count) {
+                break;
+            }
+
+            if (waiter->address != address || waiter->isNotified) {
+                continue;
+            }
+
+            waiter->isNotified = true;
+            wokenCount++;
+
+            if (waiter->pollHandle) {
+                waiter->pollHandle->signal();
+            }
+        }
+
+        return wokenCount;
+    }
+
+    bool AtomicsModule::getNextDeadline(Clock::time_point& outDeadline) const {
+        if (m_waiterCount == 0) {
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(s_waitersMutex);
+
+        bool hasDeadline = false;
+        for (Waiter* waiter : s_waiters) {
+            if (waiter->module != this || !waiter->hasDeadline) {
+                continue;
+            }
+
+            if (!hasDeadline || waiter->deadline < outDeadline) {
+                outDeadline = waiter->deadline;
+                hasDeadline = true;
+            }
+        }
+
+        return hasDeadline;
+    }
+
+    void AtomicsModule::WaitAsync(const v8::FunctionCallbackInfo<v8::Value>& args) {
+        v8::Isolate* isolate           = args.GetIsolate();
+        v8::Local<v8::Context> context = isolate->GetCurrentContext();
+        AtomicsModule* module          = (AtomicsModule*)args.Data().As<v8::External>()->Value();
+
+        std::shared_ptr<v8::BackingStore> backingStore;
+        i32* address = nullptr;
+        if (!getValueAddress(args, backingStore, address)) {
+            return;
+        }
+
+        i32 expected = 0;
+        if (args.Length() < 3 || !args[2]->IsNumber() || !args[2]->Int32Value(context).To(&expected)) {
+            throwTypeError(isolate, "Third argument must be a number");
+            return;
+        }
+
+        bool hasDeadline = false;
+        f64 timeoutMS    = 0.0;
+        if (args.Length() > 3 && !args[3]->IsUndefined()) {
+            if (!args[3]->IsNumber()) {
+                throwTypeError(isolate, "Fourth argument must be a number");
+                return;
+            }
+
+            timeoutMS   = args[3].As<v8::Number>()->Value();
+            hasDeadline = !std::isnan(timeoutMS) && timeoutMS <= MaxTimeoutMS;
+            if (timeoutMS < 0.0) {
+                timeoutMS = 0.0;
+            }
+        }
+
+        v8::Local<v8::Promise::Resolver> resolver = v8::Promise::Resolver::New(context).ToLocalChecked();
+        args.GetReturnValue().Set(resolver->GetPromise());
+
+        const char* immediateResult = nullptr;
+        Runtime* runtime            = Runtime::Get(isolate);
+        PollHandle* pollHandle      = runtime ? runtime->getPollHandle() : nullptr;
+
+        {
+            // Compare while holding the lock so that a notify after the value changes can't be missed
+            std::lock_guard<std::mutex> lock(s_waitersMutex);
+
+            if (std::atomic_ref<i32>(*address).load() != expected) {
+                immediateResult = "not-equal";
+            } else if (hasDeadline && timeoutMS == 0.0) {
+                immediateResult = "timed-out";
+            } else {
+                Waiter* waiter       = new Waiter();
+                waiter->module       = module;
+                waiter->address      = address;
+                waiter->hasDeadline  = hasDeadline;
+                waiter->isNotified   = false;
+                waiter->pollHandle   = pollHandle;
+                waiter->backingStore = backingStore;
+                waiter->resolver.Reset(isolate, resolver);
+
+                if (hasDeadline) {
+                    waiter->deadline = Clock::now() + std::chrono::microseconds(u64(timeoutMS * 1000.0));
+
+                    if (pollHandle) {
+                        pollHandle->setDeadlineIfEarlier(waiter->deadline);
+                    }
+                }
+
+                s_waiters.push(waiter);
+                module->m_waiterCount++;
+            }
+        }
+
+        if (immediateResult) {
+            resolver->Resolve(context, v8::String::NewFromUtf8(isolate, immediateResult).ToLocalChecked()).Check();
+        }
+    }
+
+    void AtomicsModule::NotifyCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
+        v8::Isolate* isolate           = args.GetIsolate();
+        v8::Local<v8::Context> context = isolate->GetCurrentContext();
+
+        std::shared_ptr<v8::BackingStore> backingStore;
+        i32* address = nullptr;
+        if (!getValueAddress(args, backingStore, address)) {
+            return;
+        }
+
+        u32 count = UINT32_MAX;
+        if (args.Length() > 2 && !args[2]->IsUndefined()) {
+            if (!args[2]->IsNumber() || !args[2]->Uint32Value(context).To(&count)) {
+                throwTypeError(isolate, "Third argument must be a number");
+                return;
+            }
+        }
+
+        args.GetReturnValue().Set(v8::Integer::NewFromUnsigned(isolate, Notify(address, count)));
+    }
+}
\ No newline at end of file
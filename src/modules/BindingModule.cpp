@@ -9,6 +9,7 @@
 #include <tspp/marshalling/TrivialStructMarshaller.h>
 #include <tspp/marshalling/UtilsStringMarshaller.h>
 #include <tspp/modules/BindingModule.h>
+#include <tspp/modules/ModuleSystemModule.h>
 #include <tspp/systems/script.h>
 #include <tspp/tspp.h>
 #include <tspp/utils/BindObjectType.h>
@@ -17,14 +18,21 @@
 #include <tspp/utils/Docs.h>
 #include <tspp/utils/HostObjectManager.h>
 #include <tspp/utils/JavaScriptTypeData.h>
+#include <tspp/utils/Trace.h>
 #include <tspp/utils/SourceFileBuilder.h>
 
 #include <filesystem>
+#include <mutex>
+#include <string.h>
 
 namespace tspp {
+    // The binding registry and the marshallers of its types are shared by every runtime
+    static std::once_flag s_builtInTypesBound;
+
     BindingModule::BindingModule(ScriptSystem* scriptSystem, Runtime* runtime)
         : IScriptSystemModule(scriptSystem, "Binding", "Binding") {
-        m_runtime = runtime;
+        m_runtime           = runtime;
+        m_materializedCount = 0;
     }
 
     BindingModule::~BindingModule() {
@@ -39,14 +47,41 @@ namespace tspp {
             return false;
         }
 
-        bindBuiltInTypes();
+        std::call_once(s_builtInTypesBound, [this]() { bindBuiltInTypes(); });
 
         return true;
     }
 
-    void BindingModule::shutdown() {}
+    void BindingModule::shutdown() {
+        if (m_lazyBindings.size() > 0) {
+            debug(
+                "Materialized %u of %u bindings (%u object types)",
+                m_materializedCount,
+                m_lazyBindings.size(),
+                getMaterializedTypeCount()
+            );
+        }
+
+        for (LazyBinding* binding : m_lazyBindings) {
+            delete binding;
+        }
+
+        m_lazyBindings.clear();
+        m_lazyBindingMap.clear();
+        m_materializedCount = 0;
+    }
+
+    u32 BindingModule::getBindingCount() const {
+        return m_lazyBindings.size();
+    }
+
+    u32 BindingModule::getMaterializedBindingCount() const {
+        return m_materializedCount;
+    }
 
     void BindingModule::commitBindings() {
+        Trace::Scope trace("tspp", "BindingModule::commitBindings");
+
         bind::Namespace* global = nullptr;
 
         try {
@@ -56,68 +91,6 @@ namespace tspp {
             return;
         }
 
-        SourceFileBuilder dts;
-        dts.line("interface IntrinsicNumber<");
-        dts.indent();
-        dts.line("bits extends number,");
-        dts.line("is_signed extends boolean,");
-        dts.line("is_floating_point extends boolean");
-        dts.unindent();
-        dts.line("> extends Number {}");
-        dts.line("/** %d */", INT8_MIN);
-        dts.line("declare const I8_MIN: number;");
-        dts.line("/** %d */", INT8_MAX);
-        dts.line("declare const I8_MAX: number;");
-        dts.line("/** %d */", INT16_MIN);
-        dts.line("declare const I16_MIN: number;");
-        dts.line("/** %d */", INT16_MAX);
-        dts.line("declare const I16_MAX: number;");
-        dts.line("/** %d */", INT32_MIN);
-        dts.line("declare const I32_MIN: number;");
-        dts.line("/** %d */", INT32_MAX);
-        dts.line("declare const I32_MAX: number;");
-        dts.line("/** %lld */", INT64_MIN);
-        dts.line("declare const I64_MIN: number;");
-        dts.line("/** %lld */", INT64_MAX);
-        dts.line("declare const I64_MAX: number;");
-        dts.line("/** 0 */");
-        dts.line("declare const U8_MIN: number;");
-        dts.line("/** %d */", UINT8_MAX);
-        dts.line("declare const U8_MAX: number;");
-        dts.line("/** 0 */");
-        dts.line("declare const U16_MIN: number;");
-        dts.line("/** %d */", UINT16_MAX);
-        dts.line("declare const U16_MAX: number;");
-        dts.line("/** 0 */");
-        dts.line("declare const U32_MIN: number;");
-        dts.line("/** %d */", UINT32_MAX);
-        dts.line("declare const U32_MAX: number;");
-        dts.line("/** 0 */");
-        dts.line("declare const U64_MIN: number;");
-        dts.line("/** %llu */", UINT64_MAX);
-        dts.line("declare const U64_MAX: number;");
-        dts.line("/** 1.175494351e-38 */");
-        dts.line("declare const F32_MIN: number;");
-        dts.line("/** 3.402823466e+38 */");
-        dts.line("declare const F32_MAX: number;");
-        dts.line("/** 2.2250738585072014e-308 */");
-        dts.line("declare const F64_MIN: number;");
-        dts.line("/** 1.7976931348623158e+308 */");
-        dts.line("declare const F64_MAX: number;");
-
-        dts.line("declare function setTimeout(callback: () => void, delay?: number): number;");
-        dts.line(
-            "declare function setTimeout<Args extends any[]>(callback: (...args: Args) => void, delay: number, "
-            "...args: Args): number;"
-        );
-        dts.line("declare function setInterval(callback: () => void, delay?: number): number;");
-        dts.line(
-            "declare function setInterval<Args extends any[]>(callback: (...args: Args) => void, delay: number, "
-            "...args: Args): number;"
-        );
-        dts.line("declare function clearInterval(id: number): void;");
-        dts.line("declare function clearTimeout(id: number): void;");
-
         v8::Isolate* isolate = m_runtime->getIsolate();
         v8::Isolate::Scope isolate_scope(isolate);
         v8::HandleScope scope(isolate);
@@ -154,36 +127,7 @@ namespace tspp {
             }
         }
 
-        // Get all global symbols
-        const Array<bind::ISymbol*>& symbols = global->getSymbols();
-        for (bind::ISymbol* symbol : symbols) {
-            processGlobalSymbol(dts, symbol);
-        }
-
-        v8::Local<v8::Object> globalScope = context->Global();
-
-        /* clang-format off */
-        globalScope->Set(context, v8::String::NewFromUtf8(isolate, "I8_MIN" ).ToLocalChecked(), v8::Number::New(isolate, INT8_MIN  )).Check();
-        globalScope->Set(context, v8::String::NewFromUtf8(isolate, "I8_MAX" ).ToLocalChecked(), v8::Number::New(isolate, INT8_MAX  )).Check();
-        globalScope->Set(context, v8::String::NewFromUtf8(isolate, "I16_MIN").ToLocalChecked(), v8::Number::New(isolate, INT16_MIN )).Check();
-        globalScope->Set(context, v8::String::NewFromUtf8(isolate, "I16_MAX").ToLocalChecked(), v8::Number::New(isolate, INT16_MAX )).Check();
-        globalScope->Set(context, v8::String::NewFromUtf8(isolate, "I32_MIN").ToLocalChecked(), v8::Number::New(isolate, INT32_MIN )).Check();
-        globalScope->Set(context, v8::String::NewFromUtf8(isolate, "I32_MAX").ToLocalChecked(), v8::Number::New(isolate, INT32_MAX )).Check();
-        globalScope->Set(context, v8::String::NewFromUtf8(isolate, "I64_MIN").ToLocalChecked(), v8::Number::New(isolate, INT64_MIN )).Check();
-        globalScope->Set(context, v8::String::NewFromUtf8(isolate, "I64_MAX").ToLocalChecked(), v8::Number::New(isolate, INT64_MAX )).Check();
-        globalScope->Set(context, v8::String::NewFromUtf8(isolate, "U8_MIN ").ToLocalChecked(), v8::Number::New(isolate, 0         )).Check();
-        globalScope->Set(context, v8::String::NewFromUtf8(isolate, "U8_MAX" ).ToLocalChecked(), v8::Number::New(isolate, UINT8_MAX )).Check();
-        globalScope->Set(context, v8::String::NewFromUtf8(isolate, "U16_MIN").ToLocalChecked(), v8::Number::New(isolate, 0         )).Check();
-        globalScope->Set(context, v8::String::NewFromUtf8(isolate, "U16_MAX").ToLocalChecked(), v8::Number::New(isolate, UINT16_MAX)).Check();
-        globalScope->Set(context, v8::String::NewFromUtf8(isolate, "U32_MIN").ToLocalChecked(), v8::Number::New(isolate, 0         )).Check();
-        globalScope->Set(context, v8::String::NewFromUtf8(isolate, "U32_MAX").ToLocalChecked(), v8::Number::New(isolate, UINT32_MAX)).Check();
-        globalScope->Set(context, v8::String::NewFromUtf8(isolate, "U64_MIN").ToLocalChecked(), v8::Number::New(isolate, 0         )).Check();
-        globalScope->Set(context, v8::String::NewFromUtf8(isolate, "U64_MAX").ToLocalChecked(), v8::Number::New(isolate, UINT64_MAX)).Check();
-        globalScope->Set(context, v8::String::NewFromUtf8(isolate, "F32_MIN").ToLocalChecked(), v8::Number::New(isolate, FLT_MIN   )).Check();
-        globalScope->Set(context, v8::String::NewFromUtf8(isolate, "F32_MAX").ToLocalChecked(), v8::Number::New(isolate, FLT_MAX   )).Check();
-        globalScope->Set(context, v8::String::NewFromUtf8(isolate, "F64_MIN").ToLocalChecked(), v8::Number::New(isolate, DBL_MIN   )).Check();
-        globalScope->Set(context, v8::String::NewFromUtf8(isolate, "F64_MAX").ToLocalChecked(), v8::Number::New(isolate, DBL_MAX   )).Check();
-        /* clang-format on */
+        installBindings(context, m_runtime->getModuleSystem());
 
         std::filesystem::path root        = m_runtime->getConfig().scriptRootDirectory;
         std::filesystem::path builtinDefs = root / "internal" / "lib" / "builtins.d.ts";
@@ -212,11 +156,81 @@ namespace tspp {
             fclose(file);
         }
 
+        // Rewriting the definitions when nothing changed would needlessly invalidate incremental builds
+        u64 hash        = hashBindings(global);
+        String hashLine = String::Format("// bindings hash: %016llx", (unsigned long long)hash);
+        FILE* existing  = fopen(builtinDefs.string().c_str(), "r");
+        bool isUpToDate = false;
+        if (existing) {
+            char firstLine[64] = {0};
+            if (fgets(firstLine, sizeof(firstLine), existing)) {
+                firstLine[strcspn(firstLine, "\r\n")] = 0;
+                isUpToDate                            = hashLine == firstLine;
+            }
+
+            fclose(existing);
+        }
+
+        if (isUpToDate) {
+            debug("Built-in definitions are up to date, skipping generation");
+            return;
+        }
+
+        SourceFileBuilder dts;
+        dts.line(hashLine);
+        emitBuiltInDefinitions(dts, global);
+
         if (!dts.writeToFile(builtinDefs.string().c_str())) {
             error("Failed to write built-in definitions to '%s'", builtinDefs.string().c_str());
         }
     }
 
+    void BindingModule::installBindings(v8::Local<v8::Context> context, ModuleSystemModule* moduleSystem) {
+        bind::Namespace* global = nullptr;
+
+        try {
+            global = bind::Registry::GlobalNamespace();
+        } catch (GenericException& e) {
+            error("Failed to get global namespace: %s", e.what());
+            return;
+        }
+
+        v8::Isolate* isolate = m_runtime->getIsolate();
+        v8::HandleScope scope(isolate);
+        v8::Context::Scope context_scope(context);
+
+        // Get all global symbols
+        const Array<bind::ISymbol*>& symbols = global->getSymbols();
+        for (bind::ISymbol* symbol : symbols) {
+            processGlobalSymbol(context, moduleSystem, symbol);
+        }
+
+        v8::Local<v8::Object> globalScope = context->Global();
+
+        /* clang-format off */
+        globalScope->Set(context, v8::String::NewFromUtf8(isolate, "I8_MIN" ).ToLocalChecked(), v8::Number::New(isolate, INT8_MIN  )).Check();
+        globalScope->Set(context, v8::String::NewFromUtf8(isolate, "I8_MAX" ).ToLocalChecked(), v8::Number::New(isolate, INT8_MAX  )).Check();
+        globalScope->Set(context, v8::String::NewFromUtf8(isolate, "I16_MIN").ToLocalChecked(), v8::Number::New(isolate, INT16_MIN )).Check();
+        globalScope->Set(context, v8::String::NewFromUtf8(isolate, "I16_MAX").ToLocalChecked(), v8::Number::New(isolate, INT16_MAX )).Check();
+        globalScope->Set(context, v8::String::NewFromUtf8(isolate, "I32_MIN").ToLocalChecked(), v8::Number::New(isolate, INT32_MIN )).Check();
+        globalScope->Set(context, v8::String::NewFromUtf8(isolate, "I32_MAX").ToLocalChecked(), v8::Number::New(isolate, INT32_MAX )).Check();
+        globalScope->Set(context, v8::String::NewFromUtf8(isolate, "I64_MIN").ToLocalChecked(), v8::Number::New(isolate, INT64_MIN )).Check();
+        globalScope->Set(context, v8::String::NewFromUtf8(isolate, "I64_MAX").ToLocalChecked(), v8::Number::New(isolate, INT64_MAX )).Check();
+        globalScope->Set(context, v8::String::NewFromUtf8(isolate, "U8_MIN ").ToLocalChecked(), v8::Number::New(isolate, 0         )).Check();
+        globalScope->Set(context, v8::String::NewFromUtf8(isolate, "U8_MAX" ).ToLocalChecked(), v8::Number::New(isolate, UINT8_MAX )).Check();
+        globalScope->Set(context, v8::String::NewFromUtf8(isolate, "U16_MIN").ToLocalChecked(), v8::Number::New(isolate, 0         )).Check();
+        globalScope->Set(context, v8::String::NewFromUtf8(isolate, "U16_MAX").ToLocalChecked(), v8::Number::New(isolate, UINT16_MAX)).Check();
+        globalScope->Set(context, v8::String::NewFromUtf8(isolate, "U32_MIN").ToLocalChecked(), v8::Number::New(isolate, 0         )).Check();
+        globalScope->Set(context, v8::String::NewFromUtf8(isolate, "U32_MAX").ToLocalChecked(), v8::Number::New(isolate, UINT32_MAX)).Check();
+        globalScope->Set(context, v8::String::NewFromUtf8(isolate, "U64_MIN").ToLocalChecked(), v8::Number::New(isolate, 0         )).Check();
+        globalScope->Set(context, v8::String::NewFromUtf8(isolate, "U64_MAX").ToLocalChecked(), v8::Number::New(isolate, UINT64_MAX)).Check();
+        globalScope->Set(context, v8::String::NewFromUtf8(isolate, "F32_MIN").ToLocalChecked(), v8::Number::New(isolate, FLT_MIN   )).Check();
+        globalScope->Set(context, v8::String::NewFromUtf8(isolate, "F32_MAX").ToLocalChecked(), v8::Number::New(isolate, FLT_MAX   )).Check();
+        globalScope->Set(context, v8::String::NewFromUtf8(isolate, "F64_MIN").ToLocalChecked(), v8::Number::New(isolate, DBL_MIN   )).Check();
+        globalScope->Set(context, v8::String::NewFromUtf8(isolate, "F64_MAX").ToLocalChecked(), v8::Number::New(isolate, DBL_MAX   )).Check();
+        /* clang-format on */
+    }
+
     void BindingModule::bindBuiltInTypes() {
         bind::type<void>("void").getType()->getUserData<DataTypeUserData>().typescriptType = "void";
         bind::type<bool>("bool").getType()->getUserData<DataTypeUserData>().typescriptType = "boolean";
@@ -250,25 +264,122 @@ namespace tspp {
         userData.marshaller        = new UtilsStringMarshaller(str.getType());
     }
 
-    void BindingModule::processGlobalSymbol(SourceFileBuilder& dts, bind::ISymbol* symbol) {
-        v8::Isolate* isolate           = m_runtime->getIsolate();
-        v8::Local<v8::Context> context = m_runtime->getContext();
-        v8::Local<v8::Object> global   = context->Global();
+    void BindingModule::emitBuiltInDefinitions(SourceFileBuilder& dts, bind::Namespace* global) {
+        dts.line("interface IntrinsicNumber<");
+        dts.indent();
+        dts.line("bits extends number,");
+        dts.line("is_signed extends boolean,");
+        dts.line("is_floating_point extends boolean");
+        dts.unindent();
+        dts.line("> extends Number {}");
+        dts.line("/** %d */", INT8_MIN);
+        dts.line("declare const I8_MIN: number;");
+        dts.line("/** %d */", INT8_MAX);
+        dts.line("declare const I8_MAX: number;");
+        dts.line("/** %d */", INT16_MIN);
+        dts.line("declare const I16_MIN: number;");
+        dts.line("/** %d */", INT16_MAX);
+        dts.line("declare const I16_MAX: number;");
+        dts.line("/** %d */", INT32_MIN);
+        dts.line("declare const I32_MIN: number;");
+        dts.line("/** %d */", INT32_MAX);
+        dts.line("declare const I32_MAX: number;");
+        dts.line("/** %lld */", INT64_MIN);
+        dts.line("declare const I64_MIN: number;");
+        dts.line("/** %lld */", INT64_MAX);
+        dts.line("declare const I64_MAX: number;");
+        dts.line("/** 0 */");
+        dts.line("declare const U8_MIN: number;");
+        dts.line("/** %d */", UINT8_MAX);
+        dts.line("declare const U8_MAX: number;");
+        dts.line("/** 0 */");
+        dts.line("declare const U16_MIN: number;");
+        dts.line("/** %d */", UINT16_MAX);
+        dts.line("declare const U16_MAX: number;");
+        dts.line("/** 0 */");
+        dts.line("declare const U32_MIN: number;");
+        dts.line("/** %d */", UINT32_MAX);
+        dts.line("declare const U32_MAX: number;");
+        dts.line("/** 0 */");
+        dts.line("declare const U64_MIN: number;");
+        dts.line("/** %llu */", UINT64_MAX);
+        dts.line("declare const U64_MAX: number;");
+        dts.line("/** 1.175494351e-38 */");
+        dts.line("declare const F32_MIN: number;");
+        dts.line("/** 3.402823466e+38 */");
+        dts.line("declare const F32_MAX: number;");
+        dts.line("/** 2.2250738585072014e-308 */");
+        dts.line("declare const F64_MIN: number;");
+        dts.line("/** 1.7976931348623158e+308 */");
+        dts.line("declare const F64_MAX: number;");
+
+        dts.line("declare function setTimeout(callback: () => void, delay?: number): number;");
+        dts.line(
+            "declare function setTimeout<Args extends any[]>(callback: (...args: Args) => void, delay: number, "
+            "...args: Args): number;"
+        );
+        dts.line("declare function setInterval(callback: () => void, delay?: number): number;");
+        dts.line(
+            "declare function setInterval<Args extends any[]>(callback: (...args: Args) => void, delay: number, "
+            "...args: Args): number;"
+        );
+        dts.line("declare function clearInterval(id: number): void;");
+        dts.line("declare function clearTimeout(id: number): void;");
+
+        dts.line("declare class Worker {");
+        dts.indent();
+        dts.line("constructor(moduleId: string);");
+        dts.line("onmessage: ((event: { data: any }) => void) | null;");
+        dts.line("onerror: ((event: { message: string }) => void) | null;");
+        dts.line("postMessage(message: any, transfer?: ArrayBuffer[]): void;");
+        dts.line("terminate(): void;");
+        dts.unindent();
+        dts.line("}");
+        dts.line("/** Only available within a worker, sends a message to the runtime that started it */");
+        dts.line("declare function postMessage(message: any, transfer?: ArrayBuffer[]): void;");
+        dts.line("/** Only available within a worker, stops the worker */");
+        dts.line("declare function close(): void;");
+        dts.line("/** Only used within a worker, receives messages from the runtime that started it */");
+        dts.line("declare var onmessage: ((event: { data: any }) => void) | null;");
+
+        dts.line("/** Atomics.waitAsync / Atomics.notify counterparts that can also be notified by the host */");
+        dts.line("declare namespace HostAtomics {");
+        dts.indent();
+        dts.line(
+            "function waitAsync(typedArray: Int32Array, index: number, value: number, timeout?: number): "
+            "Promise<'ok' | 'not-equal' | 'timed-out'>;"
+        );
+        dts.line("function notify(typedArray: Int32Array, index: number, count?: number): number;");
+        dts.unindent();
+        dts.line("}");
+
+        const Array<bind::ISymbol*>& symbols = global->getSymbols();
+        for (bind::ISymbol* symbol : symbols) {
+            switch (symbol->getSymbolType()) {
+                case bind::SymbolType::Namespace: emitNamespace(dts, (bind::Namespace*)symbol); break;
+                case bind::SymbolType::Function: emitFunction(dts, (bind::Function*)symbol); break;
+                case bind::SymbolType::DataType: emitDataType(dts, (bind::DataType*)symbol); break;
+                default: break;
+            }
+        }
+    }
+
+    void BindingModule::processGlobalSymbol(
+        v8::Local<v8::Context> context, ModuleSystemModule* moduleSystem, bind::ISymbol* symbol
+    ) {
+        v8::Isolate* isolate         = m_runtime->getIsolate();
+        v8::Local<v8::Object> global = context->Global();
 
         switch (symbol->getSymbolType()) {
             case bind::SymbolType::Namespace:
-                processNamespace((bind::Namespace*)symbol);
-                emitNamespace(dts, (bind::Namespace*)symbol);
+                processNamespace(context, moduleSystem, (bind::Namespace*)symbol);
                 break;
             case bind::SymbolType::Function: {
-                emitFunction(dts, (bind::Function*)symbol);
                 defineFunction(global, context, isolate, (bind::Function*)symbol);
                 break;
             }
             case bind::SymbolType::DataType: {
-                bind::DataType* dataType = (bind::DataType*)symbol;
-                emitDataType(dts, dataType);
-                defineDataType(global, context, isolate, dataType);
+                defineDataType(global, context, isolate, (bind::DataType*)symbol);
                 break;
             }
             case bind::SymbolType::Value: {
@@ -279,26 +390,93 @@ namespace tspp {
         }
     }
 
-    void BindingModule::defineFunction(
-        v8::Local<v8::Object>& target, v8::Local<v8::Context>& context, v8::Isolate* isolate, bind::Function* function
+    void BindingModule::LazyBindingGetter(
+        v8::Local<v8::Name> property, const v8::PropertyCallbackInfo<v8::Value>& info
+    ) {
+        LazyBinding* binding = (LazyBinding*)info.Data().As<v8::External>()->Value();
+
+        // V8 replaces the lazy property with a regular data property holding the returned value,
+        // so this is only called once per binding per context. Bindings are only accessed by the
+        // context they were installed in, so that's the current one.
+        v8::Local<v8::Context> context = info.GetIsolate()->GetCurrentContext();
+        v8::Local<v8::Value> value     = binding->module->materialize(context, binding->ns, binding->symbol);
+        if (!value.IsEmpty()) {
+            info.GetReturnValue().Set(value);
+        }
+    }
+
+    void BindingModule::defineLazy(
+        v8::Local<v8::Object>& target,
+        v8::Local<v8::Context>& context,
+        v8::Isolate* isolate,
+        bind::Namespace* ns,
+        bind::ISymbol* symbol,
+        const String& name
     ) {
+        // Bindings don't depend on the context, so each context that they're installed in shares them
+        LazyBinding* binding = nullptr;
+        auto it              = m_lazyBindingMap.find(symbol);
+        if (it != m_lazyBindingMap.end()) {
+            binding = it->second;
+        } else {
+            binding = new LazyBinding({this, ns, symbol});
+            m_lazyBindings.push(binding);
+            m_lazyBindingMap[symbol] = binding;
+        }
+
         target
-            ->Set(
+            ->SetLazyDataProperty(
                 context,
-                v8::String::NewFromUtf8(isolate, function->getName().c_str()).ToLocalChecked(),
-                processFunction(function)
+                v8::String::NewFromUtf8(isolate, name.c_str()).ToLocalChecked(),
+                LazyBindingGetter,
+                v8::External::New(isolate, binding)
             )
             .Check();
     }
 
+    v8::Local<v8::Value> BindingModule::materialize(
+        v8::Local<v8::Context> context, bind::Namespace* ns, bind::ISymbol* symbol
+    ) {
+        v8::Isolate* isolate = m_runtime->getIsolate();
+        v8::EscapableHandleScope scope(isolate);
+
+        m_materializedCount++;
+
+        v8::Local<v8::Value> value;
+        switch (symbol->getSymbolType()) {
+            case bind::SymbolType::Function: value = processFunction(context, (bind::Function*)symbol); break;
+            case bind::SymbolType::DataType: value = processDataType(context, (bind::DataType*)symbol); break;
+            case bind::SymbolType::Value: value = processValue(context, ns, (bind::ValuePointer*)symbol); break;
+            default: break;
+        }
+
+        if (value.IsEmpty()) {
+            return v8::Local<v8::Value>();
+        }
+
+        return scope.Escape(value);
+    }
+
+    void BindingModule::defineFunction(
+        v8::Local<v8::Object>& target, v8::Local<v8::Context>& context, v8::Isolate* isolate, bind::Function* function
+    ) {
+        defineLazy(target, context, isolate, nullptr, function, function->getName());
+    }
+
     void BindingModule::defineDataType(
         v8::Local<v8::Object>& target, v8::Local<v8::Context>& context, v8::Isolate* isolate, bind::DataType* dataType
     ) {
-        v8::Local<v8::Value> val = processDataType(dataType);
-        if (!val.IsEmpty()) {
-            target->Set(context, v8::String::NewFromUtf8(isolate, dataType->getName().c_str()).ToLocalChecked(), val)
-                .Check();
+        if (!isExposedDataType(dataType)) {
+            return;
         }
+
+        // An object manager is needed to pass objects of this type to and from JS regardless of
+        // whether or not the type itself is ever accessed
+        if (!dataType->getInfo().is_enum) {
+            HostObjectManager::RegisterType(dataType);
+        }
+
+        defineLazy(target, context, isolate, nullptr, dataType, dataType->getName());
     }
 
     void BindingModule::defineValue(
@@ -308,8 +486,7 @@ namespace tspp {
         bind::Namespace* ns,
         bind::ValuePointer* value
     ) {
-        const bind::type_meta& meta = value->getType()->getInfo();
-        DataTypeUserData& userData  = value->getType()->getUserData<DataTypeUserData>();
+        DataTypeUserData& userData = value->getType()->getUserData<DataTypeUserData>();
         if (!userData.marshaller) {
             error(
                 "No marshaller found for data type '%s' of value '%s' from namespace '%s'",
@@ -320,37 +497,44 @@ namespace tspp {
             return;
         }
 
-        v8::Local<v8::Value> val;
-        {
-            CallContext cctx(isolate, context);
-            val = userData.marshaller->toV8(cctx, value->getAddress());
-
-            if (cctx.didAllocate()) {
-                error(
-                    "Marshaller for data type '%s' of value '%s' from namespace '%s' had to allocate "
-                    "memory in order to convert the provided value. This is currently unsupported, "
-                    "since this memory is allocated on the stack and will be freed before the lifetime "
-                    "of the bound value ends. The value will not be bound as a result.",
-                    value->getType()->getName().c_str(),
-                    value->getName().c_str(),
-                    ns ? ns->getName().c_str() : "global"
-                );
-            }
+        defineLazy(target, context, isolate, ns, value, value->getName());
+    }
+
+    v8::Local<v8::Value> BindingModule::processValue(
+        v8::Local<v8::Context> context, bind::Namespace* ns, bind::ValuePointer* value
+    ) {
+        v8::Isolate* isolate       = m_runtime->getIsolate();
+        DataTypeUserData& userData = value->getType()->getUserData<DataTypeUserData>();
+
+        CallContext cctx(isolate, context);
+        v8::Local<v8::Value> val = userData.marshaller->toV8(cctx, value->getAddress());
+
+        if (cctx.didAllocate()) {
+            error(
+                "Marshaller for data type '%s' of value '%s' from namespace '%s' had to allocate "
+                "memory in order to convert the provided value. This is currently unsupported, "
+                "since this memory is allocated on the stack and will be freed before the lifetime "
+                "of the bound value ends. The value will not be bound as a result.",
+                value->getType()->getName().c_str(),
+                value->getName().c_str(),
+                ns ? ns->getName().c_str() : "global"
+            );
         }
 
-        target->Set(context, v8::String::NewFromUtf8(isolate, value->getName().c_str()).ToLocalChecked(), val).Check();
+        return val;
     }
 
-    void BindingModule::processNamespace(bind::Namespace* ns) {
+    void BindingModule::processNamespace(
+        v8::Local<v8::Context> context, ModuleSystemModule* moduleSystem, bind::Namespace* ns
+    ) {
         if (ns->getCorrespondingType()) {
             return;
         }
 
         debug("Binding global namespace '%s' as module", ns->getName().c_str());
 
-        v8::Isolate* isolate           = m_runtime->getIsolate();
-        v8::Local<v8::Context> context = m_runtime->getContext();
-        v8::Local<v8::Object> exports  = v8::Object::New(isolate);
+        v8::Isolate* isolate          = m_runtime->getIsolate();
+        v8::Local<v8::Object> exports = v8::Object::New(isolate);
 
         const Array<bind::ISymbol*>& symbols = ns->getSymbols();
         for (bind::ISymbol* symbol : symbols) {
@@ -376,12 +560,11 @@ namespace tspp {
             exports->Set(context, v8::String::NewFromUtf8(isolate, "env").ToLocalChecked(), env).Check();
         }
 
-        m_runtime->registerBuiltInModule(ns->getName(), exports);
+        moduleSystem->registerBuiltInModule(ns->getName(), exports);
     }
 
-    v8::Local<v8::Function> BindingModule::processFunction(bind::Function* function) {
-        v8::Isolate* isolate           = m_runtime->getIsolate();
-        v8::Local<v8::Context> context = m_runtime->getContext();
+    v8::Local<v8::Function> BindingModule::processFunction(v8::Local<v8::Context> context, bind::Function* function) {
+        v8::Isolate* isolate = m_runtime->getIsolate();
 
         FunctionUserData& userData  = function->getUserData<FunctionUserData>();
         FunctionDocumentation* docs = userData.documentation;
@@ -397,28 +580,36 @@ namespace tspp {
             .ToLocalChecked();
     }
 
-    v8::Local<v8::Value> BindingModule::processDataType(bind::DataType* dataType) {
+    bool BindingModule::isExposedDataType(bind::DataType* dataType) {
         const bind::type_meta& meta = dataType->getInfo();
         if (meta.size == 0) {
-            return v8::Local<v8::Value>();
+            return false;
         }
         if (meta.is_pointer) {
-            return v8::Local<v8::Value>();
+            return false;
         }
         if (meta.is_primitive && !meta.is_enum) {
-            return v8::Local<v8::Value>();
+            return false;
         }
         if (meta.is_opaque) {
-            return v8::Local<v8::Value>();
+            return false;
         }
 
         DataTypeUserData& userData = dataType->getUserData<DataTypeUserData>();
         if (userData.typescriptType) {
+            return false;
+        }
+
+        return meta.is_enum || meta.is_trivially_constructible == 0;
+    }
+
+    v8::Local<v8::Value> BindingModule::processDataType(v8::Local<v8::Context> context, bind::DataType* dataType) {
+        if (!isExposedDataType(dataType)) {
             return v8::Local<v8::Value>();
         }
 
-        v8::Isolate* isolate           = m_runtime->getIsolate();
-        v8::Local<v8::Context> context = m_runtime->getContext();
+        const bind::type_meta& meta = dataType->getInfo();
+        v8::Isolate* isolate        = m_runtime->getIsolate();
 
         if (meta.is_enum) {
             v8::Local<v8::Object> obj = v8::Object::New(isolate);
@@ -446,17 +637,158 @@ namespace tspp {
             return obj;
         }
 
-        if (meta.is_trivially_constructible == 0) {
-            v8::Local<v8::FunctionTemplate> ctor = buildPrototype(isolate, dataType);
-            userData.javascriptData              = new JavaScriptTypeData();
-            userData.javascriptData->constructor.Reset(isolate, ctor);
-            userData.hostObjectManager = new HostObjectManager(dataType);
-            addNestedLogger(userData.hostObjectManager);
+        JavaScriptTypeData* typeData = getJavaScriptTypeData(isolate, dataType);
+        if (!typeData) {
+            return v8::Local<v8::Value>();
+        }
+
+        return typeData->constructor.Get(isolate)->GetFunction(context).ToLocalChecked();
+    }
+
+    /*
+     * Should be incremented whenever the emitted definitions change in a way that isn't
+     * reflected by the registry itself, so stale files are regenerated
+     */
+    static constexpr u32 BuiltInDefinitionsVersion = 3;
+
+    static void hashBytes(u64& hash, const void* data, size_t size) {
+        // FNV-1a
+        const u8* bytes = (const u8*)data;
+        for (size_t i = 0; i < size; i++) {
+            hash ^= bytes[i];
+            hash *= 0x100000001b3ull;
+        }
+    }
+
+    static void hashString(u64& hash, const String& str) {
+        u32 length = str.size();
+        hashBytes(hash, &length, sizeof(length));
+        hashBytes(hash, str.c_str(), length);
+    }
+
+    template <typename T>
+    static void hashValue(u64& hash, T value) {
+        hashBytes(hash, &value, sizeof(T));
+    }
+
+    u64 BindingModule::hashBindings(bind::Namespace* global) {
+        u64 hash = 0xcbf29ce484222325ull;
+        hashValue(hash, BuiltInDefinitionsVersion);
+        hashNamespace(hash, global);
+        return hash;
+    }
+
+    void BindingModule::hashNamespace(u64& hash, bind::Namespace* ns) {
+        hashString(hash, ns->getName());
+
+        const Array<bind::ISymbol*>& symbols = ns->getSymbols();
+        hashValue(hash, symbols.size());
+
+        for (bind::ISymbol* symbol : symbols) {
+            hashValue(hash, u32(symbol->getSymbolType()));
+
+            switch (symbol->getSymbolType()) {
+                case bind::SymbolType::Namespace: hashNamespace(hash, (bind::Namespace*)symbol); break;
+                case bind::SymbolType::Function: hashFunction(hash, (bind::Function*)symbol); break;
+                case bind::SymbolType::DataType: hashDataType(hash, (bind::DataType*)symbol); break;
+                case bind::SymbolType::Value: {
+                    bind::ValuePointer* value = (bind::ValuePointer*)symbol;
+                    hashString(hash, value->getName());
+                    hashString(hash, getTypeName(value->getType()));
+                    break;
+                }
+                default: break;
+            }
+        }
+    }
+
+    void BindingModule::hashFunction(u64& hash, bind::Function* function) {
+        hashString(hash, function->getName());
+        hashString(hash, getArgList(function));
+        hashString(hash, getTypeName(resolveType(function->getSignature()->getReturnType())));
+
+        FunctionDocumentation* docs = function->getUserData<FunctionUserData>().documentation;
+        hashValue(hash, docs != nullptr);
+        if (!docs) {
+            return;
+        }
+
+        hashString(hash, docs->desc());
+        hashString(hash, docs->returns());
+        hashValue(hash, docs->returnIsNullable());
+        hashValue(hash, docs->isAsync());
+
+        const Array<FunctionDocumentation::ParameterDocs>& params = docs->params();
+        hashValue(hash, params.size());
+        for (const FunctionDocumentation::ParameterDocs& param : params) {
+            hashString(hash, param.description);
+        }
+    }
+
+    void BindingModule::hashDataType(u64& hash, bind::DataType* dataType) {
+        const bind::type_meta& meta = dataType->getInfo();
+        DataTypeUserData& userData  = dataType->getUserData<DataTypeUserData>();
+
+        hashString(hash, dataType->getName());
+        hashValue(hash, meta.size);
+        hashValue(hash, bool(meta.is_enum));
+        hashValue(hash, bool(meta.is_primitive));
+        hashValue(hash, bool(meta.is_unsigned));
+        hashValue(hash, bool(meta.is_floating_point));
+        hashValue(hash, bool(meta.is_trivially_constructible));
+        hashValue(hash, bool(meta.is_function));
+        hashValue(hash, bool(meta.is_pointer));
+        hashValue(hash, bool(meta.is_opaque));
+        hashValue(hash, userData.typescriptType != nullptr);
+        hashValue(hash, userData.arrayElementType != nullptr);
+
+        DataTypeDocumentation* docs = userData.documentation;
+        hashValue(hash, docs != nullptr);
+        if (docs) {
+            hashString(hash, docs->desc());
+
+            const Array<DataTypeDocumentation::PropertyDocs>& properties = docs->properties();
+            hashValue(hash, properties.size());
+            for (const DataTypeDocumentation::PropertyDocs& property : properties) {
+                hashString(hash, property.name);
+                hashString(hash, property.description);
+            }
+        }
+
+        if (meta.is_enum) {
+            const Array<bind::EnumType::Field>& fields = ((bind::EnumType*)dataType)->getFields();
+            hashValue(hash, fields.size());
+            for (const bind::EnumType::Field& field : fields) {
+                hashString(hash, field.name);
+                hashValue(hash, field.value.i);
+            }
+            return;
+        }
 
-            return ctor->GetFunction(context).ToLocalChecked();
+        const Array<bind::DataType::BaseType>& bases = dataType->getBases();
+        hashValue(hash, bases.size());
+        for (const bind::DataType::BaseType& base : bases) {
+            hashString(hash, getTypeName(base.type));
         }
 
-        return v8::Local<v8::Value>();
+        const Array<bind::DataType::Property>& properties = dataType->getProps();
+        hashValue(hash, properties.size());
+        for (const bind::DataType::Property& property : properties) {
+            hashString(hash, property.name);
+            hashValue(hash, property.offset < 0);
+            hashValue(hash, bool(property.flags.is_static));
+            hashValue(hash, bool(property.flags.is_method));
+            hashValue(hash, bool(property.flags.is_pseudo_method));
+            hashValue(hash, bool(property.flags.is_ctor));
+            hashValue(hash, bool(property.flags.can_write));
+            hashValue(hash, property.address.get() != nullptr);
+
+            if (property.flags.is_ctor || property.flags.is_method || property.flags.is_pseudo_method) {
+                hashFunction(hash, (bind::Function*)property.address.get());
+            } else {
+                hashString(hash, getTypeName(property.type));
+            }
+        }
     }
 
     void BindingModule::emitNamespace(SourceFileBuilder& builder, bind::Namespace* ns) {
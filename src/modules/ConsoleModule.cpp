@@ -75,6 +75,22 @@ namespace tspp {
         m_inspector.reset();
     }
 
+    void ConsoleModule::onContextCreated(v8::Local<v8::Context> context, const String& name) {
+        if (!m_inspector) {
+            return;
+        }
+
+        m_inspector->contextCreated(v8_inspector::V8ContextInfo(context, 1, createStringView(name)));
+    }
+
+    void ConsoleModule::onContextDestroyed(v8::Local<v8::Context> context) {
+        if (!m_inspector) {
+            return;
+        }
+
+        m_inspector->contextDestroyed(context);
+    }
+
     void ConsoleModule::runMessageLoopOnPause(int contextGroupId) {
         // Not needed for console logging
     }
@@ -18,6 +18,9 @@
 using namespace std::chrono_literals;
 
 namespace tspp {
+    // How often the debugger socket should be serviced when the runtime is driven by a poll handle
+    static constexpr u32 DebuggerPollIntervalMs = 10;
+
     //////////////////////////////////////////////////////////////////////////
     // Helper functions
     //////////////////////////////////////////////////////////////////////////
@@ -164,6 +167,22 @@ namespace tspp {
         m_inspector.reset();
     }
 
+    void DebuggerModule::onContextCreated(v8::Local<v8::Context> context, const String& name) {
+        if (!m_inspector) {
+            return;
+        }
+
+        m_inspector->contextCreated(v8_inspector::V8ContextInfo(context, 1, createStringView(name)));
+    }
+
+    void DebuggerModule::onContextDestroyed(v8::Local<v8::Context> context) {
+        if (!m_inspector) {
+            return;
+        }
+
+        m_inspector->contextDestroyed(context);
+    }
+
     void DebuggerModule::service() {
         if (!m_socket) {
             return;
@@ -172,6 +191,17 @@ namespace tspp {
         m_socket->processEvents();
     }
 
+    bool DebuggerModule::getNextDeadline(std::chrono::high_resolution_clock::time_point& outDeadline) const {
+        if (!m_socket) {
+            return false;
+        }
+
+        // The socket's file descriptors belong to asio and can't be waited on from outside of it,
+        // so the socket is polled at a fixed interval while the debugger is enabled
+        outDeadline = std::chrono::high_resolution_clock::now() + std::chrono::milliseconds(DebuggerPollIntervalMs);
+        return true;
+    }
+
     //////////////////////////////////////////////////////////////////////////
     // V8InspectorClient
     //////////////////////////////////////////////////////////////////////////
@@ -1,8 +1,15 @@
 #include <tspp/modules/ModuleSystemModule.h>
 #include <tspp/systems/script.h>
+#include <tspp/tspp.h>
+#include <tspp/utils/ScriptStream.h>
+#include <tspp/utils/Trace.h>
 #include <utils/Array.hpp>
 #include <utils/Exception.h>
 
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
 namespace tspp {
     ModuleSystemModule::ModuleEntry& ModuleSystemModule::ModuleEntry::operator=(const ModuleEntry& other) {
         isolate = other.isolate;
@@ -168,12 +175,16 @@ namespace tspp {
         setupDefineFunction();
         setupRequireFunction();
 
+        m_moduleDirectory = m_runtime->getConfig().scriptRootDirectory;
+        m_moduleDirectory += "/internal/dist";
+
         return true;
     }
 
     void ModuleSystemModule::shutdown() {
         // Clear module registry
         m_modules.clear();
+        m_prefetched.clear();
 
         // Clear global function references
         m_defineFunc.Reset();
@@ -183,7 +194,7 @@ namespace tspp {
     void ModuleSystemModule::setupDefineFunction() {
         v8::Isolate* isolate = m_scriptSystem->getIsolate();
         v8::HandleScope scope(isolate);
-        v8::Local<v8::Context> context = m_scriptSystem->getContext();
+        v8::Local<v8::Context> context = getContext();
         v8::Context::Scope contextScope(context);
 
         // Create the define function
@@ -205,7 +216,7 @@ namespace tspp {
     void ModuleSystemModule::setupRequireFunction() {
         v8::Isolate* isolate = m_scriptSystem->getIsolate();
         v8::HandleScope scope(isolate);
-        v8::Local<v8::Context> context = m_scriptSystem->getContext();
+        v8::Local<v8::Context> context = getContext();
         v8::Context::Scope contextScope(context);
 
         // Create the require function
@@ -248,11 +259,16 @@ namespace tspp {
     ) {
         v8::Isolate* isolate = m_scriptSystem->getIsolate();
         v8::HandleScope scope(isolate);
-        v8::Local<v8::Context> context = m_scriptSystem->getContext();
+        v8::Local<v8::Context> context = getContext();
 
         // Generate a unique ID for anonymous modules if needed
         String moduleId = id;
-        if (moduleId.size() == 0) {
+        bool isFileBacked = false;
+        if (moduleId.size() == 0 && m_pendingModuleId.size() > 0) {
+            // Anonymous module defined by a file being loaded via loadModuleFile
+            moduleId     = m_pendingModuleId;
+            isFileBacked = true;
+        } else if (moduleId.size() == 0) {
             // For now, we'll just use a timestamp-based ID
             // In a real implementation, this would be based on the script URL
             moduleId = String::Format("anonymous_%lld", (long long)time(nullptr));
@@ -273,8 +289,18 @@ namespace tspp {
 
         // Add to registry
         m_modules[moduleId] = entry;
+        m_prefetched.erase(moduleId);
 
         debug("Defined module: %s", moduleId.c_str());
+
+        // Dependencies of file backed modules are most likely file backed as well, named modules come
+        // from bundles which define their dependencies themselves
+        if (isFileBacked) {
+            for (const String& depId : deps) {
+                prefetchModule(resolveModuleId(depId, moduleId));
+            }
+        }
+
         return true;
     }
 
@@ -294,9 +320,202 @@ namespace tspp {
     }
 
     String ModuleSystemModule::resolveModuleId(const String& id, const String& baseId) {
-        // For now, we'll just return the ID as-is
-        // In a real implementation, this would handle relative paths
-        return id;
+        // Only IDs that start with './' or '../' are relative
+        bool isRelative = (id.size() >= 2 && id[0] == '.' && id[1] == '/') ||
+                          (id.size() >= 3 && id[0] == '.' && id[1] == '.' && id[2] == '/');
+
+        if (!isRelative || baseId.size() == 0) {
+            return id;
+        }
+
+        // Relative IDs are resolved against the 'directory' of the base ID
+        Array<String> segments;
+        std::string base = baseId;
+        size_t lastSlash = base.rfind('/');
+        std::string combined = id;
+        if (lastSlash != std::string::npos) {
+            combined = base.substr(0, lastSlash + 1) + combined;
+        }
+
+        size_t start = 0;
+        while (start <= combined.size()) {
+            size_t end = combined.find('/', start);
+            if (end == std::string::npos) {
+                end = combined.size();
+            }
+
+            std::string segment = combined.substr(start, end - start);
+            if (segment == "..") {
+                if (segments.size() > 0 && segments.last() != "..") {
+                    segments.pop();
+                } else {
+                    segments.push(segment);
+                }
+            } else if (segment != "." && segment.size() > 0) {
+                segments.push(segment);
+            }
+
+            start = end + 1;
+        }
+
+        String resolved;
+        for (u32 i = 0; i < segments.size(); i++) {
+            if (i > 0) {
+                resolved += "/";
+            }
+
+            resolved += segments[i];
+        }
+
+        return resolved;
+    }
+
+    bool ModuleSystemModule::loadModuleFile(const String& filePath, const String& moduleId) {
+        std::ifstream file(filePath.c_str(), std::ios::in | std::ios::binary);
+        if (!file.is_open()) {
+            error("Failed to open module file '%s'", filePath.c_str());
+            return false;
+        }
+
+        std::stringstream buffer;
+        buffer << file.rdbuf();
+        String code = buffer.str();
+
+        v8::Isolate* isolate = m_scriptSystem->getIsolate();
+        v8::Isolate::Scope isolateScope(isolate);
+        v8::HandleScope scope(isolate);
+
+        // Files may be loaded while another one is executing, the outer file's id is restored after
+        String outerModuleId        = m_pendingModuleId;
+        m_pendingModuleId           = moduleId;
+        v8::Local<v8::Value> result = m_scriptSystem->executeString(getContext(), code, filePath);
+        m_pendingModuleId           = outerModuleId;
+
+        if (result.IsEmpty()) {
+            error("Failed to execute module file '%s'", filePath.c_str());
+            return false;
+        }
+
+        return true;
+    }
+
+    bool ModuleSystemModule::loadModuleDirectory(const String& directory) {
+        std::filesystem::path root(directory.c_str());
+        Array<String> ids;
+
+        setModuleDirectory(directory);
+
+        try {
+            if (!std::filesystem::is_directory(root)) {
+                error("Module directory '%s' does not exist", directory.c_str());
+                return false;
+            }
+
+            for (const auto& entry : std::filesystem::recursive_directory_iterator(root)) {
+                if (!entry.is_regular_file() || entry.path().extension() != ".js") {
+                    continue;
+                }
+
+                std::filesystem::path relative = entry.path().lexically_relative(root);
+                relative.replace_extension();
+
+                String id = relative.generic_string();
+                ids.push(id);
+
+                // Start reading and parsing every file before executing any of them
+                prefetchModule(id);
+            }
+        } catch (const std::filesystem::filesystem_error& e) {
+            error("Failed to load modules from '%s': %s", directory.c_str(), e.what());
+            return false;
+        }
+
+        bool success = true;
+        for (const String& id : ids) {
+            // May have been defined by a file that was executed before this one
+            if (m_modules.find(id) != m_modules.end()) {
+                continue;
+            }
+
+            if (!loadModuleFromFile(id)) {
+                success = false;
+            }
+        }
+
+        return success;
+    }
+
+    void ModuleSystemModule::setModuleDirectory(const String& directory) {
+        m_moduleDirectory = directory;
+    }
+
+    void ModuleSystemModule::prefetchModule(const String& id) {
+        if (id == "require" || id == "exports" || id == "module") {
+            return;
+        }
+
+        if (m_modules.find(id) != m_modules.end() || m_prefetched.find(id) != m_prefetched.end()) {
+            return;
+        }
+
+        String path = m_moduleDirectory;
+        path += "/";
+        path += id;
+        path += ".js";
+
+        std::shared_ptr<ScriptStream> stream = std::make_shared<ScriptStream>(path);
+        stream->begin(m_runtime);
+        m_prefetched[id] = stream;
+    }
+
+    bool ModuleSystemModule::loadModuleFromFile(const String& id) {
+        prefetchModule(id);
+
+        auto it = m_prefetched.find(id);
+        if (it == m_prefetched.end()) {
+            return false;
+        }
+
+        std::shared_ptr<ScriptStream> stream = it->second;
+        m_prefetched.erase(it);
+
+        return executeModuleStream(id, stream);
+    }
+
+    bool ModuleSystemModule::executeModuleStream(const String& id, const std::shared_ptr<ScriptStream>& stream) {
+        v8::Isolate* isolate = m_scriptSystem->getIsolate();
+        v8::Isolate::Scope isolateScope(isolate);
+        v8::HandleScope scope(isolate);
+        v8::Local<v8::Context> context = getContext();
+        v8::Context::Scope contextScope(context);
+
+        v8::TryCatch tryCatch(isolate);
+
+        v8::Local<v8::Script> script;
+        if (!stream->compile(context).ToLocal(&script)) {
+            if (stream->didReadFail()) {
+                // Not an error yet, the caller decides whether the module is missing
+                return false;
+            }
+
+            v8::String::Utf8Value msg(isolate, tryCatch.Exception());
+            error("Failed to compile module file '%s': %s", stream->getFilename().c_str(), *msg);
+            return false;
+        }
+
+        // Files may be loaded while another one is executing, the outer file's id is restored after
+        String outerModuleId             = m_pendingModuleId;
+        m_pendingModuleId                = id;
+        v8::MaybeLocal<v8::Value> result = script->Run(context);
+        m_pendingModuleId                = outerModuleId;
+
+        if (result.IsEmpty()) {
+            v8::String::Utf8Value msg(isolate, tryCatch.Exception());
+            error("Failed to execute module file '%s': %s", stream->getFilename().c_str(), *msg);
+            return false;
+        }
+
+        return true;
     }
 
     bool ModuleSystemModule::findCircularDependencyPath(
@@ -320,15 +539,21 @@ namespace tspp {
     }
 
     v8::Local<v8::Value> ModuleSystemModule::loadModule(const String& id) {
+        Trace::Scope trace("tspp", "ModuleSystemModule::loadModule");
+
         v8::Isolate* isolate = m_scriptSystem->getIsolate();
         v8::Isolate::Scope isolateScope(isolate);
 
         v8::EscapableHandleScope scope(isolate);
-        v8::Local<v8::Context> context = m_scriptSystem->getContext();
+        v8::Local<v8::Context> context = getContext();
         v8::Context::Scope contextScope(context);
 
-        // Check if module exists
+        // Check if module exists, or can be loaded from its file
         auto it = m_modules.find(id);
+        if (it == m_modules.end() && loadModuleFromFile(id)) {
+            it = m_modules.find(id);
+        }
+
         if (it == m_modules.end()) {
             // Module not found
             error("Module '%s' not found", id.c_str());
@@ -443,7 +668,7 @@ namespace tspp {
     ) {
         v8::Isolate* isolate = m_scriptSystem->getIsolate();
         v8::HandleScope scope(isolate);
-        v8::Local<v8::Context> context = m_scriptSystem->getContext();
+        v8::Local<v8::Context> context = getContext();
 
         // Set id property on module object
         moduleObj
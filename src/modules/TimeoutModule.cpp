@@ -1,5 +1,10 @@
 #include <tspp/modules/TimeoutModule.h>
 #include <tspp/systems/script.h>
+#include <tspp/tspp.h>
+#include <tspp/utils/EventLoopMonitor.h>
+#include <tspp/utils/PollHandle.h>
+#include <tspp/utils/Trace.h>
+#include <tspp/utils/Watchdog.h>
 
 #include <utils/Array.hpp>
 
@@ -114,7 +119,7 @@ namespace tspp {
         v8::Isolate::Scope isolate_scope(isolate);
         v8::EscapableHandleScope handle_scope(isolate);
 
-        v8::Local<v8::Context> context = m_scriptSystem->getContext();
+        v8::Local<v8::Context> context = getContext();
         v8::Context::Scope context_scope(context);
 
         v8::MaybeLocal<v8::Function> maybeTimeoutFunc =
@@ -174,11 +179,13 @@ namespace tspp {
     }
 
     void TimeoutModule::service() {
+        Trace::Scope trace("tspp", "TimeoutModule::service");
+
         Clock::time_point now = Clock::now();
         v8::Isolate* isolate  = m_scriptSystem->getIsolate();
         v8::Isolate::Scope isolate_scope(isolate);
         v8::HandleScope handle_scope(isolate);
-        v8::Context::Scope context_scope(m_scriptSystem->getContext());
+        v8::Context::Scope context_scope(getContext());
 
         struct CachedInterval {
             public:
@@ -187,10 +194,18 @@ namespace tspp {
         };
 
         Array<CachedInterval> cache;
+        EventLoopMonitor* monitor = EventLoopMonitor::Get(isolate);
 
         Interval* i = m_intervals;
         while (i) {
             if (i->nextExecutionAt <= now) {
+                // How late the timer is firing is how long the event loop was kept from getting to it
+                if (monitor) {
+                    monitor->recordLag(
+                        std::chrono::duration_cast<std::chrono::microseconds>(now - i->nextExecutionAt).count()
+                    );
+                }
+
                 if (!i->justOnce) {
                     std::chrono::milliseconds delayMS = std::chrono::milliseconds(i->delayMS);
                     Clock::time_point nextExecutionAt = i->nextExecutionAt + delayMS;
@@ -222,6 +237,8 @@ namespace tspp {
                 continue;
             }
 
+            Watchdog::Scope watchdogScope(Watchdog::Get(isolate), "timer callback");
+            EventLoopMonitor::Scope monitorScope(monitor, "timer callback");
             v8::Local<v8::Function> function = i->function.Get(isolate);
             if (i->args) {
                 Array<v8::Local<v8::Value>> args(i->argCount);
@@ -229,12 +246,12 @@ namespace tspp {
                     args.push(i->args[j].Get(isolate));
                 }
 
-                function->Call(m_scriptSystem->getContext(), v8::Null(isolate), args.size(), args.data());
+                function->Call(getContext(), v8::Null(isolate), args.size(), args.data());
                 if (c.remove) {
                     clearInterval(c.id);
                 }
             } else {
-                function->Call(m_scriptSystem->getContext(), v8::Null(isolate), 0, nullptr);
+                function->Call(getContext(), v8::Null(isolate), 0, nullptr);
                 if (c.remove) {
                     clearInterval(c.id);
                 }
@@ -242,6 +259,19 @@ namespace tspp {
         }
     }
 
+    bool TimeoutModule::getNextDeadline(Clock::time_point& outDeadline) const {
+        bool hasDeadline = false;
+
+        for (Interval* i = m_intervals; i; i = i->next) {
+            if (!hasDeadline || i->nextExecutionAt < outDeadline) {
+                outDeadline = i->nextExecutionAt;
+                hasDeadline = true;
+            }
+        }
+
+        return hasDeadline;
+    }
+
     u32 TimeoutModule::setInterval(
         v8::Isolate* isolate,
         const v8::Local<v8::Function>& function,
@@ -270,6 +300,13 @@ namespace tspp {
 
         m_intervals = interval;
 
+        // Timers can be set outside of Runtime::service, the embedder's poll handle must still
+        // become ready when they're due
+        Runtime* runtime = Runtime::Get(isolate);
+        if (runtime && runtime->getPollHandle()) {
+            runtime->getPollHandle()->setDeadlineIfEarlier(interval->nextExecutionAt);
+        }
+
         return interval->id;
     }
 
@@ -1,7 +1,10 @@
 #include <tspp/builtin/compiler.h>
 #include <tspp/builtin/tsc.h>
 #include <tspp/modules/TypeScriptCompilerModule.h>
+#include <tspp/systems/script.h>
 #include <tspp/tspp.h>
+#include <tspp/utils/ScriptStream.h>
+#include <tspp/utils/Trace.h>
 
 #include <stdio.h>
 
@@ -16,11 +19,12 @@ namespace tspp {
     }
 
     bool TypeScriptCompilerModule::initialize() {
-        // Load the TypeScript compiler
-        if (!loadCompiler()) {
-            error("Failed to load TypeScript compiler");
-            return false;
-        }
+        // Start parsing the TypeScript compiler, it's executed once the bindings are committed
+        String compilerCode;
+        compilerCode.copy((const char*)tsc_code, tsc_code_len);
+
+        m_compilerStream = std::make_shared<ScriptStream>("tsc.js", compilerCode);
+        m_compilerStream->begin(m_runtime);
 
         // Load the compilation functions
         if (!loadCompilationShims()) {
@@ -28,11 +32,18 @@ namespace tspp {
             return false;
         }
 
-        debug("TypeScript compiler initialized (version %s)", m_version.c_str());
         return true;
     }
 
     bool TypeScriptCompilerModule::onAfterBindings() {
+        // Load the TypeScript compiler
+        if (!loadCompiler()) {
+            error("Failed to load TypeScript compiler");
+            return false;
+        }
+
+        debug("TypeScript compiler initialized (version %s)", m_version.c_str());
+
         v8::Isolate* isolate = m_runtime->getIsolate();
         v8::HandleScope scope(isolate);
         v8::Local<v8::Context> context = m_runtime->getContext();
@@ -71,28 +82,42 @@ namespace tspp {
 
         m_compileDirectory.Reset(isolate, compileDirectory.As<v8::Function>());
 
+        v8::Local<v8::Value> transpileDirectory;
+        factoryResult->Get(context, v8::String::NewFromUtf8(isolate, "transpileDirectory").ToLocalChecked())
+            .ToLocal(&transpileDirectory);
+
+        if (transpileDirectory.IsEmpty() || !transpileDirectory->IsFunction()) {
+            error("transpileDirectory function not found");
+            return false;
+        }
+
+        m_transpileDirectory.Reset(isolate, transpileDirectory.As<v8::Function>());
+
         return true;
     }
 
     void TypeScriptCompilerModule::shutdown() {
+        m_compilerStream.reset();
         m_tsCompiler.Reset();
         m_compileFile.Reset();
         m_compileDirectory.Reset();
+        m_transpileDirectory.Reset();
         m_compileFuncFactory.Reset();
     }
 
     bool TypeScriptCompilerModule::loadCompiler() {
-        try {
-            // Read the TypeScript compiler code
-            String compilerCode;
-            compilerCode.copy((const char*)tsc_code, tsc_code_len);
+        Trace::Scope trace("tspp", "TypeScriptCompilerModule::loadCompiler");
 
-            // Execute the TypeScript compiler code
+        try {
+            // Execute the TypeScript compiler code, waiting for it to finish parsing if necessary
             v8::Isolate* isolate = m_runtime->getIsolate();
             v8::HandleScope scope(isolate);
             v8::Local<v8::Context> context = m_runtime->getContext();
 
-            v8::Local<v8::Value> result = m_runtime->executeString(compilerCode, "tsc.js");
+            std::shared_ptr<ScriptStream> stream = m_compilerStream;
+            m_compilerStream.reset();
+
+            v8::Local<v8::Value> result = m_scriptSystem->executeStream(stream);
             if (result.IsEmpty()) {
                 error("Failed to execute TypeScript compiler code");
                 return false;
@@ -194,19 +219,29 @@ namespace tspp {
     }
 
     bool TypeScriptCompilerModule::compileDirectory(const String& path) {
+        Trace::Scope trace("tspp", "TypeScriptCompilerModule::compileDirectory");
         debug("Compiling TypeScript project in %s", path.c_str());
+        return callDirectoryFunction(m_compileDirectory, path);
+    }
+
+    bool TypeScriptCompilerModule::transpileDirectory(const String& path) {
+        debug("Transpiling TypeScript project in %s", path.c_str());
+        return callDirectoryFunction(m_transpileDirectory, path);
+    }
+
+    bool TypeScriptCompilerModule::callDirectoryFunction(v8::Global<v8::Function>& func, const String& path) {
         v8::Isolate* isolate = m_runtime->getIsolate();
         v8::Isolate::Scope isolateScope(isolate);
         v8::HandleScope scope(isolate);
         v8::Local<v8::Context> context = m_runtime->getContext();
 
         try {
-            v8::Local<v8::Function> compileDirectory = m_compileDirectory.Get(isolate);
+            v8::Local<v8::Function> directoryFunc = func.Get(isolate);
 
             v8::Local<v8::Value> args[] = {v8::String::NewFromUtf8(isolate, path.c_str()).ToLocalChecked()};
 
             std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
-            v8::MaybeLocal<v8::Value> maybeResult = compileDirectory->Call(context, v8::Null(isolate), 1, args);
+            v8::MaybeLocal<v8::Value> maybeResult = directoryFunc->Call(context, v8::Null(isolate), 1, args);
             std::chrono::high_resolution_clock::time_point end = std::chrono::high_resolution_clock::now();
             u32 duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
 
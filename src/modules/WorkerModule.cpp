@@ -0,0 +1,590 @@
+#include <tspp/modules/WorkerModule.h>
+#include <tspp/systems/script.h>
+#include <tspp/tspp.h>
+#include <tspp/utils/PollHandle.h>
+#include <tspp/utils/StructuredClone.h>
+#include <tspp/utils/Thread.h>
+#include <tspp/utils/Trace.h>
+#include <tspp/utils/Watchdog.h>
+
+#include <utils/Array.hpp>
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+namespace tspp {
+    struct WorkerMessage {
+        public:
+            SerializedValue value;
+
+            // Errors are reported to the parent's onerror handler instead of onmessage
+            bool isError;
+            String error;
+    };
+
+    struct WorkerModule::WorkerState {
+        public:
+            String moduleId;
+            RuntimeConfig config;
+            WorkerModule* parent;
+
+            // Signaled when there's something for the parent to handle, may be null
+            PollHandle* parentPollHandle;
+
+            std::mutex mutex;
+            std::condition_variable condition;
+            std::deque<WorkerMessage> toWorker;
+            std::deque<WorkerMessage> toParent;
+
+            // Only set while the worker's runtime is initialized, so it can be terminated and woken
+            v8::Isolate* isolate;
+            PollHandle* pollHandle;
+            bool isTerminating;
+            bool isRunning;
+
+            // Declared last so that it's destroyed first, the thread uses everything above
+            Thread thread;
+    };
+
+    static void throwError(v8::Isolate* isolate, const char* message) {
+        isolate->ThrowException(v8::Exception::Error(v8::String::NewFromUtf8(isolate, message).ToLocalChecked()));
+    }
+
+    static String getExceptionMessage(v8::Isolate* isolate, const v8::TryCatch& tryCatch) {
+        v8::String::Utf8Value msg(isolate, tryCatch.Exception());
+        return *msg ? String(*msg) : String("Unknown error");
+    }
+
+    /*
+     * Calls target[handlerName](event) if the handler is a function. Returns false and sets
+     * outError if the handler threw.
+     */
+    static bool dispatchEvent(
+        v8::Isolate* isolate,
+        v8::Local<v8::Context> context,
+        v8::Local<v8::Object> target,
+        const char* handlerName,
+        v8::Local<v8::Object> event,
+        String& outError
+    ) {
+        v8::TryCatch tryCatch(isolate);
+
+        v8::Local<v8::Value> handler;
+        if (!target->Get(context, v8::String::NewFromUtf8(isolate, handlerName).ToLocalChecked()).ToLocal(&handler)) {
+            outError = getExceptionMessage(isolate, tryCatch);
+            return false;
+        }
+
+        if (!handler->IsFunction()) {
+            return true;
+        }
+
+        Watchdog::Scope watchdogScope(Watchdog::Get(isolate), "worker message");
+        v8::Local<v8::Value> args[] = {event};
+        if (handler.As<v8::Function>()->Call(context, target, 1, args).IsEmpty()) {
+            if (tryCatch.HasTerminated()) {
+                return true;
+            }
+
+            outError = getExceptionMessage(isolate, tryCatch);
+            return false;
+        }
+
+        return true;
+    }
+
+    static v8::Local<v8::Object> createEvent(
+        v8::Isolate* isolate, v8::Local<v8::Context> context, const char* key, v8::Local<v8::Value> value
+    ) {
+        v8::Local<v8::Object> event = v8::Object::New(isolate);
+        event->Set(context, v8::String::NewFromUtf8(isolate, key).ToLocalChecked(), value).Check();
+        return event;
+    }
+
+    static void postToQueue(
+        const v8::FunctionCallbackInfo<v8::Value>& args, std::mutex& mutex, std::deque<WorkerMessage>& queue
+    ) {
+        v8::Isolate* isolate           = args.GetIsolate();
+        v8::Local<v8::Context> context = isolate->GetCurrentContext();
+
+        WorkerMessage message;
+        message.isError = false;
+
+        v8::Local<v8::Value> value        = args.Length() > 0 ? args[0] : v8::Undefined(isolate).As<v8::Value>();
+        v8::Local<v8::Value> transferList = args.Length() > 1 ? args[1] : v8::Local<v8::Value>();
+        if (!message.value.serialize(context, value, transferList)) {
+            // Exception was thrown by the serializer
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        queue.push_back(std::move(message));
+    }
+
+    static void postError(WorkerModule::WorkerState* state, const String& error);
+
+    static void wakeParent(WorkerModule::WorkerState* state) {
+        if (state->parentPollHandle) {
+            state->parentPollHandle->signal();
+        }
+    }
+
+    /*
+     * Must be called with the state's mutex held
+     */
+    static void wakeWorker(WorkerModule::WorkerState* state) {
+        state->condition.notify_all();
+
+        if (state->pollHandle) {
+            state->pollHandle->signal();
+        }
+    }
+
+    //
+    // Worker side
+    //
+
+    static void WorkerPostMessage(const v8::FunctionCallbackInfo<v8::Value>& args) {
+        WorkerModule::WorkerState* state = (WorkerModule::WorkerState*)args.Data().As<v8::External>()->Value();
+        postToQueue(args, state->mutex, state->toParent);
+        wakeParent(state);
+    }
+
+    static void WorkerClose(const v8::FunctionCallbackInfo<v8::Value>& args) {
+        WorkerModule::WorkerState* state = (WorkerModule::WorkerState*)args.Data().As<v8::External>()->Value();
+
+        // The worker stops once the current task returns
+        std::lock_guard<std::mutex> lock(state->mutex);
+        state->isTerminating = true;
+    }
+
+    static void postError(WorkerModule::WorkerState* state, const String& error) {
+        WorkerMessage message;
+        message.isError = true;
+        message.error   = error;
+
+        {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            state->toParent.push_back(std::move(message));
+        }
+
+        wakeParent(state);
+    }
+
+    static bool installWorkerGlobals(Runtime* runtime, WorkerModule::WorkerState* state) {
+        v8::Isolate* isolate = runtime->getIsolate();
+        v8::Isolate::Scope isolateScope(isolate);
+        v8::HandleScope scope(isolate);
+        v8::Local<v8::Context> context = runtime->getContext();
+        v8::Context::Scope contextScope(context);
+
+        v8::Local<v8::Object> global = context->Global();
+        v8::Local<v8::External> data = v8::External::New(isolate, state);
+
+        v8::Local<v8::Function> postMessage;
+        v8::Local<v8::Function> close;
+        if (!v8::Function::New(context, WorkerPostMessage, data).ToLocal(&postMessage) ||
+            !v8::Function::New(context, WorkerClose, data).ToLocal(&close)) {
+            return false;
+        }
+
+        global->Set(context, v8::String::NewFromUtf8(isolate, "postMessage").ToLocalChecked(), postMessage).Check();
+        global->Set(context, v8::String::NewFromUtf8(isolate, "close").ToLocalChecked(), close).Check();
+        global->Set(context, v8::String::NewFromUtf8(isolate, "self").ToLocalChecked(), global).Check();
+        global->Set(context, v8::String::NewFromUtf8(isolate, "onmessage").ToLocalChecked(), v8::Null(isolate))
+            .Check();
+
+        return true;
+    }
+
+    void WorkerModule::RunWorker(WorkerState* state) {
+        Trace::SetThreadName("Worker");
+        Runtime runtime(state->config);
+
+        {
+            // Workers may start at the same time as each other
+            static std::mutex s_loggerMutex;
+            std::lock_guard<std::mutex> lock(s_loggerMutex);
+            state->parent->addNestedLogger(&runtime);
+        }
+
+        if (!runtime.initialize()) {
+            postError(state, "Failed to initialize worker runtime");
+
+            {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                state->isRunning = false;
+            }
+
+            wakeParent(state);
+            return;
+        }
+
+        runtime.commitBindings();
+
+        bool didStart = installWorkerGlobals(&runtime, state);
+        if (!didStart) {
+            postError(state, "Failed to define worker globals");
+        }
+
+        if (didStart && !runtime.buildProject()) {
+            postError(state, "Failed to load project output in worker");
+            didStart = false;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            state->isolate    = runtime.getIsolate();
+            state->pollHandle = runtime.getPollHandle();
+            didStart          = didStart && !state->isTerminating;
+        }
+
+        PollHandle* pollHandle = runtime.getPollHandle();
+
+        v8::Isolate* isolate = runtime.getIsolate();
+
+        if (didStart) {
+            v8::Isolate::Scope isolateScope(isolate);
+            v8::HandleScope scope(isolate);
+            v8::Local<v8::Context> context = runtime.getContext();
+            v8::Context::Scope contextScope(context);
+
+            v8::TryCatch tryCatch(isolate);
+            runtime.requireModule(state->moduleId);
+
+            if (tryCatch.HasCaught() && !tryCatch.HasTerminated()) {
+                postError(state, getExceptionMessage(isolate, tryCatch));
+            }
+        }
+
+        std::deque<WorkerMessage> incoming;
+        while (didStart) {
+            {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                if (state->isTerminating) {
+                    break;
+                }
+
+                std::swap(incoming, state->toWorker);
+            }
+
+            for (WorkerMessage& message : incoming) {
+                v8::Isolate::Scope isolateScope(isolate);
+                v8::HandleScope scope(isolate);
+                v8::Local<v8::Context> context = runtime.getContext();
+                v8::Context::Scope contextScope(context);
+
+                v8::TryCatch tryCatch(isolate);
+                v8::Local<v8::Value> data;
+                if (!message.value.deserialize(context).ToLocal(&data)) {
+                    postError(state, getExceptionMessage(isolate, tryCatch));
+                    continue;
+                }
+
+                String error;
+                v8::Local<v8::Object> event = createEvent(isolate, context, "data", data);
+                if (!dispatchEvent(isolate, context, context->Global(), "onmessage", event, error)) {
+                    postError(state, error);
+                }
+            }
+
+            bool didHaveWork = runtime.service() || incoming.size() > 0;
+            incoming.clear();
+
+            if (didHaveWork) {
+                continue;
+            }
+
+            // Messages posted before the runtime cleared its poll handle at the start of service
+            // wouldn't wake it again
+            std::unique_lock<std::mutex> lock(state->mutex);
+            if (state->isTerminating || state->toWorker.size() > 0) {
+                continue;
+            }
+
+            if (pollHandle) {
+                // Ready when a message is posted, the worker is terminated or the runtime has work
+                // of its own such as a completed job or a timer that's due
+                lock.unlock();
+                if (pollHandle->wait()) {
+                    continue;
+                }
+
+                lock.lock();
+            }
+
+            // Poll handles aren't supported on every platform
+            state->condition.wait_for(lock, std::chrono::milliseconds(1), [state]() {
+                return state->isTerminating || state->toWorker.size() > 0;
+            });
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            state->isolate    = nullptr;
+            state->pollHandle = nullptr;
+        }
+
+        runtime.shutdown();
+
+        {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            state->isRunning = false;
+        }
+
+        // Lets the parent clean the worker up
+        wakeParent(state);
+    }
+
+    //
+    // Parent side
+    //
+
+    WorkerModule::WorkerModule(ScriptSystem* scriptSystem, Runtime* runtime)
+        : IScriptSystemModule(scriptSystem, "Worker", "Worker") {
+        m_runtime = runtime;
+    }
+
+    WorkerModule::~WorkerModule() {
+        shutdown();
+    }
+
+    bool WorkerModule::initialize() {
+        v8::Isolate* isolate = m_scriptSystem->getIsolate();
+        v8::Isolate::Scope isolateScope(isolate);
+        v8::HandleScope scope(isolate);
+        v8::Local<v8::Context> context = m_scriptSystem->getContext();
+        v8::Context::Scope contextScope(context);
+
+        v8::Local<v8::External> data      = v8::External::New(isolate, this);
+        v8::Local<v8::FunctionTemplate> t = v8::FunctionTemplate::New(isolate, Construct, data);
+        t->SetClassName(v8::String::NewFromUtf8(isolate, "Worker").ToLocalChecked());
+        t->InstanceTemplate()->SetInternalFieldCount(1);
+
+        v8::Local<v8::ObjectTemplate> proto = t->PrototypeTemplate();
+        proto->Set(isolate, "postMessage", v8::FunctionTemplate::New(isolate, PostMessage, data));
+        proto->Set(isolate, "terminate", v8::FunctionTemplate::New(isolate, Terminate, data));
+
+        v8::Local<v8::Function> ctor;
+        if (!t->GetFunction(context).ToLocal(&ctor)) {
+            error("Failed to create Worker class");
+            return false;
+        }
+
+        context->Global()->Set(context, v8::String::NewFromUtf8(isolate, "Worker").ToLocalChecked(), ctor).Check();
+        return true;
+    }
+
+    void WorkerModule::shutdown() {
+        for (WorkerHandle* handle : m_workers) {
+            terminate(handle);
+            release(handle);
+        }
+
+        m_workers.clear();
+    }
+
+    void WorkerModule::service() {
+        if (m_workers.size() == 0) {
+            return;
+        }
+
+        v8::Isolate* isolate = m_scriptSystem->getIsolate();
+        v8::Isolate::Scope isolateScope(isolate);
+        v8::HandleScope scope(isolate);
+        v8::Local<v8::Context> context = m_scriptSystem->getContext();
+        v8::Context::Scope contextScope(context);
+
+        std::deque<WorkerMessage> incoming;
+
+        // Handlers may start or terminate workers, so iterate over a copy
+        Array<WorkerHandle*> workers = m_workers;
+        for (WorkerHandle* handle : workers) {
+            bool isRunning = false;
+            {
+                std::lock_guard<std::mutex> lock(handle->state->mutex);
+                std::swap(incoming, handle->state->toParent);
+                isRunning = handle->state->isRunning;
+            }
+
+            for (WorkerMessage& message : incoming) {
+                if (handle->object.IsEmpty()) {
+                    break;
+                }
+
+                v8::Local<v8::Object> target = handle->object.Get(isolate);
+                v8::Local<v8::Object> event;
+                const char* handlerName = "onmessage";
+
+                if (message.isError) {
+                    handlerName = "onerror";
+                    event       = createEvent(
+                        isolate,
+                        context,
+                        "message",
+                        v8::String::NewFromUtf8(isolate, message.error.c_str()).ToLocalChecked()
+                    );
+
+                    v8::Local<v8::Value> handler;
+                    if (!target->Get(context, v8::String::NewFromUtf8(isolate, handlerName).ToLocalChecked())
+                             .ToLocal(&handler) ||
+                        !handler->IsFunction()) {
+                        error("Uncaught error in worker '%s': %s", handle->state->moduleId.c_str(), message.error.c_str());
+                        continue;
+                    }
+                } else {
+                    v8::TryCatch tryCatch(isolate);
+                    v8::Local<v8::Value> data;
+                    if (!message.value.deserialize(context).ToLocal(&data)) {
+                        error("Failed to deserialize message from worker: %s", getExceptionMessage(isolate, tryCatch).c_str());
+                        continue;
+                    }
+
+                    event = createEvent(isolate, context, "data", data);
+                }
+
+                String handlerError;
+                if (!dispatchEvent(isolate, context, target, handlerName, event, handlerError)) {
+                    error("Uncaught error in worker %s handler: %s", handlerName, handlerError.c_str());
+                }
+            }
+
+            incoming.clear();
+
+            if (!isRunning) {
+                // The worker closed itself or failed to start, and everything it sent has been delivered
+                if (removeHandle(handle)) {
+                    release(handle);
+                }
+            }
+        }
+    }
+
+    u32 WorkerModule::getWorkerCount() const {
+        return m_workers.size();
+    }
+
+    WorkerModule::WorkerHandle* WorkerModule::getHandle(const v8::FunctionCallbackInfo<v8::Value>& args) {
+        v8::Local<v8::Object> self = args.This();
+        if (self.IsEmpty() || self->InternalFieldCount() < 1) {
+            throwError(args.GetIsolate(), "'this' is not a Worker");
+            return nullptr;
+        }
+
+        return (WorkerHandle*)self->GetAlignedPointerFromInternalField(0);
+    }
+
+    void WorkerModule::Construct(const v8::FunctionCallbackInfo<v8::Value>& args) {
+        v8::Isolate* isolate = args.GetIsolate();
+        WorkerModule* module = (WorkerModule*)args.Data().As<v8::External>()->Value();
+
+        if (!args.IsConstructCall()) {
+            throwError(isolate, "Worker constructor must be called with 'new'");
+            return;
+        }
+
+        if (args.Length() < 1 || !args[0]->IsString()) {
+            throwError(isolate, "Worker constructor expects a module id");
+            return;
+        }
+
+        v8::String::Utf8Value moduleId(isolate, args[0]);
+
+        WorkerHandle* handle    = new WorkerHandle();
+        handle->state           = std::make_shared<WorkerState>();
+        WorkerState* state      = handle->state.get();
+        state->moduleId         = *moduleId;
+        state->config           = module->m_runtime->getConfig();
+        state->parent           = module;
+        state->parentPollHandle = module->m_runtime->getPollHandle();
+        state->isolate          = nullptr;
+        state->pollHandle       = nullptr;
+        state->isTerminating    = false;
+        state->isRunning        = true;
+
+        // Workers load the output that the parent already built, can't be debugged separately and
+        // sleep on their poll handle while they're idle
+        state->config.buildMode                   = BuildMode::Prebuilt;
+        state->config.scriptConfig.enableDebugger = false;
+        state->config.enablePollHandle            = true;
+
+        v8::Local<v8::Object> self = args.This();
+        self->SetAlignedPointerInInternalField(0, handle);
+        handle->object.Reset(isolate, self);
+        module->m_workers.push(handle);
+
+        // The handle owns the state, release() joins the thread before destroying it
+        state->thread.reset([state]() { RunWorker(state); });
+    }
+
+    void WorkerModule::PostMessage(const v8::FunctionCallbackInfo<v8::Value>& args) {
+        WorkerHandle* handle = getHandle(args);
+        if (!handle) {
+            return;
+        }
+
+        WorkerState* state = handle->state.get();
+        postToQueue(args, state->mutex, state->toWorker);
+
+        std::lock_guard<std::mutex> lock(state->mutex);
+        wakeWorker(state);
+    }
+
+    void WorkerModule::Terminate(const v8::FunctionCallbackInfo<v8::Value>& args) {
+        WorkerModule* module = (WorkerModule*)args.Data().As<v8::External>()->Value();
+        WorkerHandle* handle = getHandle(args);
+        if (!handle) {
+            return;
+        }
+
+        module->removeHandle(handle);
+        module->terminate(handle);
+        module->release(handle);
+    }
+
+    bool WorkerModule::removeHandle(WorkerHandle* handle) {
+        for (u32 i = 0; i < m_workers.size(); i++) {
+            if (m_workers[i] == handle) {
+                m_workers.remove(i);
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void WorkerModule::terminate(WorkerHandle* handle) {
+        WorkerState* state = handle->state.get();
+
+        {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            state->isTerminating = true;
+
+            // Interrupts any script that's currently running in the worker
+            if (state->isolate) {
+                state->isolate->TerminateExecution();
+            }
+
+            wakeWorker(state);
+        }
+
+        state->thread.waitForExit();
+    }
+
+    void WorkerModule::release(WorkerHandle* handle) {
+        if (!handle->object.IsEmpty()) {
+            // The JS object may outlive the worker, calls to its methods become no-ops
+            v8::Isolate* isolate = m_scriptSystem->getIsolate();
+            v8::HandleScope scope(isolate);
+            handle->object.Get(isolate)->SetAlignedPointerInInternalField(0, nullptr);
+            handle->object.Reset();
+        }
+
+        // The worker has been told to stop or has already finished, either way it must exit before
+        // its state is destroyed
+        handle->state->thread.waitForExit();
+        delete handle;
+    }
+}
@@ -0,0 +1,294 @@
+#include <tspp/pool.h>
+#include <tspp/tspp.h>
+#include <tspp/utils/PollHandle.h>
+#include <tspp/utils/Trace.h>
+#include <utils/Array.hpp>
+#include <utils/Exception.h>
+
+#include <chrono>
+
+namespace tspp {
+    RuntimePool::RuntimePool(const RuntimePoolConfig& config) : IWithLogging("RuntimePool") {
+        m_config      = config;
+        m_nextRuntime    = 0;
+        m_threadPoolSize = 0;
+        m_initialized    = false;
+    }
+
+    RuntimePool::~RuntimePool() {
+        shutdown();
+    }
+
+    bool RuntimePool::initialize(const Task& setup) {
+        if (m_initialized) {
+            return true;
+        }
+
+        u32 runtimeCount = m_config.runtimeCount;
+        if (runtimeCount == 0) {
+            runtimeCount = Thread::MaxHardwareThreads();
+        }
+
+        if (runtimeCount == 0) {
+            runtimeCount = 1;
+        }
+
+        debug("Initializing %u runtimes", runtimeCount);
+
+        // Each runtime has its own thread pool, one per hardware thread each would oversubscribe the CPUs
+        m_threadPoolSize = m_config.runtimeConfig.threadPoolSize;
+        if (m_threadPoolSize == 0) {
+            m_threadPoolSize = Thread::MaxHardwareThreads() / runtimeCount;
+            if (m_threadPoolSize == 0) {
+                m_threadPoolSize = 1;
+            }
+        }
+
+        m_initialized = true;
+
+        for (u32 i = 0; i < runtimeCount; i++) {
+            Slot* slot         = new Slot();
+            slot->index        = i;
+            slot->runtime      = nullptr;
+            slot->pendingCount = 0;
+            slot->doStop       = false;
+            slot->isReady      = false;
+            slot->didFail      = false;
+            m_slots.push(slot);
+
+            slot->thread.reset([this, slot, setup]() { run(slot, setup); });
+
+            std::unique_lock<std::mutex> lock(slot->mutex);
+            slot->condition.wait(lock, [slot]() { return slot->isReady; });
+
+            if (slot->didFail) {
+                lock.unlock();
+
+                error("Failed to initialize runtime %u", i);
+                shutdown();
+                return false;
+            }
+        }
+
+        debug("Initialized");
+        return true;
+    }
+
+    void RuntimePool::shutdown() {
+        if (!m_initialized) {
+            return;
+        }
+
+        debug("Shutting down");
+
+        for (Slot* slot : m_slots) {
+            std::lock_guard<std::mutex> lock(slot->mutex);
+            slot->doStop = true;
+            wake(slot);
+        }
+
+        for (Slot* slot : m_slots) {
+            slot->thread.waitForExit();
+            delete slot;
+        }
+
+        m_slots.clear();
+        m_nextRuntime = 0;
+        m_initialized = false;
+
+        debug("Shut down successfully");
+    }
+
+    u32 RuntimePool::dispatch(const Task& task) {
+        u32 runtimeIndex = selectRuntime();
+        dispatchTo(runtimeIndex, task);
+        return runtimeIndex;
+    }
+
+    void RuntimePool::dispatchTo(u32 runtimeIndex, const Task& task) {
+        if (runtimeIndex >= m_slots.size()) {
+            throw RangeException("Runtime index out of range");
+        }
+
+        Slot* slot = m_slots[runtimeIndex];
+        slot->pendingCount++;
+
+        std::lock_guard<std::mutex> lock(slot->mutex);
+        slot->tasks.push(task);
+        wake(slot);
+    }
+
+    void RuntimePool::broadcast(const Task& task) {
+        for (u32 i = 0; i < m_slots.size(); i++) {
+            dispatchTo(i, task);
+        }
+    }
+
+    u32 RuntimePool::getRuntimeCount() const {
+        return m_slots.size();
+    }
+
+    u32 RuntimePool::getPendingTaskCount(u32 runtimeIndex) const {
+        if (runtimeIndex >= m_slots.size()) {
+            return 0;
+        }
+
+        return m_slots[runtimeIndex]->pendingCount;
+    }
+
+    u32 RuntimePool::selectRuntime() {
+        if (m_slots.size() == 0) {
+            throw InvalidActionException("RuntimePool is not initialized");
+        }
+
+        // Start from the next runtime in order so ties between idle runtimes are spread evenly
+        u32 start = m_nextRuntime++ % m_slots.size();
+        if (m_config.dispatchMode == RuntimeDispatchMode::RoundRobin) {
+            return start;
+        }
+
+        u32 best      = start;
+        u32 bestCount = m_slots[start]->pendingCount;
+        for (u32 i = 1; i < m_slots.size() && bestCount > 0; i++) {
+            u32 idx   = (start + i) % m_slots.size();
+            u32 count = m_slots[idx]->pendingCount;
+            if (count < bestCount) {
+                best      = idx;
+                bestCount = count;
+            }
+        }
+
+        return best;
+    }
+
+    void RuntimePool::run(Slot* slot, const Task& setup) {
+        Trace::SetThreadName(String::Format("Runtime %u", slot->index));
+
+        RuntimeConfig config = m_config.runtimeConfig;
+
+        // Idle runtime threads sleep on the poll handle until there's something to do
+        config.enablePollHandle = true;
+        config.threadPoolSize   = m_threadPoolSize;
+
+        if (slot->index > 0) {
+            // The first runtime already built the project
+            config.buildMode = BuildMode::Prebuilt;
+            config.scriptConfig.debuggerPort += slot->index;
+        }
+
+        // Only this thread uses the runtime until initialization is signaled
+        Runtime* runtime = new Runtime(config);
+        slot->runtime    = runtime;
+        addNestedLogger(runtime);
+
+        bool didInitialize = runtime->initialize();
+        if (didInitialize) {
+            runtime->commitBindings();
+
+            if (m_config.buildProject && !runtime->buildProject()) {
+                runtime->shutdown();
+                didInitialize = false;
+            }
+        }
+
+        if (didInitialize && setup) {
+            runTask(slot, setup);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(slot->mutex);
+            slot->isReady = true;
+            slot->didFail = !didInitialize;
+            slot->condition.notify_all();
+
+            if (!didInitialize) {
+                slot->runtime = nullptr;
+            }
+        }
+
+        if (!didInitialize) {
+            delete runtime;
+            return;
+        }
+
+        PollHandle* pollHandle = runtime->getPollHandle();
+
+        Array<Task> tasks;
+        while (true) {
+            {
+                std::lock_guard<std::mutex> lock(slot->mutex);
+                if (slot->doStop) {
+                    break;
+                }
+
+                std::swap(tasks, slot->tasks);
+            }
+
+            for (const Task& task : tasks) {
+                runTask(slot, task);
+                slot->pendingCount--;
+            }
+
+            bool didHaveWork = runtime->service() || tasks.size() > 0;
+            tasks.clear();
+
+            if (didHaveWork) {
+                continue;
+            }
+
+            // Tasks dispatched before the runtime cleared its poll handle at the start of service
+            // wouldn't wake it again
+            std::unique_lock<std::mutex> lock(slot->mutex);
+            if (slot->doStop || slot->tasks.size() > 0) {
+                continue;
+            }
+
+            if (pollHandle) {
+                // Ready when a task is dispatched, the pool is shut down or the runtime has work of
+                // its own such as a completed job or a timer that's due
+                lock.unlock();
+                if (pollHandle->wait()) {
+                    continue;
+                }
+
+                lock.lock();
+            }
+
+            slot->condition.wait_for(lock, std::chrono::milliseconds(m_config.idleWaitMs), [slot]() {
+                return slot->doStop || slot->tasks.size() > 0;
+            });
+        }
+
+        {
+            // Nothing can signal the runtime's poll handle once it's gone
+            std::lock_guard<std::mutex> lock(slot->mutex);
+            slot->runtime = nullptr;
+        }
+
+        runtime->shutdown();
+        delete runtime;
+    }
+
+    void RuntimePool::wake(Slot* slot) {
+        slot->condition.notify_all();
+
+        // Only null while the runtime is being created or after it failed to initialize
+        if (slot->runtime && slot->runtime->getPollHandle()) {
+            slot->runtime->getPollHandle()->signal();
+        }
+    }
+
+    void RuntimePool::runTask(Slot* slot, const Task& task) {
+        v8::Isolate* isolate = slot->runtime->getIsolate();
+        v8::Isolate::Scope isolateScope(isolate);
+        v8::HandleScope scope(isolate);
+        v8::Local<v8::Context> context = slot->runtime->getContext();
+        v8::Context::Scope contextScope(context);
+
+        try {
+            task(slot->runtime);
+        } catch (const GenericException& e) {
+            error("Exception in task on runtime %u: %s", slot->index, e.what());
+        }
+    }
+}
@@ -1,8 +1,13 @@
 #include <tspp/interfaces/IScriptSystemModule.h>
+#include <tspp/modules/AtomicsModule.h>
 #include <tspp/modules/ConsoleModule.h>
 #include <tspp/modules/DebuggerModule.h>
 #include <tspp/modules/TimeoutModule.h>
 #include <tspp/systems/script.h>
+#include <tspp/utils/EventLoopMonitor.h>
+#include <tspp/utils/PerfMap.h>
+#include <tspp/utils/ScriptStream.h>
+#include <tspp/utils/Trace.h>
 
 #include <utils/Array.hpp>
 #include <utils/Exception.h>
@@ -11,8 +16,79 @@
 #include <v8-inspector.h>
 
 #include <filesystem>
+#include <mutex>
 
 namespace tspp {
+    static std::mutex s_platformMutex;
+    static std::unique_ptr<v8::Platform> s_platform;
+    static u32 s_platformRefCount = 0;
+
+    bool ScriptSystem::AcquirePlatform(const ScriptConfig& config) {
+        std::lock_guard<std::mutex> lock(s_platformMutex);
+        if (s_platformRefCount > 0) {
+            s_platformRefCount++;
+            return true;
+        }
+
+        std::filesystem::path cwd = std::filesystem::current_path();
+        if (!v8::V8::InitializeICUDefaultLocation(cwd.string().c_str(), (cwd / "icudtl.dat").string().c_str())) {
+            return false;
+        }
+
+        v8::V8::InitializeExternalStartupData(cwd.string().c_str());
+
+        v8::V8::SetFlagsFromString("--turbo-fast-api-calls");
+
+        #ifdef __linux__
+        if (config.perfMode != PerfMode::Disabled) {
+            // Interpreted functions get their own native frames, otherwise perf attributes all of
+            // them to the interpreter entry trampoline
+            v8::V8::SetFlagsFromString("--perf-basic-prof --interpreted-frames-native-stack");
+
+            if (config.perfMode == PerfMode::JitDump) {
+                v8::V8::SetFlagsFromString("--perf-prof --perf-prof-unwinding-info");
+            }
+
+            PerfMap::Enable();
+        }
+        #endif
+
+        // Initialize V8
+        // Idle tasks only run when the embedder reports idle time (Runtime::notifyIdle), until then
+        // V8 falls back to collecting when allocation triggers it. V8's trace events are recorded
+        // alongside the runtime's own (see Trace).
+        s_platform = v8::platform::NewDefaultPlatform(
+            0,
+            v8::platform::IdleTaskSupport::kEnabled,
+            v8::platform::InProcessStackDumping::kDisabled,
+            Trace::CreateTracingController()
+        );
+        v8::V8::InitializePlatform(s_platform.get());
+        v8::V8::Initialize();
+
+        s_platformRefCount = 1;
+        return true;
+    }
+
+    void ScriptSystem::ReleasePlatform() {
+        std::lock_guard<std::mutex> lock(s_platformMutex);
+        if (s_platformRefCount == 0) {
+            return;
+        }
+
+        s_platformRefCount--;
+        if (s_platformRefCount > 0) {
+            return;
+        }
+
+        v8::V8::Dispose();
+        v8::V8::DisposePlatform();
+        s_platform.reset();
+
+        // V8 has closed the perf map now that every isolate is gone
+        PerfMap::Flush();
+    }
+
     // ScriptSystem implementation
     ScriptSystem::ScriptSystem(const ScriptConfig& config)
         : IWithLogging("ScriptSystem"), m_config(config), m_initialized(false) {
@@ -23,6 +99,7 @@ namespace tspp {
             addModule(new ConsoleModule(this), true);
         }
         addModule(new TimeoutModule(this), true);
+        addModule(new AtomicsModule(this), true);
     }
 
     ScriptSystem::~ScriptSystem() {
@@ -47,26 +124,21 @@ namespace tspp {
     }
 
     bool ScriptSystem::initialize() {
+        Trace::Scope trace("tspp", "ScriptSystem::initialize");
         debug("Initializing");
 
-        std::filesystem::path cwd = std::filesystem::current_path();
-        if (!v8::V8::InitializeICUDefaultLocation(cwd.string().c_str(), (cwd / "icudtl.dat").string().c_str())) {
+        if (!AcquirePlatform(m_config)) {
             error("Call to V8::InitializeICUDefaultLocation failed");
             return false;
         }
 
-        v8::V8::InitializeExternalStartupData(cwd.string().c_str());
-
-        v8::V8::SetFlagsFromString("--turbo-fast-api-calls");
-
-        // Initialize V8
-        m_platform = v8::platform::NewDefaultPlatform();
-        v8::V8::InitializePlatform(m_platform.get());
-        v8::V8::Initialize();
-
         // Create a new Isolate with the configured heap size
+        m_allocator.reset(v8::ArrayBuffer::Allocator::NewDefaultAllocator());
+
+        // Backing stores hold a reference to the allocator, so buffers transferred to or
+        // shared with other isolates can outlive this one
         v8::Isolate::CreateParams create_params;
-        create_params.array_buffer_allocator = v8::ArrayBuffer::Allocator::NewDefaultAllocator();
+        create_params.array_buffer_allocator_shared = m_allocator;
 
         // Set initial heap size constraints
         create_params.constraints.ConfigureDefaultsFromHeapSize(m_config.initialHeapSize, m_config.maximumHeapSize);
@@ -113,8 +185,9 @@ namespace tspp {
 
             // Clean up V8
             m_isolate->Dispose();
-            v8::V8::Dispose();
-            v8::V8::DisposePlatform();
+            m_isolate = nullptr;
+            m_allocator.reset();
+            ReleasePlatform();
 
             debug("Shut down successfully");
             m_initialized = false;
@@ -130,11 +203,29 @@ namespace tspp {
             return v8::Local<v8::Value>();
         }
 
+        v8::Isolate::Scope isolate_scope(m_isolate);
+        v8::EscapableHandleScope handle_scope(m_isolate);
+
+        v8::Local<v8::Value> result = executeString(m_context.Get(m_isolate), code, filename);
+        if (result.IsEmpty()) {
+            return v8::Local<v8::Value>();
+        }
+
+        return handle_scope.Escape(result);
+    }
+
+    v8::Local<v8::Value> ScriptSystem::executeString(
+        v8::Local<v8::Context> context, const String& code, const String& filename
+    ) {
+        if (!m_initialized) {
+            error("Cannot execute script: ScriptSystem not initialized");
+            return v8::Local<v8::Value>();
+        }
+
         try {
             v8::Isolate::Scope isolate_scope(m_isolate);
             v8::EscapableHandleScope handle_scope(m_isolate);
 
-            v8::Local<v8::Context> context = m_context.Get(m_isolate);
             v8::Context::Scope context_scope(context);
 
             // Create a string containing the JavaScript source code
@@ -147,36 +238,14 @@ namespace tspp {
             v8::TryCatch try_catch(m_isolate);
 
             if (!v8::Script::Compile(context, source, &origin).ToLocal(&script)) {
-                v8::String::Utf8Value msg(m_isolate, try_catch.Exception());
-                error("Compilation error: %s", *msg);
-
-                v8::Local<v8::Value> stackTrace;
-                if (try_catch.StackTrace(context).ToLocal(&stackTrace) && !stackTrace.IsEmpty()) {
-                    v8::Local<v8::String> stackTraceStr;
-                    if (stackTrace->ToString(context).ToLocal(&stackTraceStr) && !stackTraceStr.IsEmpty()) {
-                        v8::String::Utf8Value trace(m_isolate, stackTraceStr);
-                        error(*trace);
-                    }
-                }
-
+                reportException(try_catch, context, "Compilation error: ");
                 return v8::Local<v8::Value>();
             }
 
             // Run the script
             v8::Local<v8::Value> result;
             if (!script->Run(context).ToLocal(&result)) {
-                v8::String::Utf8Value msg(m_isolate, try_catch.Exception());
-                error(*msg);
-
-                v8::Local<v8::Value> stackTrace;
-                if (try_catch.StackTrace(context).ToLocal(&stackTrace) && !stackTrace.IsEmpty()) {
-                    v8::Local<v8::String> stackTraceStr;
-                    if (stackTrace->ToString(context).ToLocal(&stackTraceStr) && !stackTraceStr.IsEmpty()) {
-                        v8::String::Utf8Value trace(m_isolate, stackTraceStr);
-                        error(*trace);
-                    }
-                }
-
+                reportException(try_catch, context, "");
                 return v8::Local<v8::Value>();
             }
 
@@ -188,6 +257,51 @@ namespace tspp {
         return v8::Local<v8::Value>();
     }
 
+    v8::Local<v8::Value> ScriptSystem::executeStream(const std::shared_ptr<ScriptStream>& stream) {
+        if (!m_initialized) {
+            error("Cannot execute script: ScriptSystem not initialized");
+            return v8::Local<v8::Value>();
+        }
+
+        v8::Isolate::Scope isolate_scope(m_isolate);
+        v8::EscapableHandleScope handle_scope(m_isolate);
+
+        v8::Local<v8::Context> context = m_context.Get(m_isolate);
+        v8::Context::Scope context_scope(context);
+
+        v8::TryCatch try_catch(m_isolate);
+
+        v8::Local<v8::Script> script;
+        if (!stream->compile(context).ToLocal(&script)) {
+            reportException(try_catch, context, "Compilation error: ");
+            return v8::Local<v8::Value>();
+        }
+
+        v8::Local<v8::Value> result;
+        if (!script->Run(context).ToLocal(&result)) {
+            reportException(try_catch, context, "");
+            return v8::Local<v8::Value>();
+        }
+
+        return handle_scope.Escape(result);
+    }
+
+    void ScriptSystem::reportException(
+        const v8::TryCatch& tryCatch, v8::Local<v8::Context> context, const char* prefix
+    ) {
+        v8::String::Utf8Value msg(m_isolate, tryCatch.Exception());
+        error("%s%s", prefix, *msg);
+
+        v8::Local<v8::Value> stackTrace;
+        if (tryCatch.StackTrace(context).ToLocal(&stackTrace) && !stackTrace.IsEmpty()) {
+            v8::Local<v8::String> stackTraceStr;
+            if (stackTrace->ToString(context).ToLocal(&stackTraceStr) && !stackTraceStr.IsEmpty()) {
+                v8::String::Utf8Value trace(m_isolate, stackTraceStr);
+                error(*trace);
+            }
+        }
+    }
+
     v8::Isolate* ScriptSystem::getIsolate() {
         return m_isolate;
     }
@@ -197,11 +311,51 @@ namespace tspp {
     }
 
     void ScriptSystem::service() {
+        // Run tasks that V8 posted for this isolate, such as settling Atomics.waitAsync promises
+        while (v8::platform::PumpMessageLoop(s_platform.get(), m_isolate)) {
+        }
+
+        EventLoopMonitor* monitor = EventLoopMonitor::Get(m_isolate);
         for (auto module : m_modules) {
+            EventLoopMonitor::Scope monitorScope(monitor, module->getName());
             module->service();
         }
     }
 
+    void ScriptSystem::runIdleTasks(f64 idleTimeSeconds) {
+        v8::platform::RunIdleTasks(s_platform.get(), m_isolate, idleTimeSeconds);
+    }
+
+    bool ScriptSystem::getNextDeadline(std::chrono::high_resolution_clock::time_point& outDeadline) const {
+        bool hasDeadline = false;
+
+        for (auto module : m_modules) {
+            std::chrono::high_resolution_clock::time_point deadline;
+            if (!module->getNextDeadline(deadline)) {
+                continue;
+            }
+
+            if (!hasDeadline || deadline < outDeadline) {
+                outDeadline = deadline;
+                hasDeadline = true;
+            }
+        }
+
+        return hasDeadline;
+    }
+
+    void ScriptSystem::notifyContextCreated(v8::Local<v8::Context> context, const String& name) {
+        for (auto module : m_modules) {
+            module->onContextCreated(context, name);
+        }
+    }
+
+    void ScriptSystem::notifyContextDestroyed(v8::Local<v8::Context> context) {
+        for (auto module : m_modules) {
+            module->onContextDestroyed(context);
+        }
+    }
+
     void ScriptSystem::shutdown() {
         if (!m_initialized) {
             return;
@@ -219,8 +373,9 @@ namespace tspp {
 
         // Clean up V8
         m_isolate->Dispose();
-        v8::V8::Dispose();
-        v8::V8::DisposePlatform();
+        m_isolate = nullptr;
+        m_allocator.reset();
+        ReleasePlatform();
 
         debug("Shut down successfully");
         m_initialized = false;
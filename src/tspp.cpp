@@ -1,15 +1,40 @@
+#include <tspp/builtin/compiler_host.h>
 #include <tspp/builtin/databuffer.h>
 #include <tspp/builtin/fs.h>
 #include <tspp/builtin/path.h>
+#include <tspp/builtin/performance.h>
+#include <tspp/builtin/profiler.h>
 #include <tspp/builtin/process.h>
+#include <tspp/builtin/runtime.h>
 #include <tspp/modules/BindingModule.h>
 #include <tspp/modules/ModuleSystemModule.h>
 #include <tspp/modules/TypeScriptCompilerModule.h>
+#include <tspp/modules/WorkerModule.h>
 #include <tspp/systems/script.h>
 #include <tspp/tspp.h>
 #include <tspp/utils/Callback.h>
+#include <tspp/utils/JavaScriptTypeData.h>
+#include <tspp/utils/CpuProfiler.h>
+#include <tspp/utils/HeapProfiler.h>
+#include <tspp/utils/HostObjectManager.h>
+#include <tspp/utils/PollHandle.h>
+#include <tspp/utils/ScriptStream.h>
+#include <tspp/utils/Watchdog.h>
+
+#include <mutex>
 
 namespace tspp {
+    // Index of the isolate data slot that points to the owning runtime
+    static constexpr u32 RuntimeDataSlot = 0;
+
+    // The binding registry is shared by every runtime, so built-in namespaces are only added once
+    static std::once_flag s_builtInsRegistered;
+    static std::once_flag s_compilerHostRegistered;
+
+    // Runtimes share the binding registry, the type marshallers and the generated builtins.d.ts, so
+    // runtimes on different threads (pools, workers) initialize and commit their bindings one at a time
+    static std::mutex s_initMutex;
+
     Runtime::Runtime(const RuntimeConfig& config) : IWithLogging("TSPP") {
         m_config                   = config;
         m_initialized              = false;
@@ -17,6 +42,14 @@ namespace tspp {
         m_bindingModule            = nullptr;
         m_moduleSystemModule       = nullptr;
         m_typeScriptCompilerModule = nullptr;
+        m_workerModule             = nullptr;
+        m_watchdog                 = nullptr;
+        m_pollHandle               = nullptr;
+        m_cpuProfiler              = nullptr;
+        m_heapProfiler             = nullptr;
+        m_eventLoopMonitor         = nullptr;
+        m_heapMonitor              = nullptr;
+        m_callbackRegistry         = nullptr;
     }
 
     Runtime::~Runtime() {
@@ -24,6 +57,7 @@ namespace tspp {
     }
 
     bool Runtime::initialize() {
+        std::lock_guard<std::mutex> lock(s_initMutex);
         debug("Initializing");
 
         m_scriptSystem = new ScriptSystem(m_config.scriptConfig);
@@ -37,30 +71,91 @@ namespace tspp {
         m_bindingModule = new BindingModule(m_scriptSystem, this);
         m_scriptSystem->addModule(m_bindingModule, true);
 
-        // Create and add the TypeScript compiler module
-        m_typeScriptCompilerModule = new TypeScriptCompilerModule(m_scriptSystem, this);
-        m_scriptSystem->addModule(m_typeScriptCompilerModule, true);
+        // Create and add the TypeScript compiler module, prebuilt projects don't need it
+        if (m_config.buildMode != BuildMode::Prebuilt) {
+            m_typeScriptCompilerModule = new TypeScriptCompilerModule(m_scriptSystem, this);
+            m_scriptSystem->addModule(m_typeScriptCompilerModule, true);
+        }
+
+        // Create and add the worker module
+        m_workerModule = new WorkerModule(m_scriptSystem, this);
+        m_scriptSystem->addModule(m_workerModule, true);
+
+        if (m_config.enablePollHandle) {
+            m_pollHandle = new PollHandle();
+            addNestedLogger(m_pollHandle);
+
+            if (!m_pollHandle->open()) {
+                error("Failed to create poll handle");
+                delete m_pollHandle;
+                m_pollHandle = nullptr;
+            } else {
+                PollHandle* pollHandle = m_pollHandle;
+                m_threadPool.setCompletionCallback([pollHandle]() { pollHandle->signal(); });
+            }
+        }
+
+        // Modules may start streaming scripts on the thread pool during initialization
+        m_threadPool.start(m_config.threadPoolSize);
 
         // Initialize script system
         if (!m_scriptSystem->initialize()) {
             error("Failed to initialize");
 
+            m_threadPool.shutdown();
+
             delete m_scriptSystem;
             m_scriptSystem = nullptr;
 
             return false;
         }
 
-        m_threadPool.start();
+        std::call_once(s_builtInsRegistered, []() {
+            builtin::databuffer::init();
+            builtin::fs::init();
+            builtin::process::init();
+            builtin::path::init();
+            builtin::profiler::init();
+            builtin::performance::init();
+            builtin::runtime::init();
+        });
+
+        if (m_config.buildMode != BuildMode::Prebuilt) {
+            std::call_once(s_compilerHostRegistered, builtin::compiler_host::init);
+        }
+
+        m_scriptSystem->getIsolate()->SetData(RuntimeDataSlot, this);
+
+        m_callbackRegistry = new CallbackRegistry();
+
+        m_cpuProfiler = new CpuProfiler(m_scriptSystem->getIsolate(), m_config.profileOutputDirectory);
+        addNestedLogger(m_cpuProfiler);
 
-        builtin::databuffer::init();
-        builtin::fs::init();
-        builtin::process::init();
-        builtin::path::init();
+        m_heapProfiler = new HeapProfiler(m_scriptSystem->getIsolate(), m_config.profileOutputDirectory);
+        addNestedLogger(m_heapProfiler);
 
-        m_scriptSystem->getIsolate()->SetData(0, this);
+        m_heapMonitor = new HeapMonitor(m_scriptSystem->getIsolate(), m_config.heapMonitor, m_heapProfiler);
+        addNestedLogger(m_heapMonitor);
+
+        if (m_config.watchdog.budgetMs > 0) {
+            m_watchdog = new Watchdog(m_config.watchdog);
+            addNestedLogger(m_watchdog);
+            m_watchdog->start(m_scriptSystem->getIsolate());
+        }
+
+        if (m_config.eventLoopMonitor.enabled) {
+            m_eventLoopMonitor = new EventLoopMonitor(m_config.eventLoopMonitor);
+            addNestedLogger(m_eventLoopMonitor);
+            m_eventLoopMonitor->start(m_scriptSystem->getIsolate());
+        }
 
         m_initialized = true;
+
+        // Anything started during initialization is picked up by the first service call
+        if (m_pollHandle) {
+            m_pollHandle->signal();
+        }
+
         debug("Initialized");
         return true;
     }
@@ -71,15 +166,79 @@ namespace tspp {
         }
         debug("Shutting down");
 
+        if (m_watchdog) {
+            m_watchdog->stop();
+            delete m_watchdog;
+            m_watchdog = nullptr;
+        }
+
+        if (m_eventLoopMonitor) {
+            m_eventLoopMonitor->stop();
+            delete m_eventLoopMonitor;
+            m_eventLoopMonitor = nullptr;
+        }
+
         m_threadPool.shutdown();
 
-        Callback::DestroyAll();
+        if (m_cpuProfiler) {
+            // Profiles that are still recording are written rather than lost
+            if (m_cpuProfiler->isProfiling()) {
+                v8::Isolate::Scope isolateScope(m_scriptSystem->getIsolate());
+                m_cpuProfiler->stop();
+            }
+
+            delete m_cpuProfiler;
+            m_cpuProfiler = nullptr;
+        }
+
+        if (m_heapMonitor) {
+            delete m_heapMonitor;
+            m_heapMonitor = nullptr;
+        }
+
+        if (m_heapProfiler) {
+            delete m_heapProfiler;
+            m_heapProfiler = nullptr;
+        }
+
+        for (ScriptContext* context : m_contexts) {
+            delete context;
+        }
+
+        m_contexts.clear();
+
+        v8::Isolate* isolate = m_scriptSystem->getIsolate();
+
+        // Host objects may release callbacks when they're destroyed, so they go first
+        for (HostObjectManager* objMgr : m_hostObjectManagers) {
+            delete objMgr;
+        }
+
+        m_hostObjectManagers.clear();
+
+        // Callbacks hold handles to functions in this isolate
+        delete m_callbackRegistry;
+        m_callbackRegistry = nullptr;
+
+        for (auto& pair : m_typeData) {
+            pair.second->constructor.Reset();
+            delete pair.second;
+        }
+
+        m_typeData.clear();
+        isolate->SetData(RuntimeDataSlot, nullptr);
 
         // Shut down script system
         m_scriptSystem->shutdown();
         delete m_scriptSystem;
         m_scriptSystem = nullptr;
 
+        if (m_pollHandle) {
+            m_threadPool.setCompletionCallback(nullptr);
+            delete m_pollHandle;
+            m_pollHandle = nullptr;
+        }
+
         m_initialized = false;
         debug("Shut down successfully");
     }
@@ -92,6 +251,56 @@ namespace tspp {
         return m_scriptSystem->getContext();
     }
 
+    Runtime* Runtime::Get(v8::Isolate* isolate) {
+        if (!isolate) {
+            return nullptr;
+        }
+
+        return (Runtime*)isolate->GetData(RuntimeDataSlot);
+    }
+
+    JavaScriptTypeData* Runtime::getTypeData(bind::DataType* type) const {
+        auto it = m_typeData.find(type);
+        if (it == m_typeData.end()) {
+            return nullptr;
+        }
+
+        return it->second;
+    }
+
+    void Runtime::setTypeData(bind::DataType* type, JavaScriptTypeData* data) {
+        m_typeData[type] = data;
+    }
+
+    HostObjectManager* Runtime::getHostObjectManager(bind::DataType* type, bool create) {
+        u32 id = type->getUserData<DataTypeUserData>().hostObjectManagerId;
+        if (id == 0) {
+            return nullptr;
+        }
+
+        if (id <= m_hostObjectManagers.size() && m_hostObjectManagers[id - 1]) {
+            return m_hostObjectManagers[id - 1];
+        }
+
+        if (!create) {
+            return nullptr;
+        }
+
+        while (m_hostObjectManagers.size() < id) {
+            m_hostObjectManagers.push(nullptr);
+        }
+
+        HostObjectManager* objMgr = new HostObjectManager(type);
+        addNestedLogger(objMgr);
+
+        m_hostObjectManagers[id - 1] = objMgr;
+        return objMgr;
+    }
+
+    CallbackRegistry* Runtime::getCallbackRegistry() const {
+        return m_callbackRegistry;
+    }
+
     const RuntimeConfig& Runtime::getConfig() const {
         return m_config;
     }
@@ -105,32 +314,117 @@ namespace tspp {
     }
 
     v8::Local<v8::Value> Runtime::requireModule(const String& id) {
-        return m_moduleSystemModule->requireModule(id);
+        Watchdog::Scope watchdogScope(m_watchdog, "requireModule");
+        v8::Local<v8::Value> result = m_moduleSystemModule->requireModule(id);
+
+        // The module may have queued microtasks
+        if (m_pollHandle) {
+            m_pollHandle->signal();
+        }
+
+        return result;
     }
 
     v8::Local<v8::Value> Runtime::executeString(const String& code, const String& filename) {
-        return m_scriptSystem->executeString(code, filename);
+        Watchdog::Scope watchdogScope(m_watchdog, "executeString");
+        v8::Local<v8::Value> result = m_scriptSystem->executeString(code, filename);
+
+        // The code may have queued microtasks
+        if (m_pollHandle) {
+            m_pollHandle->signal();
+        }
+
+        return result;
+    }
+
+    v8::Local<v8::Promise> Runtime::executeStringAsync(const String& code, const String& filename) {
+        return executeStreamAsync(std::make_shared<ScriptStream>(filename, code));
+    }
+
+    v8::Local<v8::Promise> Runtime::executeFile(const String& path) {
+        return executeStreamAsync(std::make_shared<ScriptStream>(path));
+    }
+
+    v8::Local<v8::Promise> Runtime::executeStreamAsync(const std::shared_ptr<ScriptStream>& stream) {
+        v8::Isolate* isolate = m_scriptSystem->getIsolate();
+        v8::Isolate::Scope isolateScope(isolate);
+        v8::EscapableHandleScope scope(isolate);
+        v8::Local<v8::Context> context = m_scriptSystem->getContext();
+        v8::Context::Scope contextScope(context);
+
+        v8::Local<v8::Promise::Resolver> resolver = v8::Promise::Resolver::New(context).ToLocalChecked();
+        std::shared_ptr<v8::Global<v8::Promise::Resolver>> pending =
+            std::make_shared<v8::Global<v8::Promise::Resolver>>(isolate, resolver);
+
+        stream->begin(this, [this, pending](ScriptStream* parsed) {
+            v8::Isolate* isolate = m_scriptSystem->getIsolate();
+            v8::HandleScope scope(isolate);
+            v8::Local<v8::Context> context = m_scriptSystem->getContext();
+            v8::Context::Scope contextScope(context);
+
+            v8::Local<v8::Promise::Resolver> resolver = pending->Get(isolate);
+            pending->Reset();
+
+            v8::TryCatch tryCatch(isolate);
+            v8::Local<v8::Script> script;
+            v8::Local<v8::Value> result;
+
+            if (!parsed->compile(context).ToLocal(&script) || !script->Run(context).ToLocal(&result)) {
+                v8::Local<v8::Value> exception = v8::Undefined(isolate);
+                if (tryCatch.HasCaught()) {
+                    exception = tryCatch.Exception();
+                }
+
+                tryCatch.Reset();
+                resolver->Reject(context, exception).Check();
+                return;
+            }
+
+            resolver->Resolve(context, result).Check();
+        });
+
+        return scope.Escape(resolver->GetPromise());
     }
 
     void Runtime::commitBindings() {
+        std::lock_guard<std::mutex> lock(s_initMutex);
         m_bindingModule->commitBindings();
         m_scriptSystem->onAfterBindings();
     }
 
     bool Runtime::buildProject() {
-        debug("Compiling project");
-        if (!m_typeScriptCompilerModule->compileDirectory(m_config.scriptRootDirectory)) {
-            error("Failed to compile project");
-            return false;
-        }
-
-        return true;
+        return buildProject(m_config.scriptRootDirectory);
     }
 
     bool Runtime::buildProject(const String& projectRoot) {
-        debug("Compiling project");
-        if (!m_typeScriptCompilerModule->compileDirectory(projectRoot)) {
-            error("Failed to compile project");
+        switch (m_config.buildMode) {
+            case BuildMode::Full: {
+                debug("Compiling project");
+                if (!m_typeScriptCompilerModule->compileDirectory(projectRoot)) {
+                    error("Failed to compile project");
+                    return false;
+                }
+                break;
+            }
+            case BuildMode::TranspileOnly: {
+                debug("Transpiling project");
+                if (!m_typeScriptCompilerModule->transpileDirectory(projectRoot)) {
+                    error("Failed to transpile project");
+                    return false;
+                }
+                break;
+            }
+            case BuildMode::Prebuilt: {
+                debug("Using prebuilt project output");
+                break;
+            }
+        }
+
+        String outputDir = projectRoot;
+        outputDir += "/internal/dist";
+
+        if (!m_moduleSystemModule->loadModuleDirectory(outputDir)) {
+            error("Failed to load project output from %s", outputDir.c_str());
             return false;
         }
 
@@ -146,17 +440,270 @@ namespace tspp {
     }
 
     bool Runtime::service() {
+        std::chrono::high_resolution_clock::time_point startedAt = std::chrono::high_resolution_clock::now();
+
         v8::Isolate* isolate = m_scriptSystem->getIsolate();
         v8::Isolate::Scope isolateScope(isolate);
         v8::HandleScope hs(isolate);
         v8::Local<v8::Context> context = m_scriptSystem->getContext();
         v8::Context::Scope contextScope(context);
 
-        bool didHaveWork = m_threadPool.processCompleted();
-        isolate->PerformMicrotaskCheckpoint();
+        bool didHaveWork = false;
+
+        // Anything that happens from here on makes the handle ready again
+        if (m_pollHandle) {
+            m_pollHandle->clear();
+        }
+
+        {
+            Watchdog::Scope watchdogScope(m_watchdog, "job completion");
+            didHaveWork = m_threadPool.processCompleted(m_eventLoopMonitor);
+        }
+
+        {
+            Watchdog::Scope watchdogScope(m_watchdog, "microtasks");
+            EventLoopMonitor::Scope monitorScope(m_eventLoopMonitor, "microtasks");
+            isolate->PerformMicrotaskCheckpoint();
+        }
 
         m_scriptSystem->service();
+        m_cpuProfiler->service();
+        m_heapMonitor->service();
+
+        // Contexts may be created or destroyed by the code that's run, so iterate over a copy
+        Array<ScriptContext*> contexts = m_contexts;
+        for (ScriptContext* scriptContext : contexts) {
+            scriptContext->service();
+        }
+
+        if (m_pollHandle) {
+            // Timers and other callbacks that were run by the modules may have queued microtasks,
+            // the handle might not become ready again to run them if they're left for the next call
+            {
+                Watchdog::Scope watchdogScope(m_watchdog, "microtasks");
+                EventLoopMonitor::Scope monitorScope(m_eventLoopMonitor, "microtasks");
+                isolate->PerformMicrotaskCheckpoint();
+            }
+
+            updatePollHandle();
+        }
+
+        if (m_eventLoopMonitor) {
+            m_eventLoopMonitor->recordIteration(
+                std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::high_resolution_clock::now() - startedAt
+                )
+                    .count()
+            );
+        }
+
+        if (m_config.idleFrameBudgetMs > 0) {
+            notifyIdle(startedAt + std::chrono::milliseconds(m_config.idleFrameBudgetMs));
+        }
 
         return didHaveWork;
     }
+
+    void Runtime::notifyIdle(std::chrono::high_resolution_clock::time_point deadline) {
+        std::chrono::duration<f64> idleTime = deadline - std::chrono::high_resolution_clock::now();
+        if (idleTime.count() <= 0.0) {
+            return;
+        }
+
+        v8::Isolate* isolate = m_scriptSystem->getIsolate();
+        v8::Isolate::Scope isolateScope(isolate);
+
+        m_scriptSystem->runIdleTasks(idleTime.count());
+    }
+
+    void Runtime::notifyMemoryPressure(v8::MemoryPressureLevel level) {
+        m_scriptSystem->getIsolate()->MemoryPressureNotification(level);
+    }
+
+    bool Runtime::startCpuProfile(const String& name, u32 samplingIntervalUs, u32 durationMs) {
+        v8::Isolate::Scope isolateScope(m_scriptSystem->getIsolate());
+        return m_cpuProfiler->start(name, samplingIntervalUs, durationMs);
+    }
+
+    bool Runtime::stopCpuProfile(String* outJson) {
+        v8::Isolate::Scope isolateScope(m_scriptSystem->getIsolate());
+        return m_cpuProfiler->stop(outJson);
+    }
+
+    void Runtime::requestCpuProfile(const String& name, u32 samplingIntervalUs, u32 durationMs) {
+        m_cpuProfiler->request(name, samplingIntervalUs, durationMs);
+
+        if (m_pollHandle) {
+            m_pollHandle->signal();
+        }
+    }
+
+    CpuProfiler* Runtime::getCpuProfiler() const {
+        return m_cpuProfiler;
+    }
+
+    bool Runtime::takeHeapSnapshot(const String& path) {
+        v8::Isolate::Scope isolateScope(m_scriptSystem->getIsolate());
+        return m_heapProfiler->takeHeapSnapshot(path);
+    }
+
+    bool Runtime::startSamplingHeapProfile(u32 samplingIntervalBytes, u32 stackDepth) {
+        v8::Isolate::Scope isolateScope(m_scriptSystem->getIsolate());
+        return m_heapProfiler->startSamplingHeapProfile(samplingIntervalBytes, stackDepth);
+    }
+
+    bool Runtime::stopSamplingHeapProfile(const String& path) {
+        v8::Isolate::Scope isolateScope(m_scriptSystem->getIsolate());
+        return m_heapProfiler->stopSamplingHeapProfile(path);
+    }
+
+    HeapProfiler* Runtime::getHeapProfiler() const {
+        return m_heapProfiler;
+    }
+
+    PollHandle* Runtime::getPollHandle() const {
+        return m_pollHandle;
+    }
+
+    bool Runtime::getNextDeadline(std::chrono::high_resolution_clock::time_point& outDeadline) const {
+        bool hasDeadline = m_scriptSystem->getNextDeadline(outDeadline);
+
+        std::chrono::high_resolution_clock::time_point profileDeadline;
+        if (m_cpuProfiler && m_cpuProfiler->getNextDeadline(profileDeadline)) {
+            if (!hasDeadline || profileDeadline < outDeadline) {
+                outDeadline = profileDeadline;
+                hasDeadline = true;
+            }
+        }
+
+        for (ScriptContext* scriptContext : m_contexts) {
+            std::chrono::high_resolution_clock::time_point deadline;
+            if (!scriptContext->getNextDeadline(deadline)) {
+                continue;
+            }
+
+            if (!hasDeadline || deadline < outDeadline) {
+                outDeadline = deadline;
+                hasDeadline = true;
+            }
+        }
+
+        return hasDeadline;
+    }
+
+    void Runtime::updatePollHandle() {
+        std::chrono::high_resolution_clock::time_point deadline;
+        if (getNextDeadline(deadline)) {
+            m_pollHandle->setDeadline(deadline);
+        } else {
+            m_pollHandle->clearDeadline();
+        }
+    }
+
+    ScriptContext* Runtime::createContext(const String& name) {
+        ScriptContext* context = new ScriptContext(this, name);
+        addNestedLogger(context);
+
+        if (!context->initialize()) {
+            error("Failed to create context '%s'", name.c_str());
+            delete context;
+            return nullptr;
+        }
+
+        m_contexts.push(context);
+        return context;
+    }
+
+    void Runtime::destroyContext(ScriptContext* context) {
+        for (u32 i = 0; i < m_contexts.size(); i++) {
+            if (m_contexts[i] == context) {
+                m_contexts.remove(i);
+                delete context;
+                return;
+            }
+        }
+    }
+
+    ScriptContext* Runtime::getScriptContext(v8::Local<v8::Context> context) const {
+        for (ScriptContext* scriptContext : m_contexts) {
+            if (scriptContext->m_context == context) {
+                return scriptContext;
+            }
+        }
+
+        return nullptr;
+    }
+
+    class ContextMemoryDelegate : public v8::MeasureMemoryDelegate {
+        public:
+            ContextMemoryDelegate(const Runtime* runtime, const ContextMemoryCallback& callback)
+                : m_runtime(runtime), m_callback(callback) {}
+
+            bool ShouldMeasure(v8::Local<v8::Context> context) override {
+                return true;
+            }
+
+            void MeasurementComplete(Result result) override {
+                Array<ContextMemoryUsage> usage;
+                for (const std::pair<v8::Local<v8::Context>, size_t>& entry : result.context_sizes_in_bytes) {
+                    usage.push({m_runtime->getScriptContext(entry.first), entry.second});
+                }
+
+                m_callback(usage, result.unattributed_size_in_bytes);
+            }
+
+        private:
+            const Runtime* m_runtime;
+            ContextMemoryCallback m_callback;
+    };
+
+    bool Runtime::measureContextMemory(const ContextMemoryCallback& callback) {
+        v8::Isolate* isolate = m_scriptSystem->getIsolate();
+        v8::Isolate::Scope isolateScope(isolate);
+        v8::HandleScope scope(isolate);
+
+        return isolate->MeasureMemory(
+            std::make_unique<ContextMemoryDelegate>(this, callback), v8::MeasureMemoryExecution::kEager
+        );
+    }
+
+    ScriptSystem* Runtime::getScriptSystem() const {
+        return m_scriptSystem;
+    }
+
+    BindingModule* Runtime::getBindingModule() const {
+        return m_bindingModule;
+    }
+
+    ModuleSystemModule* Runtime::getModuleSystem() const {
+        return m_moduleSystemModule;
+    }
+
+    Watchdog* Runtime::getWatchdog() const {
+        return m_watchdog;
+    }
+
+    EventLoopMonitor* Runtime::getEventLoopMonitor() const {
+        return m_eventLoopMonitor;
+    }
+
+    HeapMonitor* Runtime::getHeapMonitor() const {
+        return m_heapMonitor;
+    }
+
+    RuntimeStats Runtime::getStats() {
+        v8::Isolate::Scope isolateScope(m_scriptSystem->getIsolate());
+        m_heapMonitor->sample();
+
+        RuntimeStats stats;
+        stats.heap       = m_heapMonitor->getHeapStats();
+        stats.gc         = m_heapMonitor->getGCStats();
+        stats.eventLoop  = m_eventLoopMonitor ? m_eventLoopMonitor->getStats() : EventLoopStats{};
+        stats.threadPool = m_threadPool.getStats();
+        return stats;
+    }
+
+    ThreadPool* Runtime::getThreadPool() {
+        return &m_threadPool;
+    }
 }
\ No newline at end of file
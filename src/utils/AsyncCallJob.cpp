@@ -1,6 +1,7 @@
 #include <tspp/interfaces/IDataMarshaller.h>
 #include <tspp/tspp.h>
 #include <tspp/utils/AsyncCallJob.h>
+#include <tspp/utils/CallStats.h>
 #include <tspp/utils/HostObjectManager.h>
 
 #include <bind/DataType.h>
@@ -14,6 +15,9 @@ namespace tspp {
         m_isolate      = runtime->getIsolate();
         m_target       = target;
         m_hasException = false;
+        m_isTimed      = false;
+        m_argumentsNs  = 0;
+        m_callNs       = 0;
     }
 
     AsyncCallJob::~AsyncCallJob() {
@@ -21,12 +25,18 @@ namespace tspp {
     }
 
     void AsyncCallJob::run() {
+        u64 startedAt = m_isTimed ? CallStats::Now() : 0;
+
         try {
             m_target->call(m_result, m_args);
         } catch (const std::exception& e) {
             m_hasException = true;
             m_exceptionMsg = e.what();
         }
+
+        if (m_isTimed) {
+            m_callNs = CallStats::Now() - startedAt;
+        }
     }
 
     void AsyncCallJob::afterComplete() {
@@ -34,12 +44,14 @@ namespace tspp {
 
         bind::FunctionType* sig        = m_target->getSignature();
         bind::DataType* retType        = sig->getReturnType();
-        HostObjectManager* retObjMgr   = retType->getUserData<DataTypeUserData>().hostObjectManager;
+        HostObjectManager* retObjMgr   = HostObjectManager::Get(m_isolate, retType);
         const bind::type_meta& retInfo = retType->getInfo();
 
         v8::Local<v8::Promise::Resolver> resolver = m_resolver.Get(m_isolate);
         m_resolver.Reset();
 
+        u64 startedAt = m_isTimed ? CallStats::Now() : 0;
+
         if (m_hasException) {
             resolver->Reject(
                 context,
@@ -69,14 +81,27 @@ namespace tspp {
         } else {
             resolver->Resolve(context, v8::Undefined(m_isolate));
         }
+
+        if (m_isTimed) {
+            CallStats::Record(
+                m_target, CallStats::Kind::Function, m_argumentsNs, m_callNs, CallStats::Now() - startedAt
+            );
+        }
+    }
+
+    const char* AsyncCallJob::getName() const {
+        return "async call";
     }
 
     void AsyncCallJob::setup(void* selfPtr, const v8::FunctionCallbackInfo<v8::Value>& args) {
         v8::Local<v8::Context> context = m_isolate->GetCurrentContext();
 
+        m_isTimed     = CallStats::IsEnabled();
+        u64 startedAt = m_isTimed ? CallStats::Now() : 0;
+
         bind::FunctionType* sig        = m_target->getSignature();
         bind::DataType* retType        = sig->getReturnType();
-        HostObjectManager* retObjMgr   = retType->getUserData<DataTypeUserData>().hostObjectManager;
+        HostObjectManager* retObjMgr   = HostObjectManager::Get(m_isolate, retType);
         const bind::type_meta& retInfo = retType->getInfo();
 
         if (retInfo.size > 0) {
@@ -108,6 +133,10 @@ namespace tspp {
         v8::Local<v8::Promise::Resolver> resolver = v8::Promise::Resolver::New(context).ToLocalChecked();
         m_resolver.Reset(m_isolate, resolver);
 
+        if (m_isTimed) {
+            m_argumentsNs = CallStats::Now() - startedAt;
+        }
+
         args.GetReturnValue().Set(resolver->GetPromise());
     }
 }
\ No newline at end of file
@@ -1,13 +1,17 @@
 #include <bind/DataType.h>
 #include <bind/Function.h>
 #include <tspp/interfaces/IDataMarshaller.h>
+#include <tspp/tspp.h>
 #include <tspp/utils/BindObjectType.h>
 #include <tspp/utils/CallContext.h>
 #include <tspp/utils/CallProxy.h>
 #include <tspp/utils/Docs.h>
 #include <tspp/utils/HostObjectManager.h>
+#include <tspp/utils/JavaScriptTypeData.h>
 #include <utils/Array.hpp>
 
+#include <atomic>
+
 #include <v8-fast-api-calls.h>
 
 namespace tspp {
@@ -263,7 +267,7 @@ namespace tspp {
         bind::DataType* type =
             static_cast<bind::DataType*>(obj->GetInternalField(1).As<v8::Value>().As<v8::External>()->Value());
 
-        HostObjectManager* objMgr = type->getUserData<DataTypeUserData>().hostObjectManager;
+        HostObjectManager* objMgr = HostObjectManager::Get(isolate, type);
         if (!objMgr) {
             isolate->ThrowException(v8::Exception::TypeError(
                 v8::String::NewFromUtf8(
@@ -295,7 +299,7 @@ namespace tspp {
 
         v8::Local<v8::Context> context = isolate->GetCurrentContext();
         bind::DataType* type           = (bind::DataType*)args.Data().As<v8::External>()->Value();
-        HostObjectManager* objMgr      = type->getUserData<DataTypeUserData>().hostObjectManager;
+        HostObjectManager* objMgr      = HostObjectManager::Get(isolate, type);
         if (!objMgr) {
             isolate->ThrowException(v8::Exception::TypeError(
                 v8::String::NewFromUtf8(
@@ -393,6 +397,9 @@ namespace tspp {
 
         selectedCtor->call(nullptr, callArgs);
 
+        // Now that the object is constructed, the resources it owns can be measured
+        objMgr->updateExternalSize(objPtr);
+
         setInternalFields(isolate, obj, objPtr, type, false);
     }
 
@@ -650,4 +657,35 @@ namespace tspp {
 
         return scope.Escape(ctor);
     }
+
+    static std::atomic<u32> s_materializedTypeCount = 0;
+
+    JavaScriptTypeData* getJavaScriptTypeData(v8::Isolate* isolate, bind::DataType* type) {
+        DataTypeUserData& userData = type->getUserData<DataTypeUserData>();
+
+        // Only bound object types have an object manager
+        if (userData.hostObjectManagerId == 0) {
+            return nullptr;
+        }
+
+        Runtime* runtime = Runtime::Get(isolate);
+        if (!runtime) {
+            return nullptr;
+        }
+
+        JavaScriptTypeData* data = runtime->getTypeData(type);
+        if (!data) {
+            v8::HandleScope scope(isolate);
+            data = new JavaScriptTypeData();
+            data->constructor.Reset(isolate, buildPrototype(isolate, type));
+            runtime->setTypeData(type, data);
+            s_materializedTypeCount++;
+        }
+
+        return data;
+    }
+
+    u32 getMaterializedTypeCount() {
+        return s_materializedTypeCount;
+    }
 }
@@ -23,7 +23,7 @@ namespace tspp {
         }
 
         for (void* callback : m_callbacks) {
-            Callback::Release(callback);
+            Callback::Release(m_isolate, callback);
         }
     }
 
@@ -3,6 +3,7 @@
 #include <tspp/utils/AsyncCallJob.h>
 #include <tspp/utils/CallContext.h>
 #include <tspp/utils/CallProxy.h>
+#include <tspp/utils/CallStats.h>
 #include <tspp/utils/HostObjectManager.h>
 
 #include <bind/DataType.h>
@@ -45,9 +46,10 @@ namespace tspp {
         }
 
         bind::DataType* retType        = sig->getReturnType();
-        HostObjectManager* retObjMgr   = retType->getUserData<DataTypeUserData>().hostObjectManager;
+        HostObjectManager* retObjMgr   = HostObjectManager::Get(isolate, retType);
         const bind::type_meta& retInfo = retType->getInfo();
 
+        CallStats::Timer timer;
         CallContext callCtx(isolate, context);
 
         void* callArgs[16] = {nullptr};
@@ -74,6 +76,8 @@ namespace tspp {
             }
         }
 
+        timer.argumentsDone();
+
         try {
             sig->call(funcPtr, ret, callArgs);
         } catch (const std::exception& e) {
@@ -82,6 +86,8 @@ namespace tspp {
             return;
         }
 
+        timer.callDone();
+
         if (retInfo.size > 0) {
             bool retNeedsCopy      = !retObjMgr && retInfo.is_pointer == 0;
             DataTypeUserData& data = retType->getUserData<DataTypeUserData>();
@@ -99,13 +105,15 @@ namespace tspp {
 
             args.GetReturnValue().Set(retVal);
         }
+
+        timer.finish(sig, CallStats::Kind::FunctionPointer);
     }
 
     void AsyncFunctionCallProxy(const v8::FunctionCallbackInfo<v8::Value>& args) {
         v8::Isolate* isolate = args.GetIsolate();
         v8::HandleScope scope(isolate);
 
-        Runtime* runtime = (Runtime*)isolate->GetData(0);
+        Runtime* runtime = Runtime::Get(isolate);
 
         v8::Local<v8::Context> context = isolate->GetCurrentContext();
 
@@ -137,7 +145,7 @@ namespace tspp {
         v8::Isolate* isolate = args.GetIsolate();
         v8::HandleScope scope(isolate);
 
-        Runtime* runtime = (Runtime*)isolate->GetData(0);
+        Runtime* runtime = Runtime::Get(isolate);
 
         v8::Local<v8::Context> context = isolate->GetCurrentContext();
 
@@ -224,9 +232,10 @@ namespace tspp {
 
         bind::FunctionType* sig        = target->getSignature();
         bind::DataType* retType        = sig->getReturnType();
-        HostObjectManager* retObjMgr   = retType->getUserData<DataTypeUserData>().hostObjectManager;
+        HostObjectManager* retObjMgr   = HostObjectManager::Get(isolate, retType);
         const bind::type_meta& retInfo = retType->getInfo();
 
+        CallStats::Timer timer;
         CallContext callCtx(isolate, context);
 
         void* callArgs[16] = {nullptr};
@@ -252,6 +261,8 @@ namespace tspp {
             }
         }
 
+        timer.argumentsDone();
+
         try {
             target->call(ret, callArgs);
         } catch (const std::exception& e) {
@@ -260,6 +271,8 @@ namespace tspp {
             return;
         }
 
+        timer.callDone();
+
         if (retInfo.size > 0) {
             bool retNeedsCopy      = !retObjMgr && retInfo.is_pointer == 0;
             DataTypeUserData& data = retType->getUserData<DataTypeUserData>();
@@ -277,6 +290,8 @@ namespace tspp {
 
             args.GetReturnValue().Set(retVal);
         }
+
+        timer.finish(target, CallStats::Kind::Function);
     }
 
     void MethodCallProxy(const v8::FunctionCallbackInfo<v8::Value>& args) {
@@ -339,8 +354,9 @@ namespace tspp {
         bind::FunctionType* sig        = target->getSignature();
         bind::DataType* retType        = sig->getReturnType();
         const bind::type_meta& retInfo = retType->getInfo();
-        HostObjectManager* retObjMgr   = retType->getUserData<DataTypeUserData>().hostObjectManager;
+        HostObjectManager* retObjMgr   = HostObjectManager::Get(isolate, retType);
 
+        CallStats::Timer timer;
         CallContext callCtx(isolate, context);
 
         void* callArgs[16] = {nullptr};
@@ -366,6 +382,8 @@ namespace tspp {
             }
         }
 
+        timer.argumentsDone();
+
         try {
             target->call(ret, callArgs);
         } catch (const std::exception& e) {
@@ -374,6 +392,8 @@ namespace tspp {
             return;
         }
 
+        timer.callDone();
+
         if (retInfo.size > 0) {
             bool retNeedsCopy           = !retObjMgr && retInfo.is_pointer == 0;
             DataTypeUserData& data      = retType->getUserData<DataTypeUserData>();
@@ -390,5 +410,7 @@ namespace tspp {
 
             args.GetReturnValue().Set(retVal);
         }
+
+        timer.finish(target, CallStats::Kind::Function);
     }
 }
\ No newline at end of file
@@ -0,0 +1,313 @@
+#include <tspp/utils/CallStats.h>
+#include <tspp/utils/Histogram.h>
+#include <tspp/utils/ProfileOutput.h>
+#include <utils/Array.hpp>
+
+#include <bind/Function.h>
+#include <bind/FunctionType.h>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace tspp {
+    static constexpr u32 HistogramBucketCount = Histogram::BucketCount;
+
+    struct CallCounts {
+        public:
+            u64 calls;
+            u64 argumentsNs;
+            u64 callNs;
+            u64 returnNs;
+            u64 histogram[HistogramBucketCount];
+    };
+
+    /*
+     * The same bind::FunctionType is the key of both function pointers called from script and
+     * callbacks called from the host, so records are also keyed by kind
+     */
+    struct CallKey {
+        public:
+            const void* key;
+            CallStats::Kind kind;
+
+            bool operator==(const CallKey& rhs) const {
+                return key == rhs.key && kind == rhs.kind;
+            }
+    };
+
+    struct CallKeyHash {
+        public:
+            size_t operator()(const CallKey& k) const {
+                return std::hash<const void*>()(k.key) ^ size_t(k.kind);
+            }
+    };
+
+    struct CallRecord {
+        public:
+            std::atomic<u64> calls;
+            std::atomic<u64> argumentsNs;
+            std::atomic<u64> callNs;
+            std::atomic<u64> returnNs;
+            std::atomic<u64> histogram[HistogramBucketCount];
+
+            // The counters as of the last Reset, which only ever moves this instead of clearing the
+            // counters so that it can't race with the owning thread. Guarded by s_threadsMutex.
+            CallCounts baseline;
+    };
+
+    struct ThreadCallStats {
+        public:
+            // Only the owning thread adds records, this guards against it doing so while they're dumped
+            std::mutex mutex;
+            std::unordered_map<CallKey, CallRecord*, CallKeyHash> records;
+    };
+
+    static std::atomic<bool> s_isEnabled = false;
+
+    // Every thread that has recorded a call. Never freed, so counts from threads that have exited
+    // are kept.
+    static std::mutex s_threadsMutex;
+    static Array<ThreadCallStats*> s_threads;
+    static thread_local ThreadCallStats* t_stats = nullptr;
+
+    /*
+     * Only the owning thread writes to a record's counters, so a relaxed load and store is enough and
+     * avoids a locked read-modify-write. Readers on other threads may see slightly stale values.
+     */
+    static void add(std::atomic<u64>& counter, u64 value) {
+        counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+    static void loadCounts(const CallRecord* record, CallCounts& out) {
+        out.calls       = record->calls.load(std::memory_order_relaxed);
+        out.argumentsNs = record->argumentsNs.load(std::memory_order_relaxed);
+        out.callNs      = record->callNs.load(std::memory_order_relaxed);
+        out.returnNs    = record->returnNs.load(std::memory_order_relaxed);
+
+        for (u32 i = 0; i < HistogramBucketCount; i++) {
+            out.histogram[i] = record->histogram[i].load(std::memory_order_relaxed);
+        }
+    }
+
+    static CallRecord* getRecord(const void* key, CallStats::Kind kind) {
+        if (!t_stats) {
+            t_stats = new ThreadCallStats();
+
+            std::lock_guard<std::mutex> lock(s_threadsMutex);
+            s_threads.push(t_stats);
+        }
+
+        auto it = t_stats->records.find({key, kind});
+        if (it != t_stats->records.end()) {
+            return it->second;
+        }
+
+        CallRecord* record = new CallRecord();
+
+        std::lock_guard<std::mutex> lock(t_stats->mutex);
+        t_stats->records.insert({{key, kind}, record});
+        return record;
+    }
+
+    //
+    // CallStats::Timer
+    //
+
+    CallStats::Timer::Timer() {
+        m_startedAt       = IsEnabled() ? Now() : 0;
+        m_argumentsDoneAt = m_startedAt;
+        m_callDoneAt      = m_startedAt;
+    }
+
+    void CallStats::Timer::argumentsDone() {
+        if (m_startedAt) {
+            m_argumentsDoneAt = Now();
+        }
+    }
+
+    void CallStats::Timer::callDone() {
+        if (m_startedAt) {
+            m_callDoneAt = Now();
+        }
+    }
+
+    void CallStats::Timer::finish(const void* key, Kind kind) {
+        if (!m_startedAt) {
+            return;
+        }
+
+        Record(key, kind, m_argumentsDoneAt - m_startedAt, m_callDoneAt - m_argumentsDoneAt, Now() - m_callDoneAt);
+    }
+
+    //
+    // CallStats
+    //
+
+    void CallStats::SetEnabled(bool enabled) {
+        s_isEnabled.store(enabled, std::memory_order_relaxed);
+    }
+
+    bool CallStats::IsEnabled() {
+        return s_isEnabled.load(std::memory_order_relaxed);
+    }
+
+    u64 CallStats::Now() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch()
+        )
+            .count();
+    }
+
+    void CallStats::Record(const void* key, Kind kind, u64 argumentsNs, u64 callNs, u64 returnNs) {
+        CallRecord* record = getRecord(key, kind);
+
+        add(record->calls, 1);
+        add(record->argumentsNs, argumentsNs);
+        add(record->callNs, callNs);
+        add(record->returnNs, returnNs);
+        add(record->histogram[Histogram::GetBucketIndex(argumentsNs + callNs + returnNs)], 1);
+    }
+
+    void CallStats::Reset() {
+        std::lock_guard<std::mutex> lock(s_threadsMutex);
+
+        for (ThreadCallStats* stats : s_threads) {
+            std::lock_guard<std::mutex> threadLock(stats->mutex);
+
+            for (auto& pair : stats->records) {
+                CallRecord* record = pair.second;
+                loadCounts(record, record->baseline);
+            }
+        }
+    }
+
+    String CallStats::ToJSON() {
+        struct Merged {
+            public:
+                u64 calls;
+                u64 argumentsNs;
+                u64 callNs;
+                u64 returnNs;
+                u64 histogram[HistogramBucketCount];
+        };
+
+        std::unordered_map<CallKey, Merged, CallKeyHash> merged;
+
+        {
+            std::lock_guard<std::mutex> lock(s_threadsMutex);
+
+            for (ThreadCallStats* stats : s_threads) {
+                std::lock_guard<std::mutex> threadLock(stats->mutex);
+
+                for (auto& pair : stats->records) {
+                    CallRecord* record = pair.second;
+
+                    auto it = merged.find(pair.first);
+                    if (it == merged.end()) {
+                        it = merged.insert({pair.first, Merged{}}).first;
+                    }
+
+                    // Counters only grow, so they're never below the baseline
+                    CallCounts counts;
+                    loadCounts(record, counts);
+
+                    const CallCounts& baseline = record->baseline;
+
+                    Merged& m = it->second;
+                    m.calls += counts.calls - baseline.calls;
+                    m.argumentsNs += counts.argumentsNs - baseline.argumentsNs;
+                    m.callNs += counts.callNs - baseline.callNs;
+                    m.returnNs += counts.returnNs - baseline.returnNs;
+
+                    for (u32 i = 0; i < HistogramBucketCount; i++) {
+                        m.histogram[i] += counts.histogram[i] - baseline.histogram[i];
+                    }
+                }
+            }
+        }
+
+        std::string json = "{\"bindings\":[";
+        bool isFirst     = true;
+
+        for (auto& pair : merged) {
+            const Merged& m = pair.second;
+            if (m.calls == 0) {
+                continue;
+            }
+
+            Kind kind = pair.first.kind;
+
+            String name;
+            const char* kindName = nullptr;
+            switch (kind) {
+                case Kind::Function: {
+                    name     = ((const bind::Function*)pair.first.key)->getName();
+                    kindName = "function";
+                    break;
+                }
+                case Kind::FunctionPointer: {
+                    name     = ((const bind::FunctionType*)pair.first.key)->getName();
+                    kindName = "functionPointer";
+                    break;
+                }
+                case Kind::Callback: {
+                    name     = ((const bind::FunctionType*)pair.first.key)->getName();
+                    kindName = "callback";
+                    break;
+                }
+            }
+
+            if (!isFirst) {
+                json += ",";
+            }
+
+            isFirst = false;
+
+            // Binding names may contain anything that can appear in a type name
+            json += "{\"name\":\"";
+            appendJSONEscaped(json, name.c_str());
+            json += String::Format(
+                        "\",\"kind\":\"%s\",\"calls\":%llu,\"argumentsNs\":%llu,\"callNs\":%llu,"
+                        "\"returnNs\":%llu,\"histogram\":[",
+                        kindName,
+                        (unsigned long long)m.calls,
+                        (unsigned long long)m.argumentsNs,
+                        (unsigned long long)m.callNs,
+                        (unsigned long long)m.returnNs
+            )
+                        .c_str();
+
+            bool isFirstBucket = true;
+            for (u32 i = 0; i < HistogramBucketCount; i++) {
+                if (m.histogram[i] == 0) {
+                    continue;
+                }
+
+                if (!isFirstBucket) {
+                    json += ",";
+                }
+
+                isFirstBucket = false;
+
+                u64 upperBound = Histogram::GetBucketUpperBound(i);
+                json += String::Format(
+                            "{\"le\":%llu,\"count\":%llu}",
+                            (unsigned long long)upperBound,
+                            (unsigned long long)m.histogram[i]
+                )
+                            .c_str();
+            }
+
+            json += "]}";
+        }
+
+        json += "]}";
+
+        String result;
+        result.copy(json.c_str(), json.size());
+        return result;
+    }
+}
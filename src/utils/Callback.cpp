@@ -2,15 +2,35 @@
 #include <tspp/interfaces/IDataMarshaller.h>
 #include <tspp/tspp.h>
 #include <tspp/utils/CallContext.h>
+#include <tspp/utils/CallStats.h>
 #include <tspp/utils/Callback.h>
+#include <tspp/utils/PerfMap.h>
+#include <tspp/utils/Watchdog.h>
 #include <utils/Exception.h>
 
 namespace tspp {
-    std::unordered_map<void*, Callback*> Callback::s_map = {};
-    MemoryPool Callback::m_pool                          = MemoryPool(sizeof(Callback), 1024, false);
-
     void invokeCallback(ffi_cif* cif, void* ret, void** args, void* user_data);
 
+    static CallbackRegistry* getRegistry(v8::Isolate* isolate) {
+        Runtime* runtime = Runtime::Get(isolate);
+        if (!runtime) {
+            return nullptr;
+        }
+
+        return runtime->getCallbackRegistry();
+    }
+
+    CallbackRegistry::CallbackRegistry() : m_pool(sizeof(Callback), 256, false) {}
+
+    CallbackRegistry::~CallbackRegistry() {
+        for (auto& pair : m_map) {
+            pair.second->~Callback();
+            m_pool.free(pair.second);
+        }
+
+        m_map.clear();
+    }
+
     Callback::Callback(
         v8::Isolate* isolate, void* closure, bind::FunctionType* sig, const v8::Local<v8::Function>& target
     ) {
@@ -41,18 +61,32 @@ namespace tspp {
         return m_sig;
     }
 
-    void Callback::AddRef(void* callback) {
-        auto it = s_map.find(callback);
-        if (it == s_map.end()) {
+    void Callback::AddRef(v8::Isolate* isolate, void* callback) {
+        CallbackRegistry* registry = getRegistry(isolate);
+        if (!registry) {
+            throw InputException("Attempted to add reference to callback of an isolate with no runtime");
+        }
+
+        std::lock_guard<std::mutex> lock(registry->m_mutex);
+
+        auto it = registry->m_map.find(callback);
+        if (it == registry->m_map.end()) {
             throw InputException("Attempted to add reference to unbound callback");
         }
 
         it->second->m_refCount++;
     }
 
-    void Callback::Release(void* callback) {
-        auto it = s_map.find(callback);
-        if (it == s_map.end()) {
+    void Callback::Release(v8::Isolate* isolate, void* callback) {
+        CallbackRegistry* registry = getRegistry(isolate);
+        if (!registry) {
+            throw InputException("Attempted to release callback of an isolate with no runtime");
+        }
+
+        std::lock_guard<std::mutex> lock(registry->m_mutex);
+
+        auto it = registry->m_map.find(callback);
+        if (it == registry->m_map.end()) {
             throw InputException("Attempted to release unbound callback");
         }
 
@@ -61,39 +95,41 @@ namespace tspp {
 
         if (cb->m_refCount == 0) {
             cb->~Callback();
-            m_pool.free(cb);
-            s_map.erase(it);
+            registry->m_pool.free(cb);
+            registry->m_map.erase(it);
         }
     }
 
     void* Callback::Create(v8::Isolate* isolate, bind::FunctionType* sig, const v8::Local<v8::Function>& target) {
+        CallbackRegistry* registry = getRegistry(isolate);
+        if (!registry) {
+            return nullptr;
+        }
+
         void* fptr    = nullptr;
         void* closure = ffi_closure_alloc(sizeof(ffi_closure), &fptr);
         if (!closure) {
             return nullptr;
         }
 
-        Callback* cb = (Callback*)m_pool.alloc();
+        std::lock_guard<std::mutex> lock(registry->m_mutex);
+
+        Callback* cb = (Callback*)registry->m_pool.alloc();
         ffi_cif* cif = sig->getCif();
         if (ffi_prep_closure_loc((ffi_closure*)closure, cif, invokeCallback, cb, fptr) != FFI_OK) {
-            m_pool.free(cb);
+            registry->m_pool.free(cb);
             ffi_closure_free(closure);
             return nullptr;
         }
 
         new (cb) Callback(isolate, closure, sig, target);
-        s_map.insert({fptr, cb});
-
-        return fptr;
-    }
+        registry->m_map.insert({fptr, cb});
 
-    void Callback::DestroyAll() {
-        for (auto it = s_map.begin(); it != s_map.end(); ++it) {
-            it->second->~Callback();
+        if (PerfMap::IsEnabled()) {
+            PerfMap::AddEntry(fptr, FFI_TRAMPOLINE_SIZE, String::Format("tspp::callback %s", sig->getName().c_str()));
         }
 
-        m_pool.reset();
-        s_map.clear();
+        return fptr;
     }
 
     void invokeCallback(ffi_cif* cif, void* ret, void** args, void* user_data) {
@@ -105,12 +141,12 @@ namespace tspp {
 
         v8::HandleScope scope(isolate);
 
-        Runtime* runtime               = (Runtime*)isolate->GetData(0);
-        v8::Local<v8::Context> context = runtime->getContext();
-        v8::Context::Scope contextScope(context);
-
+        // The function may belong to any of the runtime's contexts
         v8::Local<v8::Function> target = cb->getTarget();
+        v8::Local<v8::Context> context = target->GetCreationContextChecked();
+        v8::Context::Scope contextScope(context);
 
+        CallStats::Timer timer;
         v8::TryCatch tryCatch(isolate);
         v8::Local<v8::Value> destArgs[16];
 
@@ -127,6 +163,9 @@ namespace tspp {
             }
         }
 
+        timer.argumentsDone();
+
+        Watchdog::Scope watchdogScope(Watchdog::Get(isolate), "host callback");
         v8::MaybeLocal<v8::Value> result = target->Call(context, context->Global(), sigArgs.size(), destArgs);
         if (tryCatch.HasCaught()) {
             v8::String::Utf8Value error(isolate, tryCatch.Exception());
@@ -143,6 +182,8 @@ namespace tspp {
             throw GenericException(utils::String::Format("Caught error in callback: %s", *error));
         }
 
+        timer.callDone();
+
         bind::DataType* retType   = sig->getReturnType();
         DataTypeUserData& retData = retType->getUserData<DataTypeUserData>();
 
@@ -164,5 +205,7 @@ namespace tspp {
                 throw GenericException(*error);
             }
         }
+
+        timer.finish(sig, CallStats::Kind::Callback);
     }
 }
\ No newline at end of file
@@ -0,0 +1,182 @@
+#include <tspp/utils/CpuProfiler.h>
+#include <tspp/utils/ProfileOutput.h>
+
+#include <v8-profiler.h>
+
+namespace tspp {
+    /*
+     * Collects the output of CpuProfile::Serialize
+     */
+    class StringOutputStream : public v8::OutputStream {
+        public:
+            void EndOfStream() override {}
+
+            int GetChunkSize() override {
+                return 64 * 1024;
+            }
+
+            WriteResult WriteAsciiChunk(char* data, int size) override {
+                m_data.append(data, size_t(size));
+                return kContinue;
+            }
+
+            const std::string& getData() const {
+                return m_data;
+            }
+
+        private:
+            std::string m_data;
+    };
+
+    CpuProfiler::CpuProfiler(v8::Isolate* isolate, const String& outputDirectory) : IWithLogging("CpuProfiler") {
+        m_isolate         = isolate;
+        m_profiler        = nullptr;
+        m_outputDirectory = outputDirectory;
+        m_hasDeadline     = false;
+        m_hasRequest      = false;
+    }
+
+    CpuProfiler::~CpuProfiler() {
+        if (!m_profiler) {
+            return;
+        }
+
+        v8::HandleScope scope(m_isolate);
+        v8::CpuProfile* profile =
+            m_profiler->StopProfiling(v8::String::NewFromUtf8(m_isolate, m_name.c_str()).ToLocalChecked());
+        if (profile) {
+            profile->Delete();
+        }
+
+        m_profiler->Dispose();
+        m_profiler = nullptr;
+    }
+
+    bool CpuProfiler::start(const String& name, u32 samplingIntervalUs, u32 durationMs) {
+        if (m_profiler) {
+            error("Can't start profile '%s', profile '%s' is already being recorded", name.c_str(), m_name.c_str());
+            return false;
+        }
+
+        if (samplingIntervalUs == 0) {
+            error("Can't start profile '%s', the sampling interval must be greater than 0", name.c_str());
+            return false;
+        }
+
+        // Profile names come from scripts, they must not be able to write outside the output directory
+        if (!isPlainFileName(name)) {
+            error("Can't start profile '%s', the name must be a file name without a directory", name.c_str());
+            return false;
+        }
+
+        v8::HandleScope scope(m_isolate);
+
+        // The sampling interval can only be changed while nothing is being recorded, so each
+        // profile gets its own profiler
+        m_profiler = v8::CpuProfiler::New(m_isolate);
+        m_profiler->SetSamplingInterval(i32(samplingIntervalUs));
+
+        v8::CpuProfilingStatus status = m_profiler->StartProfiling(
+            v8::String::NewFromUtf8(m_isolate, name.c_str()).ToLocalChecked(),
+            v8::CpuProfilingOptions(v8::kLeafNodeLineNumbers, v8::CpuProfilingOptions::kNoSampleLimit)
+        );
+
+        if (status != v8::CpuProfilingStatus::kStarted) {
+            error("Failed to start profile '%s'", name.c_str());
+            m_profiler->Dispose();
+            m_profiler = nullptr;
+            return false;
+        }
+
+        m_name        = name;
+        m_hasDeadline = durationMs > 0;
+        if (m_hasDeadline) {
+            m_stopAt = Clock::now() + std::chrono::milliseconds(durationMs);
+        }
+
+        log("Started profile '%s' (sampling every %u us)", name.c_str(), samplingIntervalUs);
+        return true;
+    }
+
+    bool CpuProfiler::stop(String* outJson) {
+        if (!m_profiler) {
+            error("Can't stop profile, no profile is being recorded");
+            return false;
+        }
+
+        v8::HandleScope scope(m_isolate);
+        v8::CpuProfile* profile =
+            m_profiler->StopProfiling(v8::String::NewFromUtf8(m_isolate, m_name.c_str()).ToLocalChecked());
+
+        m_profiler->Dispose();
+        m_profiler    = nullptr;
+        m_hasDeadline = false;
+
+        if (!profile) {
+            error("Failed to stop profile '%s'", m_name.c_str());
+            return false;
+        }
+
+        StringOutputStream stream;
+        profile->Serialize(&stream, v8::CpuProfile::kJSON);
+        i32 sampleCount = profile->GetSamplesCount();
+        profile->Delete();
+
+        const std::string& json = stream.getData();
+        if (outJson) {
+            outJson->copy(json.c_str(), json.size());
+        }
+
+        std::filesystem::path outputPath =
+            std::filesystem::path(m_outputDirectory.c_str()) / (std::string(m_name.c_str()) + ".cpuprofile");
+
+        if (!writeOutputFile(outputPath, json)) {
+            error("Failed to write profile '%s' to '%s'", m_name.c_str(), outputPath.string().c_str());
+            return false;
+        }
+
+        log("Wrote profile '%s' with %d samples to '%s'", m_name.c_str(), sampleCount, outputPath.string().c_str());
+        return true;
+    }
+
+    void CpuProfiler::request(const String& name, u32 samplingIntervalUs, u32 durationMs) {
+        std::lock_guard<std::mutex> lock(m_requestMutex);
+        m_hasRequest                 = true;
+        m_request.name               = name;
+        m_request.samplingIntervalUs = samplingIntervalUs;
+        m_request.durationMs         = durationMs;
+    }
+
+    bool CpuProfiler::isProfiling() const {
+        return m_profiler != nullptr;
+    }
+
+    void CpuProfiler::service() {
+        if (m_profiler && m_hasDeadline && Clock::now() >= m_stopAt) {
+            stop();
+        }
+
+        Request request;
+
+        {
+            std::lock_guard<std::mutex> lock(m_requestMutex);
+            if (!m_hasRequest) {
+                return;
+            }
+
+            request      = m_request;
+            m_hasRequest = false;
+        }
+
+        start(request.name, request.samplingIntervalUs, request.durationMs);
+    }
+
+    bool CpuProfiler::getNextDeadline(Clock::time_point& outDeadline) const {
+        if (!m_profiler || !m_hasDeadline) {
+            return false;
+        }
+
+        outDeadline = m_stopAt;
+        return true;
+    }
+}
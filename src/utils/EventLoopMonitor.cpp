@@ -0,0 +1,215 @@
+#include <tspp/utils/EventLoopMonitor.h>
+#include <tspp/utils/StackTrace.h>
+#include <tspp/tspp.h>
+#include <utils/Array.hpp>
+
+#include <chrono>
+
+namespace tspp {
+    //
+    // EventLoopMonitor::Scope
+    //
+
+    EventLoopMonitor::Scope::Scope(EventLoopMonitor* monitor, const char* entryPoint) : m_monitor(monitor) {
+        if (m_monitor) {
+            m_monitor->enter(entryPoint);
+        }
+    }
+
+    EventLoopMonitor::Scope::~Scope() {
+        if (m_monitor) {
+            m_monitor->exit();
+        }
+    }
+
+    //
+    // EventLoopMonitor
+    //
+
+    EventLoopMonitor::EventLoopMonitor(const EventLoopMonitorConfig& config)
+        : IsolateMonitor("EventLoopMonitor", config.checkIntervalMs) {
+        m_config          = config;
+        m_startedAt       = getTimeUs();
+        m_longTaskCount   = 0;
+        m_stackDepth      = 0;
+        m_enteredAt       = 0;
+        m_didRequestStack = false;
+        m_didSampleStack  = false;
+    }
+
+    EventLoopMonitor::~EventLoopMonitor() {
+        stop();
+    }
+
+    void EventLoopMonitor::start(v8::Isolate* isolate) {
+        if (m_isolate) {
+            return;
+        }
+
+        m_startedAt = getTimeUs();
+
+        debug("Started with a long task threshold of %u ms", m_config.longTaskThresholdMs);
+
+        startMonitoring(isolate);
+    }
+
+    void EventLoopMonitor::stop() {
+        stopMonitoring();
+    }
+
+    void EventLoopMonitor::recordIteration(u64 durationUs) {
+        m_iterations.record(durationUs);
+    }
+
+    void EventLoopMonitor::recordLag(u64 lagUs) {
+        m_lag.record(lagUs);
+    }
+
+    EventLoopStats EventLoopMonitor::getStats() const {
+        EventLoopStats stats;
+        stats.iterationCount  = m_iterations.getCount();
+        stats.iterationMeanMs = m_iterations.getMean() / 1000.0;
+        stats.iterationMaxMs  = f64(m_iterations.getMax()) / 1000.0;
+        stats.lagSampleCount  = m_lag.getCount();
+        stats.lagMeanMs       = m_lag.getMean() / 1000.0;
+        stats.lagP50Ms        = f64(m_lag.getPercentile(50.0)) / 1000.0;
+        stats.lagP90Ms        = f64(m_lag.getPercentile(90.0)) / 1000.0;
+        stats.lagP99Ms        = f64(m_lag.getPercentile(99.0)) / 1000.0;
+        stats.lagMaxMs        = f64(m_lag.getMax()) / 1000.0;
+        stats.longTaskCount   = m_longTaskCount;
+        return stats;
+    }
+
+    const Array<LongTask>& EventLoopMonitor::getLongTasks() const {
+        return m_longTasks;
+    }
+
+    void EventLoopMonitor::reset() {
+        m_iterations.reset();
+        m_lag.reset();
+        m_longTasks.clear();
+        m_longTaskCount = 0;
+    }
+
+    f64 EventLoopMonitor::now() const {
+        return f64(getTimeUs() - m_startedAt) / 1000.0;
+    }
+
+    EventLoopMonitor* EventLoopMonitor::Get(v8::Isolate* isolate) {
+        Runtime* runtime = Runtime::Get(isolate);
+        if (!runtime) {
+            return nullptr;
+        }
+
+        return runtime->getEventLoopMonitor();
+    }
+
+    void EventLoopMonitor::enter(const char* entryPoint) {
+        u64 now = getTimeUs();
+        m_scopes.push({entryPoint, now, false});
+
+        if (m_scopes.size() > 1) {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_isActive        = true;
+        m_enteredAt       = now;
+        m_didRequestStack = false;
+        m_didSampleStack  = false;
+    }
+
+    void EventLoopMonitor::exit() {
+        ActiveScope scope = m_scopes.pop();
+        u32 depth         = m_scopes.size() + 1;
+        u64 durationUs    = getTimeUs() - scope.enteredAt;
+
+        if (scope.didReportChild) {
+            // Only the innermost long task is reported, the parent's time is mostly the child's
+            if (m_scopes.size() > 0) {
+                m_scopes.last().didReportChild = true;
+            }
+        } else if (durationUs >= u64(m_config.longTaskThresholdMs) * 1000) {
+            LongTask task;
+            task.entryPoint  = scope.entryPoint;
+            task.startedAtMs = f64(scope.enteredAt - m_startedAt) / 1000.0;
+            task.durationMs  = f64(durationUs) / 1000.0;
+
+            // The stack belongs to this task if it was sampled while this scope or one of its
+            // children was running
+            if (m_stackDepth >= depth) {
+                task.stack   = m_stack;
+                m_stack      = String();
+                m_stackDepth = 0;
+            }
+
+            warn(
+                "Long task in '%s' blocked the event loop for %.1f ms%s",
+                scope.entryPoint,
+                task.durationMs,
+                task.stack.size() > 0 ? task.stack.c_str() : ""
+            );
+
+            if (m_config.maxLongTasks > 0) {
+                if (m_longTasks.size() >= m_config.maxLongTasks) {
+                    m_longTasks.remove(0);
+                }
+
+                m_longTasks.push(task);
+            }
+
+            m_longTaskCount++;
+
+            if (m_scopes.size() > 0) {
+                m_scopes.last().didReportChild = true;
+            }
+        }
+
+        if (m_scopes.size() > 0) {
+            return;
+        }
+
+        m_stack      = String();
+        m_stackDepth = 0;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_isActive        = false;
+        m_didRequestStack = false;
+        m_didSampleStack  = false;
+    }
+
+    void EventLoopMonitor::check() {
+        if (m_didRequestStack || getTimeUs() - m_enteredAt < u64(m_config.longTaskThresholdMs) * 1000) {
+            return;
+        }
+
+        // The interrupt is handled on the isolate's thread, where the stack can be sampled.
+        // If the entry is in host code rather than JavaScript it may never be handled, the
+        // long task is still reported when it returns.
+        m_didRequestStack = true;
+        requestInterrupt();
+    }
+
+    u64 EventLoopMonitor::getTimeUs() const {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch()
+        )
+            .count();
+    }
+
+    void EventLoopMonitor::interrupt(v8::Isolate* isolate) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            // The entry may have returned before the interrupt was handled
+            if (!m_isActive || !m_didRequestStack || m_didSampleStack) {
+                return;
+            }
+
+            m_didSampleStack = true;
+        }
+
+        m_stack      = formatCurrentStack(isolate, m_config.maxStackFrames);
+        m_stackDepth = m_scopes.size();
+    }
+}
@@ -0,0 +1,232 @@
+#include <tspp/utils/GlobPattern.h>
+#include <utils/Array.hpp>
+
+#include <algorithm>
+
+namespace tspp {
+    static void expandBraces(const std::string& pattern, Array<std::string>& out) {
+        size_t open = pattern.find('{');
+        if (open == std::string::npos) {
+            out.push(pattern);
+            return;
+        }
+
+        i32 level    = 0;
+        size_t close = std::string::npos;
+        Array<size_t> commas;
+        for (size_t i = open; i < pattern.size(); i++) {
+            if (pattern[i] == '{') {
+                level++;
+            } else if (pattern[i] == '}') {
+                level--;
+                if (level == 0) {
+                    close = i;
+                    break;
+                }
+            } else if (pattern[i] == ',' && level == 1) {
+                commas.push(i);
+            }
+        }
+
+        if (close == std::string::npos) {
+            out.push(pattern);
+            return;
+        }
+
+        std::string prefix = pattern.substr(0, open);
+        std::string suffix = pattern.substr(close + 1);
+
+        size_t start = open + 1;
+        commas.push(close);
+        for (size_t comma : commas) {
+            expandBraces(prefix + pattern.substr(start, comma - start) + suffix, out);
+            start = comma + 1;
+        }
+    }
+
+    static bool matchClass(const char*& p, char c) {
+        // p points just past the '['
+        bool negate = *p == '!' || *p == '^';
+        if (negate) {
+            p++;
+        }
+
+        bool matched = false;
+        bool first   = true;
+        while (*p && (*p != ']' || first)) {
+            first = false;
+            if (p[1] == '-' && p[2] && p[2] != ']') {
+                if (c >= p[0] && c <= p[2]) {
+                    matched = true;
+                }
+                p += 3;
+            } else {
+                if (c == *p) {
+                    matched = true;
+                }
+                p++;
+            }
+        }
+
+        if (*p == ']') {
+            p++;
+        }
+
+        return matched != negate;
+    }
+
+    static bool matchSegment(const char* p, const char* s) {
+        while (*p) {
+            switch (*p) {
+                case '*': {
+                    while (*p == '*') {
+                        p++;
+                    }
+
+                    if (!*p) {
+                        return true;
+                    }
+
+                    for (; *s; s++) {
+                        if (matchSegment(p, s)) {
+                            return true;
+                        }
+                    }
+
+                    return false;
+                }
+                case '?': {
+                    if (!*s) {
+                        return false;
+                    }
+                    p++;
+                    s++;
+                    break;
+                }
+                case '[': {
+                    if (!*s) {
+                        return false;
+                    }
+                    p++;
+                    if (!matchClass(p, *s)) {
+                        return false;
+                    }
+                    s++;
+                    break;
+                }
+                default: {
+                    if (*p != *s) {
+                        return false;
+                    }
+                    p++;
+                    s++;
+                    break;
+                }
+            }
+        }
+
+        return *s == 0;
+    }
+
+    static bool matchSegments(const Array<std::string>& pattern, u32 pi, const Array<std::string>& path, u32 si) {
+        while (pi < pattern.size()) {
+            if (pattern[pi] == "**") {
+                // Try consuming every possible number of path segments
+                for (u32 skip = si; skip <= path.size(); skip++) {
+                    if (matchSegments(pattern, pi + 1, path, skip)) {
+                        return true;
+                    }
+                }
+
+                return false;
+            }
+
+            if (si >= path.size() || !matchSegment(pattern[pi].c_str(), path[si].c_str())) {
+                return false;
+            }
+
+            pi++;
+            si++;
+        }
+
+        return si == path.size();
+    }
+
+    GlobPattern::GlobPattern(const String& pattern) {
+        std::string source = pattern;
+        std::replace(source.begin(), source.end(), '\\', '/');
+
+        while (source.size() >= 2 && source[0] == '.' && source[1] == '/') {
+            source.erase(0, 2);
+        }
+
+        // Patterns without a wildcard or an extension in their last segment name a directory
+        size_t lastSlash    = source.rfind('/');
+        std::string lastSeg = lastSlash == std::string::npos ? source : source.substr(lastSlash + 1);
+        if (lastSeg.find_first_of("*?[{.") == std::string::npos) {
+            source += "/**/*";
+        }
+
+        Array<std::string> expanded;
+        expandBraces(source, expanded);
+
+        for (const std::string& alternative : expanded) {
+            Array<std::string> segments;
+            size_t start = 0;
+
+            while (start <= alternative.size()) {
+                size_t end = alternative.find('/', start);
+                if (end == std::string::npos) {
+                    end = alternative.size();
+                }
+
+                std::string segment = alternative.substr(start, end - start);
+                if (segment.size() > 0 && segment != ".") {
+                    // Consecutive globstars are equivalent to one
+                    if (segment != "**" || segments.size() == 0 || segments.last() != "**") {
+                        segments.push(segment);
+                    }
+                }
+
+                start = end + 1;
+            }
+
+            m_alternatives.push(segments);
+
+            // 'dir/**' and 'dir/**/*' match everything beneath 'dir', remember 'dir' so
+            // directories can be skipped entirely while walking
+            Array<std::string> directory = segments;
+            if (directory.size() > 0 && directory.last() == "*") {
+                directory.pop();
+                if (directory.size() == 0 || directory.last() != "**") {
+                    continue;
+                }
+            }
+
+            if (directory.size() > 1 && directory.last() == "**") {
+                directory.pop();
+                m_directories.push(directory);
+            }
+        }
+    }
+
+    bool GlobPattern::matches(const Array<std::string>& path) const {
+        for (const Array<std::string>& segments : m_alternatives) {
+            if (matchSegments(segments, 0, path, 0)) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    bool GlobPattern::matchesDirectory(const Array<std::string>& path) const {
+        for (const Array<std::string>& segments : m_directories) {
+            if (matchSegments(segments, 0, path, 0)) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+}
@@ -0,0 +1,225 @@
+#include <tspp/tspp.h>
+#include <tspp/utils/HeapMonitor.h>
+#include <tspp/utils/HeapProfiler.h>
+#include <utils/Array.hpp>
+
+namespace tspp {
+    HeapMonitor::HeapMonitor(v8::Isolate* isolate, const HeapMonitorConfig& config, HeapProfiler* profiler)
+        : IWithLogging("HeapMonitor") {
+        m_isolate           = isolate;
+        m_config            = config;
+        m_profiler          = profiler;
+        m_nextSampleAt      = Clock::now();
+        m_gcUsedBefore      = 0;
+        m_didWriteSnapshot  = false;
+        m_isSnapshotPending = false;
+        m_heap              = HeapStats{};
+        m_gc                = GCStats{};
+
+        m_isolate->AddGCPrologueCallback(OnGCPrologue, this);
+        m_isolate->AddGCEpilogueCallback(OnGCEpilogue, this);
+        m_isolate->AddNearHeapLimitCallback(OnNearHeapLimit, this);
+    }
+
+    HeapMonitor::~HeapMonitor() {
+        m_isolate->RemoveGCPrologueCallback(OnGCPrologue, this);
+        m_isolate->RemoveGCEpilogueCallback(OnGCEpilogue, this);
+
+        // Leaves the heap limit as it is
+        m_isolate->RemoveNearHeapLimitCallback(OnNearHeapLimit, 0);
+    }
+
+    void HeapMonitor::service() {
+        // In case nothing ran on the isolate to handle the interrupt
+        writePendingSnapshot();
+
+        if (m_config.sampleIntervalMs == 0) {
+            return;
+        }
+
+        Clock::time_point now = Clock::now();
+        if (now < m_nextSampleAt) {
+            return;
+        }
+
+        m_nextSampleAt = now + std::chrono::milliseconds(m_config.sampleIntervalMs);
+        sample();
+    }
+
+    void HeapMonitor::sample() {
+        v8::HeapStatistics heap;
+        m_isolate->GetHeapStatistics(&heap);
+
+        m_heap.totalHeapSize     = heap.total_heap_size();
+        m_heap.usedHeapSize      = heap.used_heap_size();
+        m_heap.heapSizeLimit     = heap.heap_size_limit();
+        m_heap.totalPhysicalSize = heap.total_physical_size();
+        m_heap.mallocedMemory    = heap.malloced_memory();
+        m_heap.externalMemory    = heap.external_memory();
+        m_heap.nativeContexts    = heap.number_of_native_contexts();
+        m_heap.detachedContexts  = heap.number_of_detached_contexts();
+
+        if (m_heap.usedHeapSize > m_heap.peakUsedHeapSize) {
+            m_heap.peakUsedHeapSize = m_heap.usedHeapSize;
+        }
+
+        m_heap.spaces.clear();
+        for (size_t i = 0; i < m_isolate->NumberOfHeapSpaces(); i++) {
+            v8::HeapSpaceStatistics space;
+            if (!m_isolate->GetHeapSpaceStatistics(&space, i)) {
+                continue;
+            }
+
+            HeapSpaceStats stats;
+            stats.name         = space.space_name();
+            stats.size         = space.space_size();
+            stats.used         = space.space_used_size();
+            stats.available    = space.space_available_size();
+            stats.physicalSize = space.physical_space_size();
+            m_heap.spaces.push(stats);
+        }
+    }
+
+    const HeapStats& HeapMonitor::getHeapStats() const {
+        return m_heap;
+    }
+
+    GCStats HeapMonitor::getGCStats() const {
+        GCStats stats    = m_gc;
+        stats.pauseCount = m_pauses.getCount();
+        stats.pauseP50Ms = f64(m_pauses.getPercentile(50.0)) / 1000.0;
+        stats.pauseP99Ms = f64(m_pauses.getPercentile(99.0)) / 1000.0;
+        stats.pauseMaxMs = f64(m_pauses.getMax()) / 1000.0;
+        return stats;
+    }
+
+    void HeapMonitor::reset() {
+        m_gc                    = GCStats{};
+        m_heap.peakUsedHeapSize = m_heap.usedHeapSize;
+        m_pauses.reset();
+    }
+
+    void HeapMonitor::writePendingSnapshot() {
+        if (!m_isSnapshotPending) {
+            return;
+        }
+
+        m_isSnapshotPending = false;
+
+        u64 timestamp =
+            std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch())
+                .count();
+
+        m_profiler->takeHeapSnapshot(
+            String::Format("near-heap-limit-%llu.heapsnapshot", (unsigned long long)timestamp)
+        );
+    }
+
+    GCTypeStats* HeapMonitor::getTypeStats(v8::GCType type) {
+        switch (type) {
+            case v8::kGCTypeScavenge: return &m_gc.scavenge;
+            case v8::kGCTypeMinorMarkSweep: return &m_gc.minorMarkSweep;
+            case v8::kGCTypeMarkSweepCompact: return &m_gc.markSweepCompact;
+            case v8::kGCTypeIncrementalMarking: return &m_gc.incrementalMarking;
+            case v8::kGCTypeProcessWeakCallbacks: return &m_gc.processWeakCallbacks;
+            default: return nullptr;
+        }
+    }
+
+    void HeapMonitor::OnGCPrologue(v8::Isolate* isolate, v8::GCType type, v8::GCCallbackFlags flags, void* data) {
+        HeapMonitor* self = (HeapMonitor*)data;
+
+        v8::HeapStatistics heap;
+        isolate->GetHeapStatistics(&heap);
+
+        self->m_gcUsedBefore = heap.used_heap_size();
+        self->m_gcStartedAt  = Clock::now();
+    }
+
+    void HeapMonitor::OnGCEpilogue(v8::Isolate* isolate, v8::GCType type, v8::GCCallbackFlags flags, void* data) {
+        HeapMonitor* self = (HeapMonitor*)data;
+        u64 pauseUs =
+            std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - self->m_gcStartedAt).count();
+
+        v8::HeapStatistics heap;
+        isolate->GetHeapStatistics(&heap);
+
+        u64 usedAfter      = heap.used_heap_size();
+        u64 bytesReclaimed = self->m_gcUsedBefore > usedAfter ? self->m_gcUsedBefore - usedAfter : 0;
+        f64 pauseMs        = f64(pauseUs) / 1000.0;
+
+        self->m_pauses.record(pauseUs);
+        self->m_gc.totalPauseMs += pauseMs;
+
+        GCTypeStats* stats = self->getTypeStats(type);
+        if (!stats) {
+            return;
+        }
+
+        stats->count++;
+        stats->totalPauseMs += pauseMs;
+        stats->bytesReclaimed += bytesReclaimed;
+        if (pauseMs > stats->maxPauseMs) {
+            stats->maxPauseMs = pauseMs;
+        }
+    }
+
+    size_t HeapMonitor::OnNearHeapLimit(void* data, size_t currentHeapLimit, size_t initialHeapLimit) {
+        HeapMonitor* self = (HeapMonitor*)data;
+        self->m_gc.nearHeapLimitCount++;
+        self->sample();
+
+        self->error(
+            "Heap is near its limit of %llu MB (%llu MB used, initial limit %llu MB)",
+            (unsigned long long)(currentHeapLimit / (1024 * 1024)),
+            (unsigned long long)(self->m_heap.usedHeapSize / (1024 * 1024)),
+            (unsigned long long)(initialHeapLimit / (1024 * 1024))
+        );
+
+        for (const HeapSpaceStats& space : self->m_heap.spaces) {
+            self->error(
+                "    %s: %llu / %llu KB",
+                space.name.c_str(),
+                (unsigned long long)(space.used / 1024),
+                (unsigned long long)(space.size / 1024)
+            );
+        }
+
+        if (self->m_config.heapLimitGrowthPercent == 0 ||
+            self->m_gc.heapLimitExpansions >= self->m_config.maxHeapLimitExpansions) {
+            if (self->m_config.writeSnapshotNearHeapLimit && !self->m_didWriteSnapshot) {
+                // The snapshot itself needs heap, without raising the limit it would only hasten the crash
+                self->m_didWriteSnapshot = true;
+                self->warn("Not writing a heap snapshot, the heap limit can't be raised to make room for it");
+            }
+
+            return currentHeapLimit;
+        }
+
+        size_t newHeapLimit = currentHeapLimit + currentHeapLimit / 100 * self->m_config.heapLimitGrowthPercent;
+        self->m_gc.heapLimitExpansions++;
+
+        self->error(
+            "Raising heap limit to %llu MB, consider increasing ScriptConfig::maximumHeapSize",
+            (unsigned long long)(newHeapLimit / (1024 * 1024))
+        );
+
+        if (self->m_config.writeSnapshotNearHeapLimit && !self->m_didWriteSnapshot) {
+            // V8 only applies the new limit once this returns, so the snapshot is written from an
+            // interrupt (or the next service, whichever comes first) instead of from here
+            self->m_didWriteSnapshot  = true;
+            self->m_isSnapshotPending = true;
+            self->m_isolate->RequestInterrupt(OnSnapshotInterrupt, nullptr);
+        }
+
+        return newHeapLimit;
+    }
+
+    void HeapMonitor::OnSnapshotInterrupt(v8::Isolate* isolate, void* data) {
+        // The monitor may have been destroyed before the interrupt ran
+        Runtime* runtime = Runtime::Get(isolate);
+        if (runtime && runtime->getHeapMonitor()) {
+            runtime->getHeapMonitor()->writePendingSnapshot();
+        }
+    }
+}
@@ -0,0 +1,211 @@
+#include <tspp/utils/HeapProfiler.h>
+#include <tspp/utils/HostObjectManager.h>
+#include <tspp/utils/ProfileOutput.h>
+
+#include <v8-profiler.h>
+
+namespace tspp {
+    /*
+     * Writes the output of HeapSnapshot::Serialize to a file as it's produced
+     */
+    class FileOutputStream : public v8::OutputStream {
+        public:
+            FileOutputStream(std::ofstream& file) : m_file(file) {}
+
+            void EndOfStream() override {}
+
+            int GetChunkSize() override {
+                return 64 * 1024;
+            }
+
+            WriteResult WriteAsciiChunk(char* data, int size) override {
+                m_file.write(data, size);
+                return m_file.good() ? kContinue : kAbort;
+            }
+
+        private:
+            std::ofstream& m_file;
+    };
+
+    /*
+     * Writes a node of a sampling heap profile and its children in the format DevTools expects
+     */
+    static void appendProfileNode(std::string& out, v8::Isolate* isolate, v8::AllocationProfile::Node* node) {
+        v8::String::Utf8Value functionName(isolate, node->name);
+        v8::String::Utf8Value scriptName(isolate, node->script_name);
+
+        u64 selfSize = 0;
+        for (const v8::AllocationProfile::Allocation& allocation : node->allocations) {
+            selfSize += u64(allocation.size) * allocation.count;
+        }
+
+        // DevTools line and column numbers start at 0
+        i32 lineNumber   = node->line_number == v8::AllocationProfile::kNoLineNumberInfo ? -1 : node->line_number - 1;
+        i32 columnNumber = node->column_number == v8::AllocationProfile::kNoColumnNumberInfo
+                               ? -1
+                               : node->column_number - 1;
+
+        out += "{\"callFrame\":{\"functionName\":\"";
+        appendJSONEscaped(out, *functionName ? *functionName : "");
+        out += "\",\"scriptId\":\"";
+        out += std::to_string(node->script_id);
+        out += "\",\"url\":\"";
+        appendJSONEscaped(out, *scriptName ? *scriptName : "");
+        out += String::Format(
+                   "\",\"lineNumber\":%d,\"columnNumber\":%d},\"selfSize\":%llu,\"id\":%u,\"children\":[",
+                   lineNumber,
+                   columnNumber,
+                   (unsigned long long)selfSize,
+                   node->node_id
+        )
+                   .c_str();
+
+        for (size_t i = 0; i < node->children.size(); i++) {
+            if (i > 0) {
+                out += ",";
+            }
+
+            appendProfileNode(out, isolate, node->children[i]);
+        }
+
+        out += "]}";
+    }
+
+    HeapProfiler::HeapProfiler(v8::Isolate* isolate, const String& outputDirectory) : IWithLogging("HeapProfiler") {
+        m_isolate         = isolate;
+        m_outputDirectory = outputDirectory;
+        m_isSampling      = false;
+
+        m_isolate->GetHeapProfiler()->AddBuildEmbedderGraphCallback(BuildEmbedderGraph, this);
+    }
+
+    HeapProfiler::~HeapProfiler() {
+        if (m_isSampling) {
+            m_isolate->GetHeapProfiler()->StopSamplingHeapProfiler();
+            m_isSampling = false;
+        }
+
+        m_isolate->GetHeapProfiler()->RemoveBuildEmbedderGraphCallback(BuildEmbedderGraph, this);
+    }
+
+    bool HeapProfiler::takeHeapSnapshot(const String& path) {
+        std::filesystem::path outputPath = std::filesystem::path(resolvePath(path).c_str());
+
+        std::ofstream file;
+        if (!openOutputFile(outputPath, file)) {
+            error("Failed to open '%s' for writing", outputPath.string().c_str());
+            return false;
+        }
+
+        v8::HandleScope scope(m_isolate);
+        const v8::HeapSnapshot* snapshot = m_isolate->GetHeapProfiler()->TakeHeapSnapshot();
+        if (!snapshot) {
+            error("Failed to take heap snapshot");
+            return false;
+        }
+
+        FileOutputStream stream(file);
+        snapshot->Serialize(&stream, v8::HeapSnapshot::kJSON);
+        i32 nodeCount = snapshot->GetNodesCount();
+        const_cast<v8::HeapSnapshot*>(snapshot)->Delete();
+
+        file.close();
+        if (file.fail()) {
+            error("Failed to write heap snapshot to '%s'", outputPath.string().c_str());
+            return false;
+        }
+
+        log("Wrote heap snapshot with %d nodes to '%s'", nodeCount, outputPath.string().c_str());
+        return true;
+    }
+
+    bool HeapProfiler::startSamplingHeapProfile(u32 samplingIntervalBytes, u32 stackDepth) {
+        if (m_isSampling) {
+            error("Can't start sampling heap profile, allocations are already being sampled");
+            return false;
+        }
+
+        if (samplingIntervalBytes == 0) {
+            error("Can't start sampling heap profile, the sampling interval must be greater than 0");
+            return false;
+        }
+
+        if (!m_isolate->GetHeapProfiler()->StartSamplingHeapProfiler(samplingIntervalBytes, i32(stackDepth))) {
+            error("Failed to start sampling heap profile");
+            return false;
+        }
+
+        m_isSampling = true;
+
+        log("Started sampling heap profile (sampling every %u bytes)", samplingIntervalBytes);
+        return true;
+    }
+
+    bool HeapProfiler::stopSamplingHeapProfile(const String& path) {
+        if (!m_isSampling) {
+            error("Can't stop sampling heap profile, allocations are not being sampled");
+            return false;
+        }
+
+        v8::HandleScope scope(m_isolate);
+        v8::AllocationProfile* profile = m_isolate->GetHeapProfiler()->GetAllocationProfile();
+        m_isolate->GetHeapProfiler()->StopSamplingHeapProfiler();
+        m_isSampling = false;
+
+        if (!profile) {
+            error("Failed to get sampling heap profile");
+            return false;
+        }
+
+        std::string json = "{\"head\":";
+        appendProfileNode(json, m_isolate, profile->GetRootNode());
+        json += ",\"samples\":[";
+
+        const std::vector<v8::AllocationProfile::Sample>& samples = profile->GetSamples();
+        size_t sampleCount                                        = samples.size();
+        for (size_t i = 0; i < samples.size(); i++) {
+            const v8::AllocationProfile::Sample& sample = samples[i];
+            json += String::Format(
+                        "%s{\"size\":%llu,\"nodeId\":%u,\"ordinal\":%llu}",
+                        i > 0 ? "," : "",
+                        (unsigned long long)(u64(sample.size) * sample.count),
+                        sample.node_id,
+                        (unsigned long long)sample.sample_id
+            )
+                        .c_str();
+        }
+
+        json += "]}";
+        delete profile;
+
+        std::filesystem::path outputPath = std::filesystem::path(resolvePath(path).c_str());
+        if (!writeOutputFile(outputPath, json)) {
+            error("Failed to write sampling heap profile to '%s'", outputPath.string().c_str());
+            return false;
+        }
+
+        log(
+            "Wrote sampling heap profile with %llu samples to '%s'",
+            (unsigned long long)sampleCount,
+            outputPath.string().c_str()
+        );
+        return true;
+    }
+
+    bool HeapProfiler::isSampling() const {
+        return m_isSampling;
+    }
+
+    String HeapProfiler::resolvePath(const String& path) const {
+        std::filesystem::path resolved = std::filesystem::path(path.c_str());
+        if (resolved.is_relative()) {
+            resolved = std::filesystem::path(m_outputDirectory.c_str()) / resolved;
+        }
+
+        return resolved.string().c_str();
+    }
+
+    void HeapProfiler::BuildEmbedderGraph(v8::Isolate* isolate, v8::EmbedderGraph* graph, void* data) {
+        HostObjectManager::AddAllToEmbedderGraph(isolate, graph);
+    }
+}
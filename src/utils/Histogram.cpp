@@ -0,0 +1,111 @@
+#include <tspp/utils/Histogram.h>
+
+#include <bit>
+#include <string.h>
+
+namespace tspp {
+    static u64 getBucketLowerBound(u32 index) {
+        if (index < Histogram::LinearBucketCount) {
+            return index;
+        }
+
+        constexpr u32 subBuckets = 1 << Histogram::SubBucketBits;
+        u32 exponent             = (index - Histogram::LinearBucketCount) / subBuckets + Histogram::SubBucketBits;
+        u32 sub                  = (index - Histogram::LinearBucketCount) % subBuckets;
+        return u64(subBuckets + sub) << (exponent - Histogram::SubBucketBits);
+    }
+
+    Histogram::Histogram() {
+        reset();
+    }
+
+    void Histogram::record(u64 value) {
+        m_buckets[GetBucketIndex(value)]++;
+
+        if (m_count == 0 || value < m_min) {
+            m_min = value;
+        }
+
+        if (value > m_max) {
+            m_max = value;
+        }
+
+        m_count++;
+        m_sum += value;
+    }
+
+    void Histogram::reset() {
+        memset(m_buckets, 0, sizeof(m_buckets));
+        m_count = 0;
+        m_sum   = 0;
+        m_min   = 0;
+        m_max   = 0;
+    }
+
+    u64 Histogram::getCount() const {
+        return m_count;
+    }
+
+    u64 Histogram::getSum() const {
+        return m_sum;
+    }
+
+    u64 Histogram::getMin() const {
+        return m_min;
+    }
+
+    u64 Histogram::getMax() const {
+        return m_max;
+    }
+
+    f64 Histogram::getMean() const {
+        return m_count > 0 ? f64(m_sum) / f64(m_count) : 0.0;
+    }
+
+    u64 Histogram::getPercentile(f64 percentile) const {
+        if (m_count == 0) {
+            return 0;
+        }
+
+        // Rank of the value at the percentile, counting from 1
+        u64 rank = u64(f64(m_count) * percentile / 100.0 + 0.5);
+        if (rank < 1) {
+            rank = 1;
+        } else if (rank > m_count) {
+            rank = m_count;
+        }
+
+        u64 seen = 0;
+        for (u32 i = 0; i < BucketCount; i++) {
+            seen += m_buckets[i];
+            if (seen >= rank) {
+                u64 upperBound = GetBucketUpperBound(i);
+                return upperBound < m_max ? upperBound : m_max;
+            }
+        }
+
+        return m_max;
+    }
+
+    u64 Histogram::getBucketCount(u32 index) const {
+        return m_buckets[index];
+    }
+
+    u32 Histogram::GetBucketIndex(u64 value) {
+        if (value < LinearBucketCount) {
+            return u32(value);
+        }
+
+        u32 exponent = u32(std::bit_width(value)) - 1;
+        u32 sub      = u32(value >> (exponent - SubBucketBits)) & ((1 << SubBucketBits) - 1);
+        return LinearBucketCount + (exponent - SubBucketBits) * (1 << SubBucketBits) + sub;
+    }
+
+    u64 Histogram::GetBucketUpperBound(u32 index) {
+        if (index + 1 >= BucketCount) {
+            return UINT64_MAX;
+        }
+
+        return getBucketLowerBound(index + 1) - 1;
+    }
+}
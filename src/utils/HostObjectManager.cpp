@@ -1,9 +1,17 @@
 #include <bind/DataType.h>
 #include <bind/Function.h>
+#include <bind/Registry.h>
+#include <tspp/tspp.h>
 #include <tspp/utils/HostObjectManager.h>
 #include <utils/Exception.h>
 
+#include <v8-profiler.h>
+
 namespace tspp {
+    // Ids are shared by every runtime, but types are only registered while bindings are committed
+    static std::mutex s_typeIdMutex;
+    static u32 s_typeCount = 0;
+
     struct ObjectData_TempWorkaround {
             void* mem;
             HostObjectManager* manager;
@@ -14,11 +22,44 @@ namespace tspp {
         data->manager->free(data->mem);
     }
 
+    /*
+     * A host object in a heap snapshot. V8 merges it into the node of the object that wraps it, so
+     * the wrapper is shown with the bound type's name and the host object's size.
+     */
+    class HostObjectNode : public v8::EmbedderGraph::Node {
+        public:
+            HostObjectNode(const char* name, size_t size, v8::EmbedderGraph::Node* wrapper, void* mem)
+                : m_name(name), m_size(size), m_wrapper(wrapper), m_mem(mem) {}
+
+            const char* Name() override {
+                return m_name;
+            }
+
+            size_t SizeInBytes() override {
+                return m_size;
+            }
+
+            Node* WrapperNode() override {
+                return m_wrapper;
+            }
+
+            v8::NativeObject GetNativeObject() override {
+                return m_mem;
+            }
+
+        private:
+            const char* m_name;
+            size_t m_size;
+            v8::EmbedderGraph::Node* m_wrapper;
+            void* m_mem;
+    };
+
     HostObjectManager::HostObjectManager(bind::DataType* dataType, u32 elementsPerPool)
         : IWithLogging(String::Format("HostObjectManager[%s]", dataType->getName().c_str())),
           m_pool(dataType->getInfo().size, elementsPerPool, false) {
-        m_dataType   = dataType;
-        m_destructor = dataType->getDestructor();
+        m_dataType        = dataType;
+        m_destructor      = dataType->getDestructor();
+        m_externalMemSize = 0;
     }
 
     HostObjectManager::~HostObjectManager() {
@@ -27,12 +68,12 @@ namespace tspp {
         // in a specific order based on interdependencies between them...
 
         if (m_destructor && m_liveObjects.size() > 0) {
-            void* args[] = {nullptr};
             for (auto& pair : m_liveObjects) {
-                args[0] = pair.first;
+                void* mem    = pair.first;
+                void* args[] = {&mem};
                 m_destructor->call(nullptr, args);
 
-                ObjRef& ref = pair.second;
+                ObjRef& ref = pair.second.ref;
 
                 if (ref->IsEmpty()) {
                     warn(
@@ -49,30 +90,50 @@ namespace tspp {
     }
 
     void* HostObjectManager::alloc(const v8::Local<v8::Object>& target) {
-        void* mem  = m_pool.alloc();
-        ObjRef ref = std::make_unique<v8::Global<v8::Object>>(target->GetIsolate(), target);
+        std::lock_guard<std::recursive_mutex> lock(m_mutex);
 
-        bindGCListener(ref, mem);
+        void* mem = m_pool.alloc();
+
+        LiveObject object;
+        object.ref          = std::make_unique<v8::Global<v8::Object>>(target->GetIsolate(), target);
+        object.isolate      = target->GetIsolate();
+        object.externalSize = 0;
+        object.isReported   = false;
+
+        bindGCListener(object.ref, mem);
+
+        // The object hasn't been constructed yet, so only its own size is reported for now
+        reportSize(object, mem, false);
 
-        m_liveObjects.insert(std::make_pair(mem, std::move(ref)));
+        m_liveObjects.insert(std::make_pair(mem, std::move(object)));
         return mem;
     }
 
     void* HostObjectManager::preemptiveAlloc() {
-        void* mem  = m_pool.alloc();
-        ObjRef ref = std::make_unique<v8::Global<v8::Object>>();
-        m_liveObjects.insert(std::make_pair(mem, std::move(ref)));
+        std::lock_guard<std::recursive_mutex> lock(m_mutex);
+
+        void* mem = m_pool.alloc();
+
+        LiveObject object;
+        object.ref          = std::make_unique<v8::Global<v8::Object>>();
+        object.isolate      = nullptr;
+        object.externalSize = 0;
+        object.isReported   = false;
+
+        m_liveObjects.insert(std::make_pair(mem, std::move(object)));
         return mem;
     }
 
     void HostObjectManager::assignTarget(void* mem, const v8::Local<v8::Object>& target) {
+        std::lock_guard<std::recursive_mutex> lock(m_mutex);
+
         auto it = m_liveObjects.find(mem);
         if (it == m_liveObjects.end()) {
             error("Attempted to assign target to a memory block that was not allocated by this manager.");
             return;
         }
 
-        ObjRef& ref = it->second;
+        ObjRef& ref = it->second.ref;
         if (!ref->IsEmpty()) {
             error("Attempted to assign target to a memory block that already has a JS object reference.");
             return;
@@ -81,15 +142,27 @@ namespace tspp {
         ref->Reset(target->GetIsolate(), target);
 
         bindGCListener(ref, mem);
+
+        it->second.isolate = target->GetIsolate();
+        reportSize(it->second, mem, true);
     }
 
     void HostObjectManager::free(void* mem) {
+        std::lock_guard<std::recursive_mutex> lock(m_mutex);
+
         auto it = m_liveObjects.find(mem);
         if (it == m_liveObjects.end()) {
             error("Attempted to free a memory block that was not allocated by this manager.");
             return;
         }
 
+        LiveObject& object = it->second;
+        if (object.isReported) {
+            u64 reportedSize = m_dataType->getInfo().size + object.externalSize;
+            object.isolate->AdjustAmountOfExternalAllocatedMemory(-i64(reportedSize));
+            m_externalMemSize -= object.externalSize;
+        }
+
         if (m_destructor) {
             void* args[] = {&mem};
             m_destructor->call(nullptr, args);
@@ -102,20 +175,43 @@ namespace tspp {
     }
 
     u32 HostObjectManager::getLiveCount() {
+        std::lock_guard<std::recursive_mutex> lock(m_mutex);
+
         return m_liveObjects.size();
     }
 
     u32 HostObjectManager::getLiveMemSize() {
+        std::lock_guard<std::recursive_mutex> lock(m_mutex);
+
         return m_liveObjects.size() * m_dataType->getInfo().size;
     }
 
+    u64 HostObjectManager::getExternalMemSize() {
+        std::lock_guard<std::recursive_mutex> lock(m_mutex);
+
+        return m_externalMemSize;
+    }
+
+    HostObjectStats HostObjectManager::getStats() {
+        std::lock_guard<std::recursive_mutex> lock(m_mutex);
+
+        HostObjectStats stats;
+        stats.dataType        = m_dataType;
+        stats.liveCount       = u32(m_liveObjects.size());
+        stats.liveMemSize     = u64(m_liveObjects.size()) * m_dataType->getInfo().size;
+        stats.externalMemSize = m_externalMemSize;
+        return stats;
+    }
+
     v8::Local<v8::Object> HostObjectManager::getTargetIfMapped(v8::Isolate* isolate, void* mem) {
+        std::lock_guard<std::recursive_mutex> lock(m_mutex);
+
         auto it = m_liveObjects.find(mem);
         if (it == m_liveObjects.end()) {
             return v8::Local<v8::Object>();
         }
 
-        ObjRef& ref = it->second;
+        ObjRef& ref = it->second.ref;
         if (ref->IsEmpty()) {
             warn(
                 "Found allocated object with no JS object reference. "
@@ -124,11 +220,129 @@ namespace tspp {
             return v8::Local<v8::Object>();
         }
 
+        // Handles can't cross isolates, another runtime has to create its own wrapper
+        if (it->second.isolate != isolate) {
+            return v8::Local<v8::Object>();
+        }
+
         return ref->Get(isolate);
     }
 
+    void HostObjectManager::updateExternalSize(void* mem) {
+        std::lock_guard<std::recursive_mutex> lock(m_mutex);
+
+        auto it = m_liveObjects.find(mem);
+        if (it == m_liveObjects.end()) {
+            error("Attempted to update the size of a memory block that was not allocated by this manager.");
+            return;
+        }
+
+        // Not reported until the object has a JS reference, assignTarget will measure it
+        if (!it->second.isolate) {
+            return;
+        }
+
+        reportSize(it->second, mem, true);
+    }
+
+    void HostObjectManager::RegisterType(bind::DataType* dataType) {
+        std::lock_guard<std::mutex> lock(s_typeIdMutex);
+
+        DataTypeUserData& userData = dataType->getUserData<DataTypeUserData>();
+        if (userData.hostObjectManagerId == 0) {
+            userData.hostObjectManagerId = ++s_typeCount;
+        }
+    }
+
+    HostObjectManager* HostObjectManager::Get(v8::Isolate* isolate, bind::DataType* dataType) {
+        Runtime* runtime = Runtime::Get(isolate);
+        if (!runtime) {
+            return nullptr;
+        }
+
+        return runtime->getHostObjectManager(dataType);
+    }
+
+    Array<HostObjectStats> HostObjectManager::GetAllStats(v8::Isolate* isolate) {
+        Array<HostObjectStats> stats;
+
+        Runtime* runtime = Runtime::Get(isolate);
+        if (!runtime) {
+            return stats;
+        }
+
+        const Array<bind::DataType*>& dataTypes = bind::Registry::Types();
+        for (bind::DataType* dataType : dataTypes) {
+            HostObjectManager* objMgr = runtime->getHostObjectManager(dataType, false);
+            if (objMgr) {
+                stats.push(objMgr->getStats());
+            }
+        }
+
+        return stats;
+    }
+
+    void HostObjectManager::addToEmbedderGraph(v8::Isolate* isolate, v8::EmbedderGraph* graph) {
+        std::lock_guard<std::recursive_mutex> lock(m_mutex);
+        v8::HandleScope scope(isolate);
+
+        for (auto& pair : m_liveObjects) {
+            LiveObject& object = pair.second;
+            if (object.isolate != isolate || object.ref->IsEmpty()) {
+                continue;
+            }
+
+            v8::EmbedderGraph::Node* wrapper = graph->V8Node(object.ref->Get(isolate));
+            graph->AddNode(std::make_unique<HostObjectNode>(
+                m_dataType->getName().c_str(), m_dataType->getInfo().size + object.externalSize, wrapper, pair.first
+            ));
+        }
+    }
+
+    void HostObjectManager::AddAllToEmbedderGraph(v8::Isolate* isolate, v8::EmbedderGraph* graph) {
+        Runtime* runtime = Runtime::Get(isolate);
+        if (!runtime) {
+            return;
+        }
+
+        const Array<bind::DataType*>& dataTypes = bind::Registry::Types();
+        for (bind::DataType* dataType : dataTypes) {
+            HostObjectManager* objMgr = runtime->getHostObjectManager(dataType, false);
+            if (objMgr) {
+                objMgr->addToEmbedderGraph(isolate, graph);
+            }
+        }
+    }
+
     void HostObjectManager::bindGCListener(ObjRef& ref, void* mem) {
         ObjectData_TempWorkaround* data = new ObjectData_TempWorkaround({mem, this});
         ref->SetWeak(data, WeakCallback, v8::WeakCallbackType::kParameter);
     }
+
+    void HostObjectManager::reportSize(LiveObject& object, void* mem, bool isConstructed) {
+        u64 baseSize     = m_dataType->getInfo().size;
+        u64 externalSize = 0;
+
+        ExternalSizeFn sizeOf = m_dataType->getUserData<DataTypeUserData>().externalSizeOf;
+        if (isConstructed && sizeOf) {
+            externalSize = sizeOf(mem);
+        }
+
+        i64 change = i64(baseSize + externalSize);
+        if (object.isReported) {
+            change -= i64(baseSize + object.externalSize);
+        }
+
+        m_externalMemSize   = m_externalMemSize - object.externalSize + externalSize;
+        object.externalSize = externalSize;
+        object.isReported   = true;
+
+        if (change != 0) {
+            object.isolate->AdjustAmountOfExternalAllocatedMemory(change);
+        }
+    }
+
+    void setExternalSizeOf(bind::DataType* dataType, ExternalSizeFn sizeOf) {
+        dataType->getUserData<DataTypeUserData>().externalSizeOf = sizeOf;
+    }
 }
\ No newline at end of file
@@ -0,0 +1,57 @@
+#include <tspp/utils/IsolateMonitor.h>
+
+#include <chrono>
+
+#include <v8.h>
+
+namespace tspp {
+    IsolateMonitor::IsolateMonitor(const String& name, u32 checkIntervalMs) : IWithLogging(name) {
+        m_isolate         = nullptr;
+        m_isActive        = false;
+        m_checkIntervalMs = checkIntervalMs;
+        m_doStop          = false;
+    }
+
+    void IsolateMonitor::startMonitoring(v8::Isolate* isolate) {
+        m_isolate = isolate;
+        m_doStop  = false;
+
+        m_thread.reset([this]() { run(); });
+    }
+
+    void IsolateMonitor::stopMonitoring() {
+        if (!m_isolate) {
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_doStop = true;
+        }
+
+        m_condition.notify_all();
+        m_thread.waitForExit();
+
+        m_isolate = nullptr;
+    }
+
+    void IsolateMonitor::requestInterrupt() {
+        m_isolate->RequestInterrupt(OnInterrupt, this);
+    }
+
+    void IsolateMonitor::run() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (!m_doStop) {
+            m_condition.wait_for(lock, std::chrono::milliseconds(m_checkIntervalMs));
+            if (m_doStop || !m_isActive) {
+                continue;
+            }
+
+            check();
+        }
+    }
+
+    void IsolateMonitor::OnInterrupt(v8::Isolate* isolate, void* data) {
+        ((IsolateMonitor*)data)->interrupt(isolate);
+    }
+}
@@ -0,0 +1,90 @@
+#include <tspp/utils/PerfMap.h>
+
+#include <atomic>
+#include <mutex>
+#include <stdio.h>
+
+#ifdef __linux__
+    #include <unistd.h>
+#endif
+
+namespace tspp {
+    static std::atomic<bool> s_isEnabled = false;
+    static std::mutex s_mutex;
+
+    // Entries written since the last flush. Entries are kept after the code is freed, perf needs
+    // them for samples taken before then.
+    static FILE* s_fragment = nullptr;
+
+    #ifdef __linux__
+    static String getMapPath(const char* suffix) {
+        return String::Format("/tmp/perf-%d%s.map", int(getpid()), suffix);
+    }
+    #endif
+
+    void PerfMap::Enable() {
+        s_isEnabled.store(true, std::memory_order_relaxed);
+    }
+
+    bool PerfMap::IsEnabled() {
+        return s_isEnabled.load(std::memory_order_relaxed);
+    }
+
+    void PerfMap::AddEntry(const void* address, u64 size, const String& name) {
+        #ifdef __linux__
+        if (!IsEnabled()) {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(s_mutex);
+        if (!s_fragment) {
+            s_fragment = fopen(getMapPath(".tspp").c_str(), "w");
+            if (!s_fragment) {
+                return;
+            }
+        }
+
+        fprintf(
+            s_fragment, "%llx %llx %s\n", (unsigned long long)uintptr_t(address), (unsigned long long)size, name.c_str()
+        );
+
+        // Trampolines are only generated once per callback, so flushing each one costs little
+        fflush(s_fragment);
+        #endif
+    }
+
+    void PerfMap::Flush() {
+        #ifdef __linux__
+        std::lock_guard<std::mutex> lock(s_mutex);
+        if (!s_fragment) {
+            return;
+        }
+
+        fclose(s_fragment);
+        s_fragment = nullptr;
+
+        String fragmentPath = getMapPath(".tspp");
+        FILE* fragment      = fopen(fragmentPath.c_str(), "r");
+        if (!fragment) {
+            return;
+        }
+
+        FILE* map = fopen(getMapPath("").c_str(), "a");
+        if (!map) {
+            // Left in place so that it can still be appended by hand
+            fclose(fragment);
+            return;
+        }
+
+        char buffer[4096];
+        size_t count;
+        while ((count = fread(buffer, 1, sizeof(buffer), fragment)) > 0) {
+            fwrite(buffer, 1, count, map);
+        }
+
+        fclose(map);
+        fclose(fragment);
+        remove(fragmentPath.c_str());
+        #endif
+    }
+}
@@ -0,0 +1,234 @@
+#define TSPP_INCLUDING_WINDOWS_H
+
+#include <tspp/utils/PollHandle.h>
+
+#ifdef _WIN32
+    #include <Windows.h>
+#elif defined(__linux__)
+    #include <errno.h>
+    #include <sys/epoll.h>
+    #include <sys/eventfd.h>
+    #include <sys/timerfd.h>
+    #include <unistd.h>
+#endif
+
+namespace tspp {
+    PollHandle::PollHandle() : IWithLogging("PollHandle") {
+        m_isOpen      = false;
+        m_hasDeadline = false;
+
+        #ifdef _WIN32
+        m_event = nullptr;
+        #else
+        m_epollFd = -1;
+        m_eventFd = -1;
+        m_timerFd = -1;
+        #endif
+    }
+
+    PollHandle::~PollHandle() {
+        close();
+    }
+
+    bool PollHandle::open() {
+        if (m_isOpen) {
+            return true;
+        }
+
+        #ifdef _WIN32
+        m_event = CreateEventA(nullptr, TRUE, FALSE, nullptr);
+        if (!m_event) {
+            error("Failed to create event (%lu)", GetLastError());
+            return false;
+        }
+        #elif defined(__linux__)
+        m_epollFd = epoll_create1(EPOLL_CLOEXEC);
+        m_eventFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        m_timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+
+        if (m_epollFd == -1 || m_eventFd == -1 || m_timerFd == -1) {
+            error("Failed to create file descriptors (errno %d)", errno);
+            close();
+            return false;
+        }
+
+        epoll_event event = {};
+        event.events      = EPOLLIN;
+
+        event.data.fd = m_eventFd;
+        if (epoll_ctl(m_epollFd, EPOLL_CTL_ADD, m_eventFd, &event) == -1) {
+            error("Failed to add eventfd to epoll set (errno %d)", errno);
+            close();
+            return false;
+        }
+
+        event.data.fd = m_timerFd;
+        if (epoll_ctl(m_epollFd, EPOLL_CTL_ADD, m_timerFd, &event) == -1) {
+            error("Failed to add timerfd to epoll set (errno %d)", errno);
+            close();
+            return false;
+        }
+        #else
+        error("Poll handles are not supported on this platform");
+        return false;
+        #endif
+
+        m_isOpen      = true;
+        m_hasDeadline = false;
+        return true;
+    }
+
+    void PollHandle::close() {
+        #ifdef _WIN32
+        if (m_event) {
+            CloseHandle(m_event);
+            m_event = nullptr;
+        }
+        #else
+        if (m_epollFd != -1) {
+            ::close(m_epollFd);
+            m_epollFd = -1;
+        }
+
+        if (m_eventFd != -1) {
+            ::close(m_eventFd);
+            m_eventFd = -1;
+        }
+
+        if (m_timerFd != -1) {
+            ::close(m_timerFd);
+            m_timerFd = -1;
+        }
+        #endif
+
+        m_isOpen      = false;
+        m_hasDeadline = false;
+    }
+
+    PollHandle::NativeHandle PollHandle::getNativeHandle() const {
+        #ifdef _WIN32
+        return m_event;
+        #else
+        return m_epollFd;
+        #endif
+    }
+
+    void PollHandle::signal() {
+        if (!m_isOpen) {
+            return;
+        }
+
+        #ifdef _WIN32
+        SetEvent(m_event);
+        #elif defined(__linux__)
+        // Only fails if the counter would overflow, in which case it's already readable
+        u64 value      = 1;
+        ssize_t result = ::write(m_eventFd, &value, sizeof(value));
+        (void)result;
+        #endif
+    }
+
+    bool PollHandle::wait() {
+        if (!m_isOpen) {
+            return false;
+        }
+
+        #ifdef _WIN32
+        // Deadlines aren't represented by the event
+        DWORD timeoutMs = INFINITE;
+        if (m_hasDeadline) {
+            Clock::duration remaining = m_deadline - Clock::now();
+            timeoutMs = remaining > Clock::duration::zero()
+                            ? DWORD(std::chrono::ceil<std::chrono::milliseconds>(remaining).count())
+                            : 0;
+        }
+
+        if (WaitForSingleObject(m_event, timeoutMs) == WAIT_FAILED) {
+            error("Failed to wait for event (%lu)", GetLastError());
+            return false;
+        }
+
+        return true;
+        #elif defined(__linux__)
+        epoll_event event;
+        while (epoll_wait(m_epollFd, &event, 1, -1) == -1) {
+            if (errno != EINTR) {
+                error("Failed to wait for epoll set (errno %d)", errno);
+                return false;
+            }
+        }
+
+        return true;
+        #else
+        return false;
+        #endif
+    }
+
+    void PollHandle::clear() {
+        if (!m_isOpen) {
+            return;
+        }
+
+        #ifdef _WIN32
+        ResetEvent(m_event);
+        #elif defined(__linux__)
+        // Both are non-blocking, reading resets the eventfd counter and the timerfd expiration count
+        u64 value      = 0;
+        ssize_t result = ::read(m_eventFd, &value, sizeof(value));
+        result         = ::read(m_timerFd, &value, sizeof(value));
+        (void)result;
+        #endif
+
+        clearDeadline();
+    }
+
+    void PollHandle::setDeadline(Clock::time_point deadline) {
+        if (!m_isOpen) {
+            return;
+        }
+
+        m_hasDeadline = true;
+        m_deadline    = deadline;
+
+        // The timer is relative since the clock used by timers isn't necessarily monotonic
+        Clock::duration remaining = deadline - Clock::now();
+        if (remaining <= Clock::duration::zero()) {
+            signal();
+            return;
+        }
+
+        #ifdef __linux__
+        u64 remainingNs = std::chrono::duration_cast<std::chrono::nanoseconds>(remaining).count();
+
+        itimerspec spec       = {};
+        spec.it_value.tv_sec  = time_t(remainingNs / 1000000000);
+        spec.it_value.tv_nsec = long(remainingNs % 1000000000);
+        if (timerfd_settime(m_timerFd, 0, &spec, nullptr) == -1) {
+            // Better to service early than not at all
+            error("Failed to arm timerfd (errno %d)", errno);
+            signal();
+        }
+        #endif
+    }
+
+    void PollHandle::setDeadlineIfEarlier(Clock::time_point deadline) {
+        if (m_hasDeadline && m_deadline <= deadline) {
+            return;
+        }
+
+        setDeadline(deadline);
+    }
+
+    void PollHandle::clearDeadline() {
+        if (!m_isOpen) {
+            return;
+        }
+
+        m_hasDeadline = false;
+
+        #ifdef __linux__
+        itimerspec spec = {};
+        timerfd_settime(m_timerFd, 0, &spec, nullptr);
+        #endif
+    }
+}
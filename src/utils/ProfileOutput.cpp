@@ -0,0 +1,58 @@
+#include <tspp/utils/ProfileOutput.h>
+
+namespace tspp {
+    void appendJSONEscaped(std::string& out, const char* str) {
+        for (const char* c = str; *c; c++) {
+            switch (*c) {
+                case '"': out += "\\\""; break;
+                case '\\': out += "\\\\"; break;
+                case '\n': out += "\\n"; break;
+                case '\t': out += "\\t"; break;
+                default: {
+                    if (u8(*c) < 0x20) {
+                        out += String::Format("\\u%04x", u32(u8(*c))).c_str();
+                    } else {
+                        out += *c;
+                    }
+                    break;
+                }
+            }
+        }
+    }
+
+    bool isPlainFileName(const String& name) {
+        if (name.size() == 0 || name == "." || name == "..") {
+            return false;
+        }
+
+        for (const char* c = name.c_str(); *c; c++) {
+            if (*c == '/' || *c == '\\' || *c == ':') {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool openOutputFile(const std::filesystem::path& path, std::ofstream& file) {
+        if (path.has_parent_path()) {
+            // Failure shows up when the file can't be opened
+            std::error_code ec;
+            std::filesystem::create_directories(path.parent_path(), ec);
+        }
+
+        file.open(path, std::ios::binary);
+        return file.is_open();
+    }
+
+    bool writeOutputFile(const std::filesystem::path& path, const std::string& data) {
+        std::ofstream file;
+        if (!openOutputFile(path, file)) {
+            return false;
+        }
+
+        file.write(data.c_str(), data.size());
+        file.close();
+        return !file.fail();
+    }
+}
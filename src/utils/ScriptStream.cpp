@@ -0,0 +1,170 @@
+#include <tspp/tspp.h>
+#include <tspp/utils/ScriptStream.h>
+
+#include <fstream>
+
+namespace tspp {
+    class ScriptStream::SourceStream : public v8::ScriptCompiler::ExternalSourceStream {
+        public:
+            SourceStream(ScriptStream* stream) : m_stream(stream) {}
+
+            size_t GetMoreData(const uint8_t** src) override {
+                static constexpr size_t ChunkSize = 64 * 1024;
+
+                if (m_stream->m_isFile) {
+                    // Read the file in chunks so parsing can start before it's been read entirely
+                    if (!m_file.is_open()) {
+                        m_file.open(m_stream->m_filename.c_str(), std::ios::in | std::ios::binary);
+                        if (!m_file.is_open()) {
+                            m_stream->m_readFailed = true;
+                            return 0;
+                        }
+                    }
+
+                    uint8_t* chunk = new uint8_t[ChunkSize];
+                    m_file.read((char*)chunk, ChunkSize);
+                    size_t count = (size_t)m_file.gcount();
+
+                    if (count == 0) {
+                        delete[] chunk;
+                        return 0;
+                    }
+
+                    m_stream->m_code.append((const char*)chunk, count);
+                    *src = chunk;
+                    return count;
+                }
+
+                size_t remaining = m_stream->m_code.size() - m_stream->m_codeOffset;
+                size_t count     = remaining < ChunkSize ? remaining : ChunkSize;
+                if (count == 0) {
+                    return 0;
+                }
+
+                // V8 takes ownership of the data it's given
+                uint8_t* chunk = new uint8_t[count];
+                memcpy(chunk, m_stream->m_code.data() + m_stream->m_codeOffset, count);
+                m_stream->m_codeOffset += count;
+
+                *src = chunk;
+                return count;
+            }
+
+        private:
+            ScriptStream* m_stream;
+            std::ifstream m_file;
+    };
+
+    class ScriptStream::StreamJob : public IJob {
+        public:
+            StreamJob(const std::shared_ptr<ScriptStream>& stream) : m_stream(stream) {}
+
+            void run() override {
+                m_stream->m_task->Run();
+
+                std::lock_guard<std::mutex> lock(m_stream->m_parseMutex);
+                m_stream->m_isParsed = true;
+                m_stream->m_parseCondition.notify_all();
+            }
+
+            void afterComplete() override {
+                m_stream->onParsed();
+            }
+
+            const char* getName() const override {
+                return "script stream";
+            }
+
+        private:
+            std::shared_ptr<ScriptStream> m_stream;
+    };
+
+    ScriptStream::ScriptStream(const String& filename) {
+        m_filename   = filename;
+        m_isFile     = true;
+        m_codeOffset = 0;
+        m_readFailed = false;
+        m_isParsed   = false;
+    }
+
+    ScriptStream::ScriptStream(const String& filename, const String& code) {
+        m_filename = filename;
+        m_isFile   = false;
+        m_code.assign(code.c_str(), code.size());
+        m_codeOffset = 0;
+        m_readFailed = false;
+        m_isParsed   = false;
+    }
+
+    ScriptStream::~ScriptStream() {}
+
+    void ScriptStream::begin(Runtime* runtime, const std::function<void(ScriptStream*)>& onParsed) {
+        m_onParsed = onParsed;
+        m_source.reset(new v8::ScriptCompiler::StreamedSource(
+            std::make_unique<SourceStream>(this), v8::ScriptCompiler::StreamedSource::UTF8
+        ));
+        m_task.reset(v8::ScriptCompiler::StartStreaming(runtime->getIsolate(), m_source.get()));
+
+        runtime->submitJob(new StreamJob(shared_from_this()));
+    }
+
+    void ScriptStream::waitForParse() {
+        if (m_isParsed) {
+            return;
+        }
+
+        std::unique_lock<std::mutex> lock(m_parseMutex);
+        m_parseCondition.wait(lock, [this] { return m_isParsed.load(); });
+    }
+
+    bool ScriptStream::isParsed() const {
+        return m_isParsed;
+    }
+
+    bool ScriptStream::didReadFail() const {
+        return m_readFailed;
+    }
+
+    v8::MaybeLocal<v8::Script> ScriptStream::compile(v8::Local<v8::Context> context) {
+        v8::Isolate* isolate = context->GetIsolate();
+        v8::EscapableHandleScope scope(isolate);
+
+        waitForParse();
+
+        if (m_readFailed) {
+            String msg = String::Format("Failed to read script file '%s'", m_filename.c_str());
+            isolate->ThrowException(v8::Exception::Error(v8::String::NewFromUtf8(isolate, msg.c_str()).ToLocalChecked()));
+            return v8::MaybeLocal<v8::Script>();
+        }
+
+        v8::Local<v8::String> source;
+        if (!v8::String::NewFromUtf8(isolate, m_code.data(), v8::NewStringType::kNormal, (int)m_code.size())
+                 .ToLocal(&source)) {
+            return v8::MaybeLocal<v8::Script>();
+        }
+
+        v8::ScriptOrigin origin(isolate, v8::String::NewFromUtf8(isolate, m_filename.c_str()).ToLocalChecked());
+
+        v8::Local<v8::Script> script;
+        if (!v8::ScriptCompiler::Compile(context, m_source.get(), source, origin).ToLocal(&script)) {
+            return v8::MaybeLocal<v8::Script>();
+        }
+
+        // The parsed data and the source aren't needed anymore
+        m_source.reset();
+        m_task.reset();
+        std::string().swap(m_code);
+
+        return scope.Escape(script);
+    }
+
+    const String& ScriptStream::getFilename() const {
+        return m_filename;
+    }
+
+    void ScriptStream::onParsed() {
+        if (m_onParsed) {
+            m_onParsed(this);
+        }
+    }
+}
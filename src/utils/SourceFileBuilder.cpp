@@ -1,12 +1,15 @@
 #include <tspp/utils/SourceFileBuilder.h>
-#include <utils/Array.hpp>
 
 #include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
 
 namespace tspp {
-    SourceFileBuilder::SourceFileBuilder() {
+    SourceFileBuilder::SourceFileBuilder(u32 reserve) {
         m_indentLevel = 0;
         m_needsIndent = true;
+        m_content.reserve(reserve);
+        m_formatBuffer.resize(256);
     }
 
     SourceFileBuilder::~SourceFileBuilder() {
@@ -22,75 +25,74 @@ namespace tspp {
     }
 
     void SourceFileBuilder::operator+=(const String& str) {
-        Array<String> lines;
-        String cur;
-        bool hadNewLine = false;
-        for (u32 i = 0;i < str.size();i++) {
-            if (str[i] == '\n') {
-                lines.push(cur);
-                cur = "";
-                hadNewLine = true;
-            } else {
-                cur += str[i];
-            }
-        }
-
-        if (cur.size() > 0) {
-            lines.push(cur);
-        }
-
-        for (u32 i = 0;i < lines.size();i++) {
-            if (i > 0) newline();
-            ensureIndent();
-            m_content += lines[i];
-        }
-
-        if (lines.size() == 1 && hadNewLine) {
-            newline();
-        }
+        append(str.c_str(), str.size());
     }
 
     void SourceFileBuilder::newline() {
-        m_content += "\n";
+        m_content.push_back('\n');
         m_needsIndent = true;
     }
 
     void SourceFileBuilder::line(const String& str) {
-        (*this) += str;
+        append(str.c_str(), str.size());
         newline();
     }
 
     void SourceFileBuilder::line(const char* fmt, ...) {
         va_list args;
         va_start(args, fmt);
-        char buffer[4096];
-        vsnprintf(buffer, sizeof(buffer), fmt, args);
+
+        va_list argsCopy;
+        va_copy(argsCopy, args);
+        int length = vsnprintf(m_formatBuffer.data(), m_formatBuffer.size(), fmt, argsCopy);
+        va_end(argsCopy);
+
+        if (length >= 0 && size_t(length) >= m_formatBuffer.size()) {
+            m_formatBuffer.resize(size_t(length) + 1);
+            vsnprintf(m_formatBuffer.data(), m_formatBuffer.size(), fmt, args);
+        }
+
         va_end(args);
 
-        (*this) += buffer;
+        if (length > 0) {
+            append(m_formatBuffer.data(), size_t(length));
+        }
+
         newline();
     }
 
-    void SourceFileBuilder::ensureIndent() {
-        if (!m_needsIndent) return;
+    void SourceFileBuilder::append(const char* str, size_t length) {
+        // Every line within str is indented to the current level
+        const char* end = str + length;
+        while (str < end) {
+            const char* lineEnd = (const char*)memchr(str, '\n', end - str);
+
+            ensureIndent();
+            m_content.append(str, (lineEnd ? lineEnd : end) - str);
+
+            if (!lineEnd) break;
 
-        for (u32 i = 0;i < m_indentLevel;i++) {
-            m_content += "    ";
+            newline();
+            str = lineEnd + 1;
         }
+    }
+
+    void SourceFileBuilder::ensureIndent() {
+        if (!m_needsIndent) return;
 
+        m_content.append(m_indentLevel * 4, ' ');
         m_needsIndent = false;
     }
 
-    const String& SourceFileBuilder::getContent() const {
+    String SourceFileBuilder::getContent() const {
         return m_content;
     }
 
     bool SourceFileBuilder::writeToFile(const String& path) const {
         FILE* file = fopen(path.c_str(), "w");
         if (!file) return false;
-        fwrite(m_content.c_str(), 1, m_content.size(), file);
+        fwrite(m_content.data(), 1, m_content.size(), file);
         fclose(file);
         return true;
     }
 }
-
@@ -0,0 +1,28 @@
+#include <tspp/utils/StackTrace.h>
+
+#include <v8.h>
+
+namespace tspp {
+    String formatCurrentStack(v8::Isolate* isolate, u32 maxFrames) {
+        v8::HandleScope scope(isolate);
+
+        String stack;
+        v8::Local<v8::StackTrace> trace = v8::StackTrace::CurrentStackTrace(isolate, i32(maxFrames));
+        for (i32 i = 0; i < trace->GetFrameCount(); i++) {
+            v8::Local<v8::StackFrame> frame = trace->GetFrame(isolate, i);
+            v8::String::Utf8Value functionName(isolate, frame->GetFunctionName());
+            v8::String::Utf8Value scriptName(isolate, frame->GetScriptName());
+
+            stack += String::Format(
+                         "\n    at %s (%s:%d:%d)",
+                         *functionName && (*functionName)[0] ? *functionName : "<anonymous>",
+                         *scriptName ? *scriptName : "<unknown>",
+                         frame->GetLineNumber(),
+                         frame->GetColumn()
+            )
+                         .c_str();
+        }
+
+        return stack;
+    }
+}
@@ -0,0 +1,206 @@
+#include <tspp/utils/StructuredClone.h>
+#include <utils/Array.hpp>
+
+#include <stdlib.h>
+
+#include <v8-value-serializer.h>
+
+namespace tspp {
+    class SerializedValue::SerializerDelegate : public v8::ValueSerializer::Delegate {
+        public:
+            SerializerDelegate(v8::Isolate* isolate, SerializedValue* value) : m_isolate(isolate), m_value(value) {}
+
+            void ThrowDataCloneError(v8::Local<v8::String> message) override {
+                m_isolate->ThrowException(v8::Exception::Error(message));
+            }
+
+            v8::Maybe<u32> GetSharedArrayBufferId(
+                v8::Isolate* isolate, v8::Local<v8::SharedArrayBuffer> sharedArrayBuffer
+            ) override {
+                std::shared_ptr<v8::BackingStore> store = sharedArrayBuffer->GetBackingStore();
+
+                // The same buffer may be referenced more than once within a value
+                for (u32 i = 0; i < m_value->m_shared.size(); i++) {
+                    if (m_value->m_shared[i] == store) {
+                        return v8::Just(i);
+                    }
+                }
+
+                m_value->m_shared.push_back(store);
+                return v8::Just(u32(m_value->m_shared.size() - 1));
+            }
+
+        private:
+            v8::Isolate* m_isolate;
+            SerializedValue* m_value;
+    };
+
+    class SerializedValue::DeserializerDelegate : public v8::ValueDeserializer::Delegate {
+        public:
+            DeserializerDelegate(SerializedValue* value) : m_value(value) {}
+
+            v8::MaybeLocal<v8::SharedArrayBuffer> GetSharedArrayBufferFromId(
+                v8::Isolate* isolate, u32 cloneId
+            ) override {
+                if (cloneId >= m_value->m_shared.size()) {
+                    isolate->ThrowException(v8::Exception::Error(
+                        v8::String::NewFromUtf8(isolate, "Invalid SharedArrayBuffer id").ToLocalChecked()
+                    ));
+                    return v8::MaybeLocal<v8::SharedArrayBuffer>();
+                }
+
+                return v8::SharedArrayBuffer::New(isolate, m_value->m_shared[cloneId]);
+            }
+
+        private:
+            SerializedValue* m_value;
+    };
+
+    SerializedValue::SerializedValue() {
+        m_data = nullptr;
+        m_size = 0;
+    }
+
+    SerializedValue::SerializedValue(SerializedValue&& rhs) {
+        m_data        = rhs.m_data;
+        m_size        = rhs.m_size;
+        rhs.m_data    = nullptr;
+        rhs.m_size    = 0;
+        m_transferred = std::move(rhs.m_transferred);
+        m_shared      = std::move(rhs.m_shared);
+    }
+
+    SerializedValue::~SerializedValue() {
+        release();
+    }
+
+    SerializedValue& SerializedValue::operator=(SerializedValue&& rhs) {
+        if (this == &rhs) {
+            return *this;
+        }
+
+        release();
+
+        m_data        = rhs.m_data;
+        m_size        = rhs.m_size;
+        rhs.m_data    = nullptr;
+        rhs.m_size    = 0;
+        m_transferred = std::move(rhs.m_transferred);
+        m_shared      = std::move(rhs.m_shared);
+
+        return *this;
+    }
+
+    bool SerializedValue::serialize(
+        v8::Local<v8::Context> context, v8::Local<v8::Value> value, v8::Local<v8::Value> transferList
+    ) {
+        v8::Isolate* isolate = context->GetIsolate();
+        release();
+
+        Array<v8::Local<v8::ArrayBuffer>> transferred;
+        if (!transferList.IsEmpty() && !transferList->IsNullOrUndefined()) {
+            if (!transferList->IsArray()) {
+                isolate->ThrowException(v8::Exception::TypeError(
+                    v8::String::NewFromUtf8(isolate, "Transfer list must be an array").ToLocalChecked()
+                ));
+                return false;
+            }
+
+            v8::Local<v8::Array> list = transferList.As<v8::Array>();
+            for (u32 i = 0; i < list->Length(); i++) {
+                v8::Local<v8::Value> item;
+                if (!list->Get(context, i).ToLocal(&item)) {
+                    return false;
+                }
+
+                if (!item->IsArrayBuffer() || !item.As<v8::ArrayBuffer>()->IsDetachable()) {
+                    isolate->ThrowException(v8::Exception::TypeError(
+                        v8::String::NewFromUtf8(isolate, "Transfer list may only contain detachable ArrayBuffers")
+                            .ToLocalChecked()
+                    ));
+                    return false;
+                }
+
+                v8::Local<v8::ArrayBuffer> buffer = item.As<v8::ArrayBuffer>();
+                for (const v8::Local<v8::ArrayBuffer>& existing : transferred) {
+                    if (existing == buffer) {
+                        isolate->ThrowException(v8::Exception::Error(
+                            v8::String::NewFromUtf8(isolate, "ArrayBuffer appears more than once in transfer list")
+                                .ToLocalChecked()
+                        ));
+                        return false;
+                    }
+                }
+
+                transferred.push(buffer);
+            }
+        }
+
+        SerializerDelegate delegate(isolate, this);
+        v8::ValueSerializer serializer(isolate, &delegate);
+
+        for (u32 i = 0; i < transferred.size(); i++) {
+            serializer.TransferArrayBuffer(i, transferred[i]);
+        }
+
+        serializer.WriteHeader();
+        if (serializer.WriteValue(context, value).IsNothing()) {
+            m_shared.clear();
+            return false;
+        }
+
+        std::pair<u8*, size_t> data = serializer.Release();
+        m_data                      = data.first;
+        m_size                      = data.second;
+
+        // The contents now belong to the serialized value, the sender can no longer access them
+        for (v8::Local<v8::ArrayBuffer>& buffer : transferred) {
+            m_transferred.push_back(buffer->GetBackingStore());
+            buffer->Detach(v8::Local<v8::Value>()).Check();
+        }
+
+        return true;
+    }
+
+    v8::MaybeLocal<v8::Value> SerializedValue::deserialize(v8::Local<v8::Context> context) {
+        v8::Isolate* isolate = context->GetIsolate();
+        v8::EscapableHandleScope scope(isolate);
+
+        DeserializerDelegate delegate(this);
+        v8::ValueDeserializer deserializer(isolate, m_data, m_size, &delegate);
+
+        for (u32 i = 0; i < m_transferred.size(); i++) {
+            deserializer.TransferArrayBuffer(i, v8::ArrayBuffer::New(isolate, m_transferred[i]));
+        }
+
+        m_transferred.clear();
+
+        bool didReadHeader = false;
+        if (!deserializer.ReadHeader(context).To(&didReadHeader) || !didReadHeader) {
+            return v8::MaybeLocal<v8::Value>();
+        }
+
+        v8::Local<v8::Value> result;
+        if (!deserializer.ReadValue(context).ToLocal(&result)) {
+            return v8::MaybeLocal<v8::Value>();
+        }
+
+        return scope.Escape(result);
+    }
+
+    size_t SerializedValue::getSize() const {
+        return m_size;
+    }
+
+    void SerializedValue::release() {
+        if (m_data) {
+            // Allocated by the serializer delegate's default ReallocateBufferMemory
+            ::free(m_data);
+        }
+
+        m_data = nullptr;
+        m_size = 0;
+        m_transferred.clear();
+        m_shared.clear();
+    }
+}
@@ -1,13 +1,43 @@
 #define TSPP_INCLUDING_WINDOWS_H
 
+#include <tspp/utils/EventLoopMonitor.h>
 #include <tspp/utils/Thread.h>
+#include <tspp/utils/Trace.h>
 #include <utils/Array.hpp>
 
+#include <chrono>
+#include <string.h>
+
 #ifdef _WIN32
     #include <Windows.h>
+#else
+    #include <pthread.h>
+    #include <time.h>
 #endif
 
 namespace tspp {
+    static u64 nowNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch()
+        )
+            .count();
+    }
+
+    // Statistics counters only have a single writer, so they don't need atomic read-modify-writes
+    static void addRelaxed(std::atomic<u64>& counter, u64 value) {
+        counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+    static void maxRelaxed(std::atomic<u64>& counter, u64 value) {
+        if (value > counter.load(std::memory_order_relaxed)) {
+            counter.store(value, std::memory_order_relaxed);
+        }
+    }
+
+    static f64 toMs(u64 ns) {
+        return f64(ns) / 1000000.0;
+    }
+
     //
     // Thread
     //
@@ -30,7 +60,7 @@ namespace tspp {
     }
 
     void Thread::reset(const std::function<void()>& entry) {
-        if (m_thread.joinable() && isRunning()) m_thread.join();
+        if (m_thread.joinable()) m_thread.join();
         m_thread = std::thread([this, entry](){
             this->m_isRunningMutex.lock();
             this->m_isRunning = true;
@@ -81,7 +111,9 @@ namespace tspp {
     }
 
     void Thread::waitForExit() {
-        if (!m_thread.joinable() || !isRunning()) return;
+        // m_isRunning isn't set until the thread starts running its entry, so it can't be used to
+        // decide whether there's anything to wait for
+        if (!m_thread.joinable() || m_thread.get_id() == std::this_thread::get_id()) return;
         m_thread.join();
     }
 
@@ -112,16 +144,84 @@ namespace tspp {
         #endif
     }
 
+    u64 Thread::OpenCpuClock() {
+        #ifdef _WIN32
+        // GetCurrentThread returns a pseudo handle that only refers to the calling thread
+        HANDLE thread = nullptr;
+        if (!DuplicateHandle(
+            GetCurrentProcess(),
+            GetCurrentThread(),
+            GetCurrentProcess(),
+            &thread,
+            THREAD_QUERY_LIMITED_INFORMATION,
+            FALSE,
+            0
+        )) {
+            return 0;
+        }
+
+        return (u64)thread;
+        #else
+        clockid_t clock;
+        if (pthread_getcpuclockid(pthread_self(), &clock) != 0) {
+            return 0;
+        }
+
+        // Store the clock id offset by one so that 0 is never a valid clock
+        return u64(clock) + 1;
+        #endif
+    }
+
+    bool Thread::ReadCpuClock(u64 clock, u64& outTimeUs) {
+        if (!clock) {
+            return false;
+        }
+
+        #ifdef _WIN32
+        FILETIME creationTime, exitTime, kernelTime, userTime;
+        if (!GetThreadTimes((HANDLE)clock, &creationTime, &exitTime, &kernelTime, &userTime)) {
+            return false;
+        }
+
+        u64 kernel = (u64(kernelTime.dwHighDateTime) << 32) | kernelTime.dwLowDateTime;
+        u64 user   = (u64(userTime.dwHighDateTime) << 32) | userTime.dwLowDateTime;
+
+        // 100 nanosecond intervals
+        outTimeUs = (kernel + user) / 10;
+        return true;
+        #else
+        timespec ts;
+        if (clock_gettime(clockid_t(clock - 1), &ts) != 0) {
+            return false;
+        }
+
+        outTimeUs = u64(ts.tv_sec) * 1000000 + u64(ts.tv_nsec) / 1000;
+        return true;
+        #endif
+    }
+
+    void Thread::CloseCpuClock(u64 clock) {
+        #ifdef _WIN32
+        if (clock) {
+            CloseHandle((HANDLE)clock);
+        }
+        #endif
+    }
+
 
 
     //
     // IJob
     //
     
-    IJob::IJob() {}
+    IJob::IJob() : m_submittedAt(0), m_completedAt(0) {}
 
     IJob::~IJob() {}
 
+    const char* IJob::getName() const {
+        return "job";
+    }
+
 
 
     //
@@ -129,6 +229,20 @@ namespace tspp {
     //
 
     Worker::Worker() : m_id(0), m_doStop(false), m_thread(), m_pool(nullptr) {
+        m_jobCount      = 0;
+        m_busyNs        = 0;
+        m_idleNs        = 0;
+        m_idleStartedAt = 0;
+        m_totalWaitNs   = 0;
+        m_maxWaitNs     = 0;
+        m_jobClassCount = 0;
+
+        for (u32 i = 0; i <= MaxJobClasses; i++) {
+            m_jobClasses[i].name       = i < MaxJobClasses ? nullptr : OtherJobClassName;
+            m_jobClasses[i].count      = 0;
+            m_jobClasses[i].totalRunNs = 0;
+            m_jobClasses[i].maxRunNs   = 0;
+        }
     }
 
     Worker::~Worker() {
@@ -139,54 +253,124 @@ namespace tspp {
         m_thread.waitForExit();
     }
 
-    void Worker::start(worker_id id, u32 cpuIdx) {
+    void Worker::start(worker_id id, u32 cpuIdx, bool pinToCpu) {
         m_id = id;
-        m_thread.reset([this, cpuIdx]{
-            m_thread.setAffinity(cpuIdx);
+        m_thread.reset([this, cpuIdx, pinToCpu]{
+            if (pinToCpu) m_thread.setAffinity(cpuIdx);
+            Trace::SetThreadName(String::Format("ThreadPool worker %u", m_id));
             run();
         });
     }
 
     void Worker::run() {
         while (!m_doStop) {
+            u64 idleStartedAt = nowNs();
+            m_idleStartedAt.store(idleStartedAt, std::memory_order_relaxed);
             m_pool->waitForWork(this);
 
             IJob* j = m_pool->getWork();
+
+            // The stretch stops being in progress before it's added to the total, so getStats never
+            // counts it twice
+            u64 startedAt = nowNs();
+            m_idleStartedAt.store(0, std::memory_order_relaxed);
+            u64 idleNs = m_idleNs.load(std::memory_order_relaxed) + startedAt - idleStartedAt;
+            m_idleNs.store(idleNs, std::memory_order_release);
+
             if (j) {
-                j->run();
+                {
+                    Trace::Scope trace("tspp", "ThreadPool job");
+                    j->run();
+                }
+
+                u64 completedAt = nowNs();
+                recordJob(j, startedAt, completedAt);
+
+                j->m_completedAt = completedAt;
                 m_pool->addCompleted(j);
             }
         }
     }
 
+    void Worker::recordJob(IJob* job, u64 startedAt, u64 completedAt) {
+        u64 waitNs = startedAt > job->m_submittedAt ? startedAt - job->m_submittedAt : 0;
+        u64 runNs  = completedAt - startedAt;
+
+        addRelaxed(m_jobCount, 1);
+        addRelaxed(m_busyNs, runNs);
+        addRelaxed(m_totalWaitNs, waitNs);
+        maxRelaxed(m_maxWaitNs, waitNs);
+
+        const char* name = job->getName();
+        u32 count        = m_jobClassCount.load(std::memory_order_relaxed);
+
+        JobClassCounters* counters = nullptr;
+        for (u32 i = 0; i < count; i++) {
+            if (m_jobClasses[i].name == name || strcmp(m_jobClasses[i].name, name) == 0) {
+                counters = &m_jobClasses[i];
+                break;
+            }
+        }
+
+        if (!counters) {
+            if (count < MaxJobClasses) {
+                counters       = &m_jobClasses[count];
+                counters->name = name;
+
+                // Publishes the name to readers
+                m_jobClassCount.store(count + 1, std::memory_order_release);
+            } else {
+                counters = &m_jobClasses[MaxJobClasses];
+            }
+        }
+
+        addRelaxed(counters->count, 1);
+        addRelaxed(counters->totalRunNs, runNs);
+        maxRelaxed(counters->maxRunNs, runNs);
+    }
+
 
 
     //
     // ThreadPool
     //
     ThreadPool::ThreadPool() {
-        m_workers = nullptr;
+        m_workers                = nullptr;
+        m_workerCount            = 0;
+        m_peakPendingCount       = 0;
+        m_completedCount         = 0;
+        m_submittedCount         = 0;
+        m_completionDelayCount   = 0;
+        m_totalCompletionDelayNs = 0;
+        m_maxCompletionDelayNs   = 0;
     }
 
     ThreadPool::~ThreadPool() {
         shutdown();
     }
 
-    void ThreadPool::start() {
+    void ThreadPool::start(u32 workerCount) {
         if (m_workers) return;
 
-        u32 wc = Thread::MaxHardwareThreads();
+        u32 hardwareThreads = Thread::MaxHardwareThreads();
+        u32 wc = workerCount > 0 ? workerCount : hardwareThreads;
+        if (wc == 0) wc = 1;
+
+        // Smaller pools share the CPUs with other pools, pinning them would stack them all on the first few
+        bool pinToCpu = wc == hardwareThreads;
+
         m_workers = new Worker[wc];
+        m_workerCount = wc;
         for (u32 i = 0;i < wc;i++) {
             m_workers[i].m_pool = this;
-            m_workers[i].start(i + 1, i);
+            m_workers[i].start(i + 1, i, pinToCpu);
         }
     }
 
     void ThreadPool::shutdown() {
         if (!m_workers) return;
 
-        u32 wc = Thread::MaxHardwareThreads();
+        u32 wc = m_workerCount;
         for (u32 i = 0;i < wc;i++) {
             m_workers[i].m_doStop = true;
         }
@@ -200,31 +384,50 @@ namespace tspp {
 
         delete [] m_workers;
         m_workers = nullptr;
+        m_workerCount = 0;
     }
 
     void ThreadPool::submitJob(IJob* job) {
+        job->m_submittedAt = nowNs();
+
         m_jobMutex.lock();
         m_pending.push(job);
+        if (m_pending.size() > m_peakPendingCount) m_peakPendingCount = m_pending.size();
         m_jobMutex.unlock();
+        m_submittedCount++;
         m_workCondition.notify_all();
     }
     
     void ThreadPool::submitJobs(const Array<IJob*>& jobs) {
+        u64 submittedAt = nowNs();
+        for (IJob* job : jobs) {
+            job->m_submittedAt = submittedAt;
+        }
+
         m_jobMutex.lock();
         m_pending.append(jobs);
+        if (m_pending.size() > m_peakPendingCount) m_peakPendingCount = m_pending.size();
         m_jobMutex.unlock();
+        m_submittedCount += jobs.size();
         m_workCondition.notify_all();
     }
 
-    bool ThreadPool::processCompleted() {
+    bool ThreadPool::processCompleted(EventLoopMonitor* eventLoopMonitor) {
         m_completedMutex.lock();
         bool didHaveWork = m_completed.size() > 0;
 
         for (IJob* j : m_completed) {
+            u64 delayNs = nowNs() - j->m_completedAt;
+            addRelaxed(m_completionDelayCount, 1);
+            addRelaxed(m_totalCompletionDelayNs, delayNs);
+            maxRelaxed(m_maxCompletionDelayNs, delayNs);
+
+            EventLoopMonitor::Scope monitorScope(eventLoopMonitor, "job completion");
             j->afterComplete();
             delete j;
         }
 
+        m_completedCount -= m_completed.size();
         m_completed.clear();
         m_completedMutex.unlock();
 
@@ -256,9 +459,121 @@ namespace tspp {
         m_workCondition.wait(l, [this, w]{ return w->m_doStop || m_pending.size() > 0; });
     }
 
+    u32 ThreadPool::getPendingJobCount() {
+        std::lock_guard<std::mutex> lock(m_jobMutex);
+        return m_pending.size();
+    }
+
+    ThreadPoolStats ThreadPool::getStats() {
+        ThreadPoolStats stats;
+        stats.workerCount       = m_workerCount;
+        stats.pendingJobs       = getPendingJobCount();
+        stats.peakPendingJobs   = m_peakPendingCount;
+        stats.completedJobs     = m_completedCount;
+        stats.submittedJobCount = m_submittedCount;
+        stats.finishedJobCount  = 0;
+
+        u64 totalWaitNs = 0;
+        u64 maxWaitNs   = 0;
+        u64 totalBusyNs = 0;
+        u64 totalIdleNs = 0;
+        u64 maxRunNs    = 0;
+
+        for (u32 i = 0; i < m_workerCount; i++) {
+            Worker& w = m_workers[i];
+
+            // Includes the stretch that the worker is waiting through right now, so that a pool that
+            // has gone quiet doesn't keep reporting the utilization it had when it was last busy
+            u64 idleNs        = w.m_idleNs.load(std::memory_order_acquire);
+            u64 idleStartedAt = w.m_idleStartedAt.load(std::memory_order_relaxed);
+            if (idleStartedAt > 0) {
+                u64 now = nowNs();
+                if (now > idleStartedAt) idleNs += now - idleStartedAt;
+            }
+
+            ThreadPoolWorkerStats worker;
+            worker.id          = w.m_id;
+            worker.jobCount    = w.m_jobCount.load(std::memory_order_relaxed);
+            worker.busyMs      = toMs(w.m_busyNs.load(std::memory_order_relaxed));
+            worker.idleMs      = toMs(idleNs);
+            worker.utilization = 0.0;
+            if (worker.busyMs + worker.idleMs > 0.0) {
+                worker.utilization = worker.busyMs / (worker.busyMs + worker.idleMs);
+            }
+            stats.workers.push(worker);
+
+            stats.finishedJobCount += worker.jobCount;
+            totalWaitNs += w.m_totalWaitNs.load(std::memory_order_relaxed);
+            totalBusyNs += w.m_busyNs.load(std::memory_order_relaxed);
+            totalIdleNs += idleNs;
+
+            u64 workerMaxWaitNs = w.m_maxWaitNs.load(std::memory_order_relaxed);
+            if (workerMaxWaitNs > maxWaitNs) maxWaitNs = workerMaxWaitNs;
+
+            // Jobs with the same name are merged across workers. The slot after the named ones holds
+            // the jobs whose names didn't fit
+            u32 classCount = w.m_jobClassCount.load(std::memory_order_acquire);
+            for (u32 c = 0; c <= classCount; c++) {
+                Worker::JobClassCounters& counters =
+                    c < classCount ? w.m_jobClasses[c] : w.m_jobClasses[Worker::MaxJobClasses];
+
+                u64 count = counters.count.load(std::memory_order_relaxed);
+                if (count == 0) {
+                    continue;
+                }
+
+                ThreadPoolJobStats* job = nullptr;
+                for (ThreadPoolJobStats& existing : stats.jobs) {
+                    if (existing.name == counters.name) {
+                        job = &existing;
+                        break;
+                    }
+                }
+
+                if (!job) {
+                    ThreadPoolJobStats entry;
+                    entry.name       = counters.name;
+                    entry.count      = 0;
+                    entry.totalRunMs = 0.0;
+                    entry.maxRunMs   = 0.0;
+                    stats.jobs.push(entry);
+                    job = &stats.jobs.last();
+                }
+
+                u64 classMaxRunNs = counters.maxRunNs.load(std::memory_order_relaxed);
+                job->count += count;
+                job->totalRunMs += toMs(counters.totalRunNs.load(std::memory_order_relaxed));
+                if (toMs(classMaxRunNs) > job->maxRunMs) job->maxRunMs = toMs(classMaxRunNs);
+                if (classMaxRunNs > maxRunNs) maxRunNs = classMaxRunNs;
+            }
+        }
+
+        u64 finished      = stats.finishedJobCount;
+        u64 delayCount    = m_completionDelayCount.load(std::memory_order_relaxed);
+        u64 totalDelayNs  = m_totalCompletionDelayNs.load(std::memory_order_relaxed);
+        u64 totalWorkerNs = totalBusyNs + totalIdleNs;
+
+        stats.meanWaitMs            = finished > 0 ? toMs(totalWaitNs) / f64(finished) : 0.0;
+        stats.maxWaitMs             = toMs(maxWaitNs);
+        stats.meanRunMs             = finished > 0 ? toMs(totalBusyNs) / f64(finished) : 0.0;
+        stats.maxRunMs              = toMs(maxRunNs);
+        stats.meanCompletionDelayMs = delayCount > 0 ? toMs(totalDelayNs) / f64(delayCount) : 0.0;
+        stats.maxCompletionDelayMs  = toMs(m_maxCompletionDelayNs.load(std::memory_order_relaxed));
+        stats.utilization           = totalWorkerNs > 0 ? f64(totalBusyNs) / f64(totalWorkerNs) : 0.0;
+
+        return stats;
+    }
+
+    void ThreadPool::setCompletionCallback(const std::function<void()>& callback) {
+        m_onCompleted = callback;
+    }
+
     void ThreadPool::addCompleted(IJob* job) {
         m_completedMutex.lock();
         m_completed.push(job);
+        m_completedCount++;
         m_completedMutex.unlock();
+
+        if (m_onCompleted) m_onCompleted();
     }
 };
\ No newline at end of file
@@ -0,0 +1,502 @@
+#include <tspp/utils/Trace.h>
+#include <tspp/utils/ProfileOutput.h>
+#include <utils/Array.hpp>
+
+#include <atomic>
+#include <cstring>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+
+#include <v8-platform.h>
+
+namespace tspp {
+    // Number of events each thread keeps before overwriting the oldest ones
+    static constexpr u32 TraceBufferCapacity = 1 << 15;
+
+    // TRACE_EVENT_FLAG_COPY from V8's trace_event_common.h, the event's name isn't a literal
+    static constexpr u32 TraceEventFlagCopy = 1 << 0;
+
+    // kEnabledForRecording_CategoryGroupEnabledFlags from V8's trace_event.h
+    static constexpr u8 CategoryEnabledForRecording = 1 << 0;
+
+    struct TraceEvent {
+        public:
+            u64 timestampNs;
+            const char* category;
+            const char* name;
+            char phase;
+    };
+
+    struct ThreadTraceBuffer {
+        public:
+            u32 threadId;
+            String threadName;
+
+            // Buffers from before the most recent call to Trace::Start are stale, they're cleared
+            // by the owning thread the next time it records an event
+            u32 generation;
+
+            // Set when the owning thread exits, the buffer can be taken over by a new thread once
+            // its events are stale
+            bool isRetired;
+            std::atomic<u64> eventCount;
+            TraceEvent events[TraceBufferCapacity];
+    };
+
+    struct CategoryGroup {
+        public:
+            // Must be the first member, V8 passes a pointer to it back when recording events
+            u8 enabledFlags;
+            String name;
+    };
+
+    static std::atomic<bool> s_isEnabled = false;
+    static std::atomic<u32> s_generation = 0;
+
+    /*
+     * The calling thread's name and buffer. The buffer is only allocated once the thread records
+     * an event, so naming threads that are never traced costs nothing.
+     */
+    struct ThreadTraceState {
+        public:
+            ~ThreadTraceState();
+
+            ThreadTraceBuffer* buffer = nullptr;
+            String name;
+    };
+
+    // Buffers of every thread that has recorded an event. Never freed, the buffers of threads
+    // that have exited are reused by new threads instead.
+    static std::mutex s_mutex;
+    static Array<ThreadTraceBuffer*> s_threads;
+    static u32 s_nextThreadId = 1;
+    static thread_local ThreadTraceState t_thread;
+
+    // V8 caches pointers to the category flags, so categories are never freed either
+    static Array<CategoryGroup*> s_categories;
+    static Array<String> s_v8Categories;
+    static Array<v8::TracingController::TraceStateObserver*> s_observers;
+    static std::unordered_set<std::string> s_copiedNames;
+
+    static u64 getTimeNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch()
+        )
+            .count();
+    }
+
+    ThreadTraceState::~ThreadTraceState() {
+        if (!buffer) {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(s_mutex);
+        buffer->isRetired = true;
+    }
+
+    static ThreadTraceBuffer* getBuffer() {
+        if (t_thread.buffer) {
+            return t_thread.buffer;
+        }
+
+        std::lock_guard<std::mutex> lock(s_mutex);
+        u32 generation = s_generation.load(std::memory_order_relaxed);
+
+        // Take over the buffer of an exited thread if it only holds events from an earlier trace,
+        // the events of threads that exited during the current trace are kept
+        ThreadTraceBuffer* buffer = nullptr;
+        for (ThreadTraceBuffer* retired : s_threads) {
+            if (retired->isRetired && retired->generation != generation) {
+                buffer = retired;
+                break;
+            }
+        }
+
+        if (!buffer) {
+            buffer = new ThreadTraceBuffer();
+            s_threads.push(buffer);
+        }
+
+        buffer->threadId   = s_nextThreadId++;
+        buffer->threadName = t_thread.name;
+        buffer->generation = generation;
+        buffer->isRetired  = false;
+        buffer->eventCount.store(0, std::memory_order_relaxed);
+
+        t_thread.buffer = buffer;
+        return buffer;
+    }
+
+    static void record(char phase, const char* category, const char* name, u64 timestampNs) {
+        ThreadTraceBuffer* buffer = getBuffer();
+
+        u32 generation = s_generation.load(std::memory_order_acquire);
+        if (buffer->generation != generation) {
+            buffer->eventCount.store(0, std::memory_order_relaxed);
+            buffer->generation = generation;
+        }
+
+        u64 count         = buffer->eventCount.load(std::memory_order_relaxed);
+        TraceEvent& event = buffer->events[count % TraceBufferCapacity];
+        event.timestampNs = timestampNs;
+        event.category    = category;
+        event.name        = name;
+        event.phase       = phase;
+
+        // Publishes the event to Trace::ToJSON
+        buffer->eventCount.store(count + 1, std::memory_order_release);
+    }
+
+    static bool isV8CategoryEnabled(const String& group) {
+        // A group may contain several comma separated categories, it's enabled if any of them are
+        const char* category = group.c_str();
+        while (*category) {
+            const char* end = category;
+            while (*end && *end != ',') {
+                end++;
+            }
+
+            for (const String& prefix : s_v8Categories) {
+                if (prefix.size() <= size_t(end - category) && strncmp(category, prefix.c_str(), prefix.size()) == 0) {
+                    return true;
+                }
+            }
+
+            category = *end ? end + 1 : end;
+        }
+
+        return false;
+    }
+
+    static void updateCategories() {
+        bool isEnabled = s_isEnabled.load(std::memory_order_relaxed);
+
+        for (CategoryGroup* group : s_categories) {
+            group->enabledFlags = isEnabled && isV8CategoryEnabled(group->name) ? CategoryEnabledForRecording : 0;
+        }
+    }
+
+    static void buildJSON(std::string& out) {
+        std::lock_guard<std::mutex> lock(s_mutex);
+
+        u32 generation = s_generation.load(std::memory_order_relaxed);
+        bool isFirst   = true;
+
+        out += "{\"traceEvents\":[";
+
+        for (ThreadTraceBuffer* buffer : s_threads) {
+            if (buffer->threadName.size() > 0) {
+                if (!isFirst) {
+                    out += ",";
+                }
+
+                isFirst = false;
+                out += String::Format(
+                           "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"",
+                           buffer->threadId
+                )
+                           .c_str();
+                appendJSONEscaped(out, buffer->threadName.c_str());
+                out += "\"}}";
+            }
+
+            if (buffer->generation != generation) {
+                continue;
+            }
+
+            u64 count = buffer->eventCount.load(std::memory_order_acquire);
+            u64 first = count > TraceBufferCapacity ? count - TraceBufferCapacity : 0;
+
+            for (u64 i = first; i < count; i++) {
+                const TraceEvent& event = buffer->events[i % TraceBufferCapacity];
+
+                if (!isFirst) {
+                    out += ",";
+                }
+
+                isFirst = false;
+                out += "{\"name\":\"";
+                appendJSONEscaped(out, event.name);
+                out += "\",\"cat\":\"";
+                appendJSONEscaped(out, event.category);
+                out += String::Format(
+                           "\",\"ph\":\"%c\",\"ts\":%llu.%03llu,\"pid\":1,\"tid\":%u%s}",
+                           event.phase,
+                           (unsigned long long)(event.timestampNs / 1000),
+                           (unsigned long long)(event.timestampNs % 1000),
+                           buffer->threadId,
+                           event.phase == 'i' ? ",\"s\":\"t\"" : ""
+                )
+                           .c_str();
+            }
+        }
+
+        out += "],\"displayTimeUnit\":\"ms\"}";
+    }
+
+    /**
+     * @brief Tracing controller that the V8 platform reports its trace events to
+     *
+     * Only duration and instant events are recorded, V8's async, flow and counter events are
+     * dropped since they can't be represented by the fixed event record.
+     */
+    class TraceController : public v8::TracingController {
+        public:
+            const uint8_t* GetCategoryGroupEnabled(const char* name) override {
+                std::lock_guard<std::mutex> lock(s_mutex);
+
+                for (CategoryGroup* group : s_categories) {
+                    if (strcmp(group->name.c_str(), name) == 0) {
+                        return &group->enabledFlags;
+                    }
+                }
+
+                CategoryGroup* group = new CategoryGroup();
+                group->name          = name;
+                group->enabledFlags  = 0;
+                if (s_isEnabled.load(std::memory_order_relaxed) && isV8CategoryEnabled(group->name)) {
+                    group->enabledFlags = CategoryEnabledForRecording;
+                }
+
+                s_categories.push(group);
+                return &group->enabledFlags;
+            }
+
+            uint64_t AddTraceEvent(
+                char phase,
+                const uint8_t* categoryEnabledFlag,
+                const char* name,
+                const char* scope,
+                uint64_t id,
+                uint64_t bindId,
+                int32_t numArgs,
+                const char** argNames,
+                const uint8_t* argTypes,
+                const uint64_t* argValues,
+                std::unique_ptr<v8::ConvertableToTraceFormat>* argConvertables,
+                unsigned int flags
+            ) override {
+                addEvent(phase, categoryEnabledFlag, name, flags, getTimeNs());
+                return 0;
+            }
+
+            uint64_t AddTraceEventWithTimestamp(
+                char phase,
+                const uint8_t* categoryEnabledFlag,
+                const char* name,
+                const char* scope,
+                uint64_t id,
+                uint64_t bindId,
+                int32_t numArgs,
+                const char** argNames,
+                const uint8_t* argTypes,
+                const uint64_t* argValues,
+                std::unique_ptr<v8::ConvertableToTraceFormat>* argConvertables,
+                unsigned int flags,
+                int64_t timestamp
+            ) override {
+                // V8's timestamps are in microseconds from the same monotonic clock
+                addEvent(phase, categoryEnabledFlag, name, flags, u64(timestamp) * 1000);
+                return 0;
+            }
+
+            void UpdateTraceEventDuration(const uint8_t* categoryEnabledFlag, const char* name, uint64_t handle)
+                override {
+                // Complete events are recorded as a begin event, this ends them
+                if (!s_isEnabled.load(std::memory_order_relaxed)) {
+                    return;
+                }
+
+                const CategoryGroup* group = reinterpret_cast<const CategoryGroup*>(categoryEnabledFlag);
+                record('E', group->name.c_str(), "", getTimeNs());
+            }
+
+            void AddTraceStateObserver(TraceStateObserver* observer) override {
+                {
+                    std::lock_guard<std::mutex> lock(s_mutex);
+                    s_observers.push(observer);
+                }
+
+                if (s_isEnabled.load(std::memory_order_relaxed)) {
+                    observer->OnTraceEnabled();
+                }
+            }
+
+            void RemoveTraceStateObserver(TraceStateObserver* observer) override {
+                std::lock_guard<std::mutex> lock(s_mutex);
+
+                for (u32 i = 0; i < s_observers.size(); i++) {
+                    if (s_observers[i] == observer) {
+                        s_observers.remove(i);
+                        break;
+                    }
+                }
+            }
+
+        private:
+            void addEvent(char phase, const uint8_t* categoryEnabledFlag, const char* name, u32 flags, u64 timestampNs) {
+                if (!s_isEnabled.load(std::memory_order_relaxed)) {
+                    return;
+                }
+
+                const CategoryGroup* group = reinterpret_cast<const CategoryGroup*>(categoryEnabledFlag);
+
+                if (flags & TraceEventFlagCopy) {
+                    std::lock_guard<std::mutex> lock(s_mutex);
+                    name = s_copiedNames.insert(name).first->c_str();
+                }
+
+                switch (phase) {
+                    case 'X':
+                    case 'B': {
+                        record('B', group->name.c_str(), name, timestampNs);
+                        break;
+                    }
+                    case 'E': {
+                        record('E', group->name.c_str(), name, timestampNs);
+                        break;
+                    }
+                    case 'I':
+                    case 'i': {
+                        record('i', group->name.c_str(), name, timestampNs);
+                        break;
+                    }
+                    default: break;
+                }
+            }
+    };
+
+    //
+    // Trace::Scope
+    //
+
+    Trace::Scope::Scope(const char* category, const char* name) {
+        m_category = category;
+        m_name     = name;
+
+        if (IsEnabled()) {
+            record('B', category, name, getTimeNs());
+        }
+    }
+
+    Trace::Scope::~Scope() {
+        if (IsEnabled()) {
+            record('E', m_category, m_name, getTimeNs());
+        }
+    }
+
+    //
+    // Trace
+    //
+
+    void Trace::Start(const char* v8Categories) {
+        Array<v8::TracingController::TraceStateObserver*> observers;
+
+        {
+            std::lock_guard<std::mutex> lock(s_mutex);
+
+            s_v8Categories.clear();
+            if (v8Categories) {
+                const char* category = v8Categories;
+                while (*category) {
+                    const char* end = category;
+                    while (*end && *end != ',') {
+                        end++;
+                    }
+
+                    if (end != category) {
+                        String prefix;
+                        prefix.copy(category, u32(end - category));
+                        s_v8Categories.push(prefix);
+                    }
+
+                    category = *end ? end + 1 : end;
+                }
+            }
+
+            s_generation.fetch_add(1, std::memory_order_release);
+            s_isEnabled.store(true, std::memory_order_relaxed);
+            updateCategories();
+
+            observers = s_observers;
+        }
+
+        for (v8::TracingController::TraceStateObserver* observer : observers) {
+            observer->OnTraceEnabled();
+        }
+    }
+
+    void Trace::Stop() {
+        Array<v8::TracingController::TraceStateObserver*> observers;
+
+        {
+            std::lock_guard<std::mutex> lock(s_mutex);
+
+            if (!s_isEnabled.load(std::memory_order_relaxed)) {
+                return;
+            }
+
+            s_isEnabled.store(false, std::memory_order_relaxed);
+            updateCategories();
+
+            observers = s_observers;
+        }
+
+        for (v8::TracingController::TraceStateObserver* observer : observers) {
+            observer->OnTraceDisabled();
+        }
+    }
+
+    bool Trace::IsEnabled() {
+        return s_isEnabled.load(std::memory_order_relaxed);
+    }
+
+    void Trace::SetThreadName(const String& name) {
+        t_thread.name = name;
+
+        if (t_thread.buffer) {
+            std::lock_guard<std::mutex> lock(s_mutex);
+            t_thread.buffer->threadName = name;
+        }
+    }
+
+    void Trace::Begin(const char* category, const char* name) {
+        if (IsEnabled()) {
+            record('B', category, name, getTimeNs());
+        }
+    }
+
+    void Trace::End(const char* category, const char* name) {
+        if (IsEnabled()) {
+            record('E', category, name, getTimeNs());
+        }
+    }
+
+    void Trace::Instant(const char* category, const char* name) {
+        if (IsEnabled()) {
+            record('i', category, name, getTimeNs());
+        }
+    }
+
+    String Trace::ToJSON() {
+        std::string json;
+        buildJSON(json);
+
+        String result;
+        result.copy(json.c_str(), json.size());
+        return result;
+    }
+
+    bool Trace::Write(const String& path) {
+        std::string json;
+        buildJSON(json);
+
+        return writeOutputFile(path.c_str(), json);
+    }
+
+    std::unique_ptr<v8::TracingController> Trace::CreateTracingController() {
+        return std::make_unique<TraceController>();
+    }
+}
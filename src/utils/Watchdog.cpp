@@ -0,0 +1,202 @@
+#include <tspp/utils/Watchdog.h>
+#include <tspp/utils/StackTrace.h>
+#include <tspp/tspp.h>
+
+#include <chrono>
+
+#include <v8.h>
+
+namespace tspp {
+    //
+    // Watchdog::Scope
+    //
+
+    Watchdog::Scope::Scope(Watchdog* watchdog, const char* entryPoint) : m_watchdog(watchdog) {
+        if (m_watchdog) {
+            m_watchdog->enter(entryPoint);
+        }
+    }
+
+    Watchdog::Scope::~Scope() {
+        if (m_watchdog) {
+            m_watchdog->exit();
+        }
+    }
+
+    //
+    // Watchdog
+    //
+
+    Watchdog::Watchdog(const WatchdogConfig& config) : IsolateMonitor("Watchdog", config.checkIntervalMs) {
+        m_config           = config;
+        m_threadClock      = 0;
+        m_depth            = 0;
+        m_entryPoint       = nullptr;
+        m_enteredAt        = 0;
+        m_isTerminating    = false;
+        m_didInterrupt     = false;
+        m_terminatingAt    = 0;
+        m_terminationCount = 0;
+    }
+
+    Watchdog::~Watchdog() {
+        stop();
+    }
+
+    void Watchdog::start(v8::Isolate* isolate) {
+        if (m_isolate) {
+            return;
+        }
+
+        if (m_config.clock == WatchdogClock::ThreadCpu) {
+            m_threadClock = Thread::OpenCpuClock();
+            if (!m_threadClock) {
+                error("Thread CPU time is not available, falling back to wall clock time");
+            }
+        }
+
+        debug(
+            "Started with a budget of %u ms (%s)",
+            m_config.budgetMs,
+            m_config.clock == WatchdogClock::ThreadCpu ? "thread CPU time" : "wall clock time"
+        );
+
+        startMonitoring(isolate);
+    }
+
+    void Watchdog::stop() {
+        if (!m_isolate) {
+            return;
+        }
+
+        stopMonitoring();
+
+        Thread::CloseCpuClock(m_threadClock);
+        m_threadClock = 0;
+    }
+
+    u32 Watchdog::getTerminationCount() const {
+        return m_terminationCount;
+    }
+
+    Watchdog* Watchdog::Get(v8::Isolate* isolate) {
+        Runtime* runtime = Runtime::Get(isolate);
+        if (!runtime) {
+            return nullptr;
+        }
+
+        return runtime->getWatchdog();
+    }
+
+    void Watchdog::enter(const char* entryPoint) {
+        m_depth++;
+        if (m_depth > 1) {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_isActive      = true;
+        m_entryPoint    = entryPoint;
+        m_enteredAt     = getTimeUs();
+        m_isTerminating = false;
+        m_didInterrupt  = false;
+    }
+
+    void Watchdog::exit() {
+        m_depth--;
+        if (m_depth > 0) {
+            return;
+        }
+
+        bool didTerminate = false;
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            didTerminate    = m_isTerminating && m_didInterrupt;
+            m_isActive      = false;
+            m_isTerminating = false;
+            m_didInterrupt  = false;
+        }
+
+        // Nothing is executing anymore, so the isolate can be used again
+        if (didTerminate) {
+            m_isolate->CancelTerminateExecution();
+        }
+    }
+
+    void Watchdog::check() {
+        u64 budgetUs = u64(m_config.budgetMs) * 1000;
+        u64 now      = getTimeUs();
+
+        if (!m_isTerminating) {
+            if (now - m_enteredAt < budgetUs) {
+                return;
+            }
+
+            // The interrupt is handled on the isolate's thread, where the stack can be sampled
+            m_isTerminating = true;
+            m_terminatingAt = now;
+            requestInterrupt();
+            return;
+        }
+
+        // Interrupts are only handled while JavaScript is running. If the entry is still stuck
+        // in host code after another whole budget, terminate without a stack sample.
+        if (!m_didInterrupt && now - m_terminatingAt >= budgetUs) {
+            m_didInterrupt = true;
+            m_terminationCount++;
+
+            error(
+                "Script execution in '%s' exceeded its budget of %u ms and did not respond to an interrupt, "
+                "terminating",
+                m_entryPoint,
+                m_config.budgetMs
+            );
+
+            m_isolate->TerminateExecution();
+        }
+    }
+
+    u64 Watchdog::getTimeUs() const {
+        u64 timeUs = 0;
+        if (m_config.clock == WatchdogClock::ThreadCpu && Thread::ReadCpuClock(m_threadClock, timeUs)) {
+            return timeUs;
+        }
+
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch()
+        )
+            .count();
+    }
+
+    void Watchdog::interrupt(v8::Isolate* isolate) {
+        const char* entryPoint = nullptr;
+        u64 elapsedUs          = 0;
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            // The entry may have returned before the interrupt was handled
+            if (!m_isActive || !m_isTerminating || m_didInterrupt) {
+                return;
+            }
+
+            m_didInterrupt = true;
+            entryPoint     = m_entryPoint;
+            elapsedUs      = getTimeUs() - m_enteredAt;
+        }
+
+        String stack = formatCurrentStack(isolate, m_config.maxStackFrames);
+
+        m_terminationCount++;
+        error(
+            "Script execution in '%s' ran for %llu ms, exceeding its budget of %u ms. Terminating.%s",
+            entryPoint,
+            (unsigned long long)(elapsedUs / 1000),
+            m_config.budgetMs,
+            stack.c_str()
+        );
+
+        isolate->TerminateExecution();
+    }
+}
\ No newline at end of file
@@ -0,0 +1,241 @@
+#include "Common.h"
+#include <tspp/builtin/fs.h>
+#include <tspp/utils/GlobPattern.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+using namespace tspp;
+
+static Array<std::string> split(const char* path) {
+    Array<std::string> segments;
+    std::string segment;
+
+    for (const char* c = path; *c; c++) {
+        if (*c == '/') {
+            segments.push(segment);
+            segment.clear();
+        } else {
+            segment += *c;
+        }
+    }
+
+    segments.push(segment);
+    return segments;
+}
+
+static Array<String> strings(std::initializer_list<const char*> values) {
+    Array<String> result;
+    for (const char* value : values) {
+        result.push(String(value));
+    }
+
+    return result;
+}
+
+static bool matches(const char* pattern, const char* path) {
+    return GlobPattern(pattern).matches(split(path));
+}
+
+static bool matchesDirectory(const char* pattern, const char* path) {
+    return GlobPattern(pattern).matchesDirectory(split(path));
+}
+
+TEST_CASE("GlobPattern wildcards", "[GlobPattern]") {
+    SECTION("* matches within a single segment") {
+        REQUIRE(matches("*.ts", "a.ts"));
+        REQUIRE(matches("*.ts", ".ts"));
+        REQUIRE(matches("src/*.ts", "src/index.ts"));
+        REQUIRE_FALSE(matches("*.ts", "a.tsx"));
+        REQUIRE_FALSE(matches("*.ts", "src/a.ts"));
+        REQUIRE_FALSE(matches("src/*.ts", "src/nested/a.ts"));
+    }
+
+    SECTION("? matches exactly one character") {
+        REQUIRE(matches("a?.ts", "ab.ts"));
+        REQUIRE_FALSE(matches("a?.ts", "a.ts"));
+        REQUIRE_FALSE(matches("a?.ts", "abc.ts"));
+    }
+
+    SECTION("Leading ./ and backslashes are normalized") {
+        REQUIRE(matches("./src/*.ts", "src/a.ts"));
+        REQUIRE(matches("././src/*.ts", "src/a.ts"));
+        REQUIRE(matches("src\\*.ts", "src/a.ts"));
+    }
+}
+
+TEST_CASE("GlobPattern globstars", "[GlobPattern]") {
+    SECTION("** matches zero or more directories") {
+        REQUIRE(matches("src/**/*.ts", "src/a.ts"));
+        REQUIRE(matches("src/**/*.ts", "src/x/a.ts"));
+        REQUIRE(matches("src/**/*.ts", "src/x/y/z/a.ts"));
+        REQUIRE(matches("**/*.ts", "a.ts"));
+        REQUIRE_FALSE(matches("src/**/*.ts", "lib/a.ts"));
+        REQUIRE_FALSE(matches("src/**/*.ts", "src/x/a.js"));
+    }
+
+    SECTION("** in the middle of a pattern") {
+        REQUIRE(matches("src/**/test/*.ts", "src/test/a.ts"));
+        REQUIRE(matches("src/**/test/*.ts", "src/a/b/test/a.ts"));
+        REQUIRE_FALSE(matches("src/**/test/*.ts", "src/a/b/a.ts"));
+    }
+
+    SECTION("Consecutive globstars are equivalent to one") {
+        REQUIRE(matches("src/**/**/*.ts", "src/a.ts"));
+        REQUIRE(matches("src/**/**/*.ts", "src/x/y/a.ts"));
+    }
+
+    SECTION("Patterns without a wildcard or extension name a directory") {
+        REQUIRE(matches("src", "src/a.ts"));
+        REQUIRE(matches("src", "src/x/y/a.js"));
+        REQUIRE(matches("src/lib", "src/lib/a.ts"));
+        REQUIRE_FALSE(matches("src", "src"));
+        REQUIRE_FALSE(matches("src", "srcs/a.ts"));
+        REQUIRE_FALSE(matches("src", "lib/src/a.ts"));
+    }
+
+    SECTION("Patterns with an extension name a file") {
+        REQUIRE(matches("src/index.ts", "src/index.ts"));
+        REQUIRE_FALSE(matches("src/index.ts", "src/index.ts/a.ts"));
+    }
+}
+
+TEST_CASE("GlobPattern character classes", "[GlobPattern]") {
+    SECTION("Ranges and single characters") {
+        REQUIRE(matches("file[0-9].ts", "file1.ts"));
+        REQUIRE(matches("file[abc].ts", "fileb.ts"));
+        REQUIRE(matches("file[a-cx].ts", "filex.ts"));
+        REQUIRE_FALSE(matches("file[0-9].ts", "filea.ts"));
+        REQUIRE_FALSE(matches("file[0-9].ts", "file.ts"));
+        REQUIRE_FALSE(matches("file[0-9].ts", "file12.ts"));
+    }
+
+    SECTION("Negation with ! or ^") {
+        REQUIRE(matches("[!a-c]*.ts", "d.ts"));
+        REQUIRE(matches("[^a-c]*.ts", "zebra.ts"));
+        REQUIRE_FALSE(matches("[!a-c]*.ts", "a.ts"));
+        REQUIRE_FALSE(matches("[^a-c]*.ts", "banana.ts"));
+    }
+
+    SECTION("A leading ] is literal") {
+        REQUIRE(matches("[]a].ts", "].ts"));
+        REQUIRE(matches("[]a].ts", "a.ts"));
+        REQUIRE_FALSE(matches("[]a].ts", "b.ts"));
+    }
+
+    SECTION("A trailing - is literal") {
+        REQUIRE(matches("[a-].ts", "-.ts"));
+        REQUIRE(matches("[a-].ts", "a.ts"));
+        REQUIRE_FALSE(matches("[a-].ts", "b.ts"));
+    }
+}
+
+TEST_CASE("GlobPattern braces", "[GlobPattern]") {
+    SECTION("Alternatives") {
+        REQUIRE(matches("*.{ts,tsx}", "a.ts"));
+        REQUIRE(matches("*.{ts,tsx}", "a.tsx"));
+        REQUIRE_FALSE(matches("*.{ts,tsx}", "a.js"));
+        REQUIRE(matches("src/{a,b}/*.ts", "src/b/x.ts"));
+        REQUIRE_FALSE(matches("src/{a,b}/*.ts", "src/c/x.ts"));
+    }
+
+    SECTION("Nested alternatives") {
+        REQUIRE(matches("{a,{b,c}}.ts", "a.ts"));
+        REQUIRE(matches("{a,{b,c}}.ts", "c.ts"));
+        REQUIRE_FALSE(matches("{a,{b,c}}.ts", "d.ts"));
+    }
+
+    SECTION("Unterminated braces are literal") {
+        REQUIRE(matches("{a.ts", "{a.ts"));
+        REQUIRE_FALSE(matches("{a.ts", "a.ts"));
+    }
+}
+
+TEST_CASE("GlobPattern directory matching", "[GlobPattern]") {
+    SECTION("Patterns that cover everything beneath a directory") {
+        REQUIRE(matchesDirectory("node_modules", "node_modules"));
+        REQUIRE(matchesDirectory("dist/**", "dist"));
+        REQUIRE(matchesDirectory("dist/**/*", "dist"));
+        REQUIRE(matchesDirectory("**/node_modules", "node_modules"));
+        REQUIRE(matchesDirectory("**/node_modules", "packages/a/node_modules"));
+        REQUIRE_FALSE(matchesDirectory("node_modules", "src"));
+    }
+
+    SECTION("Patterns that only cover some files beneath a directory") {
+        REQUIRE_FALSE(matchesDirectory("src/*.ts", "src"));
+        REQUIRE_FALSE(matchesDirectory("src/**/*.ts", "src"));
+        REQUIRE_FALSE(matchesDirectory("*", "src"));
+    }
+}
+
+TEST_CASE("walkDirectory include and exclude", "[GlobPattern]") {
+    std::filesystem::path root = std::filesystem::temp_directory_path() / "tspp_test_walk";
+    std::filesystem::remove_all(root);
+
+    const char* files[] = {
+        "index.ts",
+        "src/a.ts",
+        "src/b.js",
+        "src/gen/c.ts",
+        "src/nested/d.ts",
+        "node_modules/pkg/e.ts"
+    };
+
+    for (const char* file : files) {
+        std::filesystem::path path = root / file;
+        std::filesystem::create_directories(path.parent_path());
+        std::ofstream(path) << "";
+    }
+
+    std::string rootPath = root.string();
+
+    using List = std::initializer_list<const char*>;
+    auto walk  = [&](List extensions, List include, List exclude) {
+        Array<String> results = builtin::fs::walkDirectory(
+            String(rootPath.c_str()), strings(extensions), strings(include), strings(exclude), -1
+        );
+
+        std::vector<std::string> relative;
+        for (const String& result : results) {
+            relative.push_back(std::string(result.c_str()).substr(rootPath.size() + 1));
+        }
+
+        std::sort(relative.begin(), relative.end());
+        return relative;
+    };
+
+    SECTION("Everything is included by default") {
+        REQUIRE(walk({}, {}, {}).size() == 6);
+    }
+
+    SECTION("Extensions filter files") {
+        std::vector<std::string> expected = {
+            "index.ts", "node_modules/pkg/e.ts", "src/a.ts", "src/gen/c.ts", "src/nested/d.ts"
+        };
+        REQUIRE(walk({".ts"}, {}, {}) == expected);
+    }
+
+    SECTION("Exclude takes precedence over include") {
+        std::vector<std::string> expected = {"src/a.ts", "src/nested/d.ts"};
+        REQUIRE(walk({".ts"}, {"src/**/*"}, {"src/gen"}) == expected);
+        REQUIRE(walk({}, {"src/**/*.ts"}, {"**/gen/*.ts"}) == expected);
+    }
+
+    SECTION("A file excluded by name is excluded even when included by name") {
+        std::vector<std::string> expected = {"src/nested/d.ts"};
+        REQUIRE(walk({}, {"src/a.ts", "src/nested/d.ts"}, {"src/a.ts"}) == expected);
+    }
+
+    SECTION("Excluded directories are skipped") {
+        std::vector<std::string> expected = {
+            "index.ts", "src/a.ts", "src/b.js", "src/gen/c.ts", "src/nested/d.ts"
+        };
+        REQUIRE(walk({}, {}, {"node_modules"}) == expected);
+    }
+
+    std::filesystem::remove_all(root);
+}
@@ -0,0 +1,128 @@
+#include "Common.h"
+#include <tspp/utils/Histogram.h>
+
+using namespace tspp;
+
+TEST_CASE("Histogram buckets", "[Histogram]") {
+    SECTION("Small values get a bucket each") {
+        for (u64 value = 0; value < 8; value++) {
+            REQUIRE(Histogram::GetBucketIndex(value) == value);
+            REQUIRE(Histogram::GetBucketUpperBound(u32(value)) == value);
+        }
+    }
+
+    SECTION("Each power of two is split into four buckets") {
+        REQUIRE(Histogram::GetBucketIndex(8) == 8);
+        REQUIRE(Histogram::GetBucketIndex(9) == 8);
+        REQUIRE(Histogram::GetBucketIndex(10) == 9);
+        REQUIRE(Histogram::GetBucketIndex(15) == 11);
+        REQUIRE(Histogram::GetBucketIndex(16) == 12);
+        REQUIRE(Histogram::GetBucketUpperBound(8) == 9);
+        REQUIRE(Histogram::GetBucketUpperBound(11) == 15);
+        REQUIRE(Histogram::GetBucketUpperBound(12) == 19);
+    }
+
+    SECTION("Buckets are contiguous") {
+        for (u32 i = 0; i + 1 < Histogram::BucketCount; i++) {
+            u64 upperBound = Histogram::GetBucketUpperBound(i);
+            REQUIRE(Histogram::GetBucketIndex(upperBound) == i);
+            REQUIRE(Histogram::GetBucketIndex(upperBound + 1) == i + 1);
+        }
+    }
+
+    SECTION("Buckets are at most 25% wider than their lower bound") {
+        for (u32 i = Histogram::LinearBucketCount; i + 1 < Histogram::BucketCount; i++) {
+            u64 lowerBound = Histogram::GetBucketUpperBound(i - 1) + 1;
+            u64 upperBound = Histogram::GetBucketUpperBound(i);
+            REQUIRE(upperBound - lowerBound + 1 <= lowerBound / 4);
+        }
+    }
+
+    SECTION("The last bucket holds the largest values") {
+        REQUIRE(Histogram::GetBucketIndex(UINT64_MAX) == Histogram::BucketCount - 1);
+        REQUIRE(Histogram::GetBucketUpperBound(Histogram::BucketCount - 1) == UINT64_MAX);
+    }
+}
+
+TEST_CASE("Histogram statistics", "[Histogram]") {
+    Histogram histogram;
+
+    SECTION("Nothing recorded") {
+        REQUIRE(histogram.getCount() == 0);
+        REQUIRE(histogram.getSum() == 0);
+        REQUIRE(histogram.getMin() == 0);
+        REQUIRE(histogram.getMax() == 0);
+        REQUIRE(histogram.getMean() == 0.0);
+        REQUIRE(histogram.getPercentile(50.0) == 0);
+    }
+
+    SECTION("Summary of recorded values") {
+        for (u64 value = 1; value <= 100; value++) {
+            histogram.record(value);
+        }
+
+        REQUIRE(histogram.getCount() == 100);
+        REQUIRE(histogram.getSum() == 5050);
+        REQUIRE(histogram.getMin() == 1);
+        REQUIRE(histogram.getMax() == 100);
+        REQUIRE(histogram.getMean() == 50.5);
+        REQUIRE(histogram.getBucketCount(Histogram::GetBucketIndex(50)) == 8);
+    }
+
+    SECTION("Percentiles are the upper bound of their bucket") {
+        for (u64 value = 1; value <= 100; value++) {
+            histogram.record(value);
+        }
+
+        REQUIRE(histogram.getPercentile(0.0) == 1);
+        REQUIRE(histogram.getPercentile(50.0) == 55);
+        REQUIRE(histogram.getPercentile(90.0) == 95);
+        REQUIRE(histogram.getPercentile(99.0) == 100);
+
+        // Clamped to the largest recorded value rather than the bucket's upper bound of 111
+        REQUIRE(histogram.getPercentile(100.0) == 100);
+    }
+
+    SECTION("Percentiles of a single value") {
+        histogram.record(1000);
+
+        REQUIRE(histogram.getPercentile(0.0) == 1000);
+        REQUIRE(histogram.getPercentile(50.0) == 1000);
+        REQUIRE(histogram.getPercentile(100.0) == 1000);
+    }
+
+    SECTION("Percentiles of a skewed distribution") {
+        for (u32 i = 0; i < 99; i++) {
+            histogram.record(10);
+        }
+
+        histogram.record(1000000);
+
+        REQUIRE(histogram.getPercentile(50.0) == 11);
+        REQUIRE(histogram.getPercentile(99.0) == 11);
+        REQUIRE(histogram.getPercentile(100.0) == 1000000);
+        REQUIRE(histogram.getMax() == 1000000);
+    }
+
+    SECTION("Largest values") {
+        histogram.record(UINT64_MAX);
+
+        REQUIRE(histogram.getMax() == UINT64_MAX);
+        REQUIRE(histogram.getPercentile(50.0) == UINT64_MAX);
+    }
+
+    SECTION("Reset discards everything") {
+        histogram.record(5);
+        histogram.record(500);
+        histogram.reset();
+
+        REQUIRE(histogram.getCount() == 0);
+        REQUIRE(histogram.getMax() == 0);
+        REQUIRE(histogram.getBucketCount(Histogram::GetBucketIndex(500)) == 0);
+        REQUIRE(histogram.getPercentile(99.0) == 0);
+
+        histogram.record(7);
+        REQUIRE(histogram.getMin() == 7);
+        REQUIRE(histogram.getPercentile(50.0) == 7);
+    }
+}
@@ -0,0 +1,137 @@
+#include "Common.h"
+#include <tspp/systems/script.h>
+#include <tspp/utils/StructuredClone.h>
+
+using namespace tspp;
+
+static bool serialize(
+    ScriptSystem& system, SerializedValue& out, const char* value, const char* transferList = nullptr
+) {
+    v8::Isolate* isolate = system.getIsolate();
+    v8::Isolate::Scope isolateScope(isolate);
+    v8::HandleScope scope(isolate);
+    v8::Local<v8::Context> context = system.getContext();
+    v8::Context::Scope contextScope(context);
+
+    v8::Local<v8::Value> transfer;
+    if (transferList) {
+        transfer = system.executeString(transferList);
+    }
+
+    v8::TryCatch tryCatch(isolate);
+    return out.serialize(context, system.executeString(value), transfer);
+}
+
+static bool deserialize(ScriptSystem& system, SerializedValue& value, const char* name) {
+    v8::Isolate* isolate = system.getIsolate();
+    v8::Isolate::Scope isolateScope(isolate);
+    v8::HandleScope scope(isolate);
+    v8::Local<v8::Context> context = system.getContext();
+    v8::Context::Scope contextScope(context);
+
+    v8::Local<v8::Value> result;
+    if (!value.deserialize(context).ToLocal(&result)) {
+        return false;
+    }
+
+    return context->Global()->Set(context, v8::String::NewFromUtf8(isolate, name).ToLocalChecked(), result).FromJust();
+}
+
+static f64 evaluate(ScriptSystem& system, const char* expression) {
+    v8::Isolate* isolate = system.getIsolate();
+    v8::Isolate::Scope isolateScope(isolate);
+    v8::HandleScope scope(isolate);
+    v8::Local<v8::Context> context = system.getContext();
+    v8::Context::Scope contextScope(context);
+
+    v8::Local<v8::Value> result = system.executeString(expression);
+    if (result.IsEmpty()) {
+        return -1.0;
+    }
+
+    return result->NumberValue(context).FromMaybe(-1.0);
+}
+
+TEST_CASE("SerializedValue", "[StructuredClone]") {
+    // Values are cloned from one isolate into another, as they are between a worker and its parent
+    ScriptSystem sender;
+    ScriptSystem receiver;
+    REQUIRE(sender.initialize());
+    REQUIRE(receiver.initialize());
+
+    sender.executeString("var buffer = new ArrayBuffer(65536); new Uint8Array(buffer).fill(7);");
+
+    SerializedValue value;
+
+    SECTION("Plain values are copied") {
+        REQUIRE(serialize(sender, value, "({ a: 1, b: 'two', c: [3, 4], d: new Map([[5, 6]]) })"));
+        REQUIRE(deserialize(receiver, value, "received"));
+
+        REQUIRE(evaluate(receiver, "received.a") == 1.0);
+        REQUIRE(evaluate(receiver, "received.b === 'two' ? 1 : 0") == 1.0);
+        REQUIRE(evaluate(receiver, "received.c[1]") == 4.0);
+        REQUIRE(evaluate(receiver, "received.d.get(5)") == 6.0);
+    }
+
+    SECTION("ArrayBuffers that aren't transferred are copied") {
+        REQUIRE(serialize(sender, value, "({ buffer })"));
+        REQUIRE(value.getSize() >= 65536);
+        REQUIRE(deserialize(receiver, value, "received"));
+
+        REQUIRE(evaluate(sender, "buffer.byteLength") == 65536.0);
+        REQUIRE(evaluate(receiver, "received.buffer.byteLength") == 65536.0);
+        REQUIRE(evaluate(receiver, "new Uint8Array(received.buffer)[1234]") == 7.0);
+    }
+
+    SECTION("Transferred ArrayBuffers are moved and detached") {
+        REQUIRE(serialize(sender, value, "({ buffer, view: new Uint8Array(buffer, 16, 4) })", "[buffer]"));
+
+        // The contents are handed over with the backing store, not written into the serialized data
+        REQUIRE(value.getSize() < 65536);
+        REQUIRE(evaluate(sender, "buffer.byteLength") == 0.0);
+
+        REQUIRE(deserialize(receiver, value, "received"));
+        REQUIRE(evaluate(receiver, "received.buffer.byteLength") == 65536.0);
+        REQUIRE(evaluate(receiver, "new Uint8Array(received.buffer)[1234]") == 7.0);
+        REQUIRE(evaluate(receiver, "received.view.buffer === received.buffer ? 1 : 0") == 1.0);
+        REQUIRE(evaluate(receiver, "received.view.byteOffset") == 16.0);
+        REQUIRE(evaluate(receiver, "received.view.length") == 4.0);
+    }
+
+    SECTION("SharedArrayBuffers are shared") {
+        sender.executeString("var shared = new SharedArrayBuffer(16); var view = new Int32Array(shared);");
+
+        REQUIRE(serialize(sender, value, "({ a: shared, b: shared })"));
+        REQUIRE(deserialize(receiver, value, "received"));
+
+        receiver.executeString("new Int32Array(received.a)[2] = 42;");
+        REQUIRE(evaluate(sender, "view[2]") == 42.0);
+        REQUIRE(evaluate(receiver, "received.a === received.b ? 1 : 0") == 1.0);
+    }
+
+    SECTION("Invalid transfer lists are rejected") {
+        REQUIRE_FALSE(serialize(sender, value, "({ buffer })", "[buffer, buffer]"));
+        REQUIRE_FALSE(serialize(sender, value, "({ buffer })", "buffer"));
+        REQUIRE_FALSE(serialize(sender, value, "({ buffer })", "[{}]"));
+        REQUIRE_FALSE(serialize(sender, value, "({ shared: new SharedArrayBuffer(4) })", "[new SharedArrayBuffer(4)]"));
+
+        REQUIRE(evaluate(sender, "buffer.byteLength") == 65536.0);
+    }
+
+    SECTION("Nothing is detached when the value can't be cloned") {
+        REQUIRE_FALSE(serialize(sender, value, "({ buffer, fn: () => 1 })", "[buffer]"));
+        REQUIRE(evaluate(sender, "buffer.byteLength") == 65536.0);
+    }
+
+    SECTION("Moving a serialized value moves its contents") {
+        REQUIRE(serialize(sender, value, "({ buffer })", "[buffer]"));
+        size_t size = value.getSize();
+
+        SerializedValue moved = std::move(value);
+        REQUIRE(value.getSize() == 0);
+        REQUIRE(moved.getSize() == size);
+
+        REQUIRE(deserialize(receiver, moved, "received"));
+        REQUIRE(evaluate(receiver, "received.buffer.byteLength") == 65536.0);
+    }
+}